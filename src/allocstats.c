@@ -0,0 +1,165 @@
+#include "allocstats.h"
+
+#ifdef WARIOWARE_ALLOC_STATS
+
+static bool             installed;
+static SDL_threadID     counted_thread;
+static AllocStats       totals;
+static SDL_malloc_func  real_sdl_malloc;
+static SDL_calloc_func  real_sdl_calloc;
+static SDL_realloc_func real_sdl_realloc;
+static SDL_free_func    real_sdl_free;
+
+static bool counting(void)
+{
+    return installed && SDL_ThreadID() == counted_thread;
+}
+
+static void count_alloc(const void *old)
+{
+    if (!counting())
+        return;
+    if (old)
+        totals.reallocs++;
+    else
+        totals.mallocs++;
+}
+
+static void *SDLCALL count_sdl_malloc(size_t size)
+{
+    count_alloc(NULL);
+    return real_sdl_malloc(size);
+}
+
+static void *SDLCALL count_sdl_calloc(size_t count, size_t size)
+{
+    count_alloc(NULL);
+    return real_sdl_calloc(count, size);
+}
+
+static void *SDLCALL count_sdl_realloc(void *ptr, size_t size)
+{
+    count_alloc(ptr);
+    return real_sdl_realloc(ptr, size);
+}
+
+static void SDLCALL count_sdl_free(void *ptr)
+{
+    if (ptr && counting())
+        totals.frees++;
+    real_sdl_free(ptr);
+}
+
+#ifdef WARIOWARE_ALLOC_WRAP
+/* GNU ld --wrap: our objects' calls land here, __real_* is the original. */
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+SDL_Texture *__real_SDL_CreateTexture(SDL_Renderer *renderer, Uint32 format, int access, int w, int h);
+SDL_Texture *__real_SDL_CreateTextureFromSurface(SDL_Renderer *renderer, SDL_Surface *surface);
+
+void *__wrap_malloc(size_t size);
+void *__wrap_calloc(size_t count, size_t size);
+void *__wrap_realloc(void *ptr, size_t size);
+void __wrap_free(void *ptr);
+SDL_Texture *__wrap_SDL_CreateTexture(SDL_Renderer *renderer, Uint32 format, int access, int w, int h);
+SDL_Texture *__wrap_SDL_CreateTextureFromSurface(SDL_Renderer *renderer, SDL_Surface *surface);
+
+void *__wrap_malloc(size_t size)
+{
+    count_alloc(NULL);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+    count_alloc(NULL);
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    count_alloc(ptr);
+    return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void *ptr)
+{
+    if (ptr && counting())
+        totals.frees++;
+    __real_free(ptr);
+}
+
+SDL_Texture *__wrap_SDL_CreateTexture(SDL_Renderer *renderer, Uint32 format, int access, int w, int h)
+{
+    if (counting())
+        totals.textures++;
+    return __real_SDL_CreateTexture(renderer, format, access, w, h);
+}
+
+SDL_Texture *__wrap_SDL_CreateTextureFromSurface(SDL_Renderer *renderer, SDL_Surface *surface)
+{
+    if (counting())
+        totals.textures++;
+    return __real_SDL_CreateTextureFromSurface(renderer, surface);
+}
+#endif /* WARIOWARE_ALLOC_WRAP */
+
+int alloc_stats_install(void)
+{
+    if (installed)
+        return 0;
+    SDL_GetMemoryFunctions(&real_sdl_malloc, &real_sdl_calloc, &real_sdl_realloc, &real_sdl_free);
+    if (SDL_SetMemoryFunctions(count_sdl_malloc, count_sdl_calloc, count_sdl_realloc, count_sdl_free) != 0)
+        return -1;
+    counted_thread = SDL_ThreadID();
+    installed = true;
+    return 0;
+}
+
+bool alloc_stats_enabled(void)
+{
+    return installed;
+}
+
+void alloc_stats_get(AllocStats *out)
+{
+    if (out)
+        *out = totals;
+}
+
+#else
+
+int alloc_stats_install(void)
+{
+    return -1;
+}
+
+bool alloc_stats_enabled(void)
+{
+    return false;
+}
+
+void alloc_stats_get(AllocStats *out)
+{
+    if (out)
+        *out = (AllocStats){ 0 };
+}
+
+#endif /* WARIOWARE_ALLOC_STATS */
+
+bool alloc_stats_since(const AllocStats *mark, AllocStats *out)
+{
+    AllocStats now;
+    alloc_stats_get(&now);
+    AllocStats d = {
+        .mallocs  = now.mallocs - mark->mallocs,
+        .reallocs = now.reallocs - mark->reallocs,
+        .frees    = now.frees - mark->frees,
+        .textures = now.textures - mark->textures,
+    };
+    if (out)
+        *out = d;
+    return d.mallocs || d.reallocs || d.frees || d.textures;
+}
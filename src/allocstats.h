@@ -0,0 +1,34 @@
+#ifndef ALLOCSTATS_H
+#define ALLOCSTATS_H
+
+#include <SDL.h>
+#include <stdbool.h>
+
+/* Heap and texture counters for debug builds (make DEBUG=1), so frames that
+ * should allocate nothing can be checked. SDL's allocator is always hooked
+ * (that covers surfaces, fonts and most of the libraries); on Linux the
+ * linker also routes libc malloc/free and texture creation through here.
+ * Only the thread that installed the counters is counted: decode workers and
+ * the audio callback are expected to allocate. Release builds count nothing. */
+typedef struct AllocStats {
+    Uint64 mallocs;   /* malloc, calloc, and realloc of NULL */
+    Uint64 reallocs;  /* realloc of an existing block */
+    Uint64 frees;
+    Uint64 textures;  /* SDL_CreateTexture*, Linux only */
+} AllocStats;
+
+/* Starts counting on the calling thread. Call before SDL_Init and before
+ * anything else allocates through SDL. Returns 0, or -1 when counting is
+ * not built in. */
+int alloc_stats_install(void);
+
+bool alloc_stats_enabled(void);
+
+/* Running totals since install. */
+void alloc_stats_get(AllocStats *out);
+
+/* Counts since mark (taken with alloc_stats_get) into out; returns true if
+ * anything was allocated, reallocated or freed. */
+bool alloc_stats_since(const AllocStats *mark, AllocStats *out);
+
+#endif /* ALLOCSTATS_H */
@@ -0,0 +1,302 @@
+#include "anim.h"
+#include <stdlib.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ANIM_X86 1
+#include <emmintrin.h>
+#endif
+
+/* Caps whole loops skipped in one step, keeping the int conversion in range. */
+#define ANIM_MAX_WRAPS  1e6f
+
+struct AnimWorld {
+    /* Hot: read and written by every update, 4-entity padded. */
+    float  *time;      /* seconds into the clip, 0..dur */
+    float  *speed;     /* 0 for free slots */
+    float  *dur;       /* frame_count * frame_time */
+    float  *inv_dur;
+    float  *wrap_dur;  /* dur for loops, 0 otherwise: t -= wrap_dur * trunc(t / dur) */
+    float  *inv_ft;    /* 1 / frame_time */
+    float  *last_f;    /* frame_count - 1 */
+    float  *rev_f;     /* 1 for ANIM_REVERSE */
+    Sint32 *frame;
+    Sint32 *done;      /* all bits set once a one-shot clip has finished */
+    /* Cold: touched by spawn, play and draw. */
+    float          *x;
+    float          *y;
+    const AnimClip **clip;
+    int            *free_ids;
+    int             free_count;
+    int             size;  /* slots handed out, live or free */
+    int             cap;   /* multiple of 4 */
+    void (*update)(AnimWorld *world, int n, float delta_s);
+};
+
+static void clear_slot(AnimWorld *world, int i)
+{
+    world->time[i]     = 0.0f;
+    world->speed[i]    = 0.0f;
+    world->dur[i]      = 1.0f;
+    world->inv_dur[i]  = 1.0f;
+    world->wrap_dur[i] = 0.0f;
+    world->inv_ft[i]   = 1.0f;
+    world->last_f[i]   = 0.0f;
+    world->rev_f[i]    = 0.0f;
+    world->frame[i]    = 0;
+    world->done[i]     = 0;
+    world->x[i]        = 0.0f;
+    world->y[i]        = 0.0f;
+    world->clip[i]     = NULL;
+}
+
+#define GROW(field)                                                              \
+    do {                                                                         \
+        void *p = realloc(world->field, (size_t)cap * sizeof(*world->field));   \
+        if (!p)                                                                  \
+            return -1;                                                           \
+        world->field = p;                                                        \
+    } while (0)
+
+static int grow(AnimWorld *world, int want)
+{
+    if (want <= world->cap)
+        return 0;
+    int cap = world->cap ? world->cap : 64;
+    while (cap < want)
+        cap *= 2;
+    GROW(time);
+    GROW(speed);
+    GROW(dur);
+    GROW(inv_dur);
+    GROW(wrap_dur);
+    GROW(inv_ft);
+    GROW(last_f);
+    GROW(rev_f);
+    GROW(frame);
+    GROW(done);
+    GROW(x);
+    GROW(y);
+    GROW(clip);
+    GROW(free_ids);
+    for (int i = world->cap; i < cap; i++)
+        clear_slot(world, i);
+    world->cap = cap;
+    return 0;
+}
+
+#undef GROW
+
+/* The scalar and SSE2 passes do the same float operations in the same
+ * order, so they produce identical frames. */
+static void update_scalar(AnimWorld *world, int n, float delta_s)
+{
+    for (int i = 0; i < n; i++) {
+        float t = world->time[i] + delta_s * world->speed[i];
+        float q = t * world->inv_dur[i];
+        q = q < ANIM_MAX_WRAPS ? q : ANIM_MAX_WRAPS;
+        t = t - world->wrap_dur[i] * (float)(int)q;
+        t = t < world->dur[i] ? t : world->dur[i];
+        world->time[i] = t;
+
+        float last = world->last_f[i];
+        float f = (float)(int)(t * world->inv_ft[i]);
+        f = f < last ? f : last;
+        f = f + world->rev_f[i] * (last - 2.0f * f);
+        world->frame[i] = (Sint32)f;
+        world->done[i] = (t >= world->dur[i] && world->wrap_dur[i] == 0.0f) ? -1 : 0;
+    }
+}
+
+#ifdef ANIM_X86
+__attribute__((target("sse2")))
+static void update_sse2(AnimWorld *world, int n, float delta_s)
+{
+    const __m128 dt = _mm_set1_ps(delta_s);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 max_wraps = _mm_set1_ps(ANIM_MAX_WRAPS);
+    for (int i = 0; i < n; i += 4) {
+        __m128 t = _mm_add_ps(_mm_loadu_ps(world->time + i), _mm_mul_ps(dt, _mm_loadu_ps(world->speed + i)));
+        __m128 q = _mm_min_ps(_mm_mul_ps(t, _mm_loadu_ps(world->inv_dur + i)), max_wraps);
+        __m128 wrap = _mm_loadu_ps(world->wrap_dur + i);
+        t = _mm_sub_ps(t, _mm_mul_ps(wrap, _mm_cvtepi32_ps(_mm_cvttps_epi32(q))));
+        __m128 dur = _mm_loadu_ps(world->dur + i);
+        t = _mm_min_ps(t, dur);
+        _mm_storeu_ps(world->time + i, t);
+
+        __m128 last = _mm_loadu_ps(world->last_f + i);
+        __m128 f = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_mul_ps(t, _mm_loadu_ps(world->inv_ft + i))));
+        f = _mm_min_ps(f, last);
+        f = _mm_add_ps(f, _mm_mul_ps(_mm_loadu_ps(world->rev_f + i), _mm_sub_ps(last, _mm_mul_ps(two, f))));
+        _mm_storeu_si128((__m128i *)(world->frame + i), _mm_cvttps_epi32(f));
+        __m128 done = _mm_and_ps(_mm_cmpge_ps(t, dur), _mm_cmpeq_ps(wrap, zero));
+        _mm_storeu_si128((__m128i *)(world->done + i), _mm_castps_si128(done));
+    }
+}
+#endif
+
+AnimWorld *anim_world_create(int capacity)
+{
+    AnimWorld *world = calloc(1, sizeof(AnimWorld));
+    if (!world)
+        return NULL;
+    world->update = update_scalar;
+#ifdef ANIM_X86
+    if (SDL_HasSSE2())
+        world->update = update_sse2;
+#endif
+    if (grow(world, capacity > 0 ? capacity : 1) != 0) {
+        anim_world_destroy(world);
+        return NULL;
+    }
+    return world;
+}
+
+void anim_world_destroy(AnimWorld *world)
+{
+    if (!world)
+        return;
+    free(world->time);
+    free(world->speed);
+    free(world->dur);
+    free(world->inv_dur);
+    free(world->wrap_dur);
+    free(world->inv_ft);
+    free(world->last_f);
+    free(world->rev_f);
+    free(world->frame);
+    free(world->done);
+    free(world->x);
+    free(world->y);
+    free(world->clip);
+    free(world->free_ids);
+    free(world);
+}
+
+void anim_world_clear(AnimWorld *world)
+{
+    if (!world)
+        return;
+    for (int i = 0; i < world->size; i++)
+        clear_slot(world, i);
+    world->size = 0;
+    world->free_count = 0;
+}
+
+static bool valid(const AnimWorld *world, int id)
+{
+    return world && id >= 0 && id < world->size && world->clip[id];
+}
+
+int anim_spawn(AnimWorld *world, const AnimClip *clip, float x, float y)
+{
+    if (!world || !clip || clip->frame_count <= 0 || clip->frame_time <= 0.0f)
+        return -1;
+    int id;
+    if (world->free_count > 0) {
+        id = world->free_ids[--world->free_count];
+    } else {
+        /* Keep the padded tail of the last group of 4 inside the arrays. */
+        if (grow(world, (world->size + 4) & ~3) != 0)
+            return -1;
+        id = world->size++;
+    }
+    world->x[id] = x;
+    world->y[id] = y;
+    anim_play(world, id, clip);
+    return id;
+}
+
+void anim_despawn(AnimWorld *world, int id)
+{
+    if (!valid(world, id))
+        return;
+    clear_slot(world, id);
+    world->free_ids[world->free_count++] = id;
+}
+
+void anim_play(AnimWorld *world, int id, const AnimClip *clip)
+{
+    if (!world || id < 0 || id >= world->size || !clip || clip->frame_count <= 0 || clip->frame_time <= 0.0f)
+        return;
+    float dur = (float)clip->frame_count * clip->frame_time;
+    world->clip[id]     = clip;
+    world->time[id]     = 0.0f;
+    world->speed[id]    = 1.0f;
+    world->dur[id]      = dur;
+    world->inv_dur[id]  = 1.0f / dur;
+    world->wrap_dur[id] = clip->mode == ANIM_LOOP ? dur : 0.0f;
+    world->inv_ft[id]   = 1.0f / clip->frame_time;
+    world->last_f[id]   = (float)(clip->frame_count - 1);
+    world->rev_f[id]    = clip->mode == ANIM_REVERSE ? 1.0f : 0.0f;
+    world->frame[id]    = clip->mode == ANIM_REVERSE ? clip->frame_count - 1 : 0;
+    world->done[id]     = 0;
+}
+
+void anim_set_speed(AnimWorld *world, int id, float speed)
+{
+    if (valid(world, id))
+        world->speed[id] = speed > 0.0f ? speed : 0.0f;
+}
+
+void anim_set_position(AnimWorld *world, int id, float x, float y)
+{
+    if (valid(world, id)) {
+        world->x[id] = x;
+        world->y[id] = y;
+    }
+}
+
+void anim_world_update(AnimWorld *world, float delta_s)
+{
+    if (!world || world->size == 0)
+        return;
+    world->update(world, (world->size + 3) & ~3, delta_s);
+}
+
+int anim_world_size(const AnimWorld *world)
+{
+    return world ? world->size : 0;
+}
+
+bool anim_alive(const AnimWorld *world, int id)
+{
+    return valid(world, id);
+}
+
+int anim_frame(const AnimWorld *world, int id)
+{
+    return valid(world, id) ? world->frame[id] : 0;
+}
+
+const Sprite *anim_sprite(const AnimWorld *world, int id)
+{
+    return valid(world, id) ? &world->clip[id]->frames[world->frame[id]] : NULL;
+}
+
+void anim_position(const AnimWorld *world, int id, float *x, float *y)
+{
+    bool ok = valid(world, id);
+    if (x)
+        *x = ok ? world->x[id] : 0.0f;
+    if (y)
+        *y = ok ? world->y[id] : 0.0f;
+}
+
+bool anim_finished(const AnimWorld *world, int id)
+{
+    return valid(world, id) && world->done[id];
+}
+
+float anim_next_change(const AnimWorld *world, int id)
+{
+    if (!valid(world, id) || world->speed[id] <= 0.0f)
+        return -1.0f;
+    if (world->done[id])
+        return 0.0f;
+    float ft = 1.0f / world->inv_ft[id];
+    float t = world->time[id];
+    float left = ((float)(int)(t * world->inv_ft[id]) + 1.0f) * ft - t;
+    left /= world->speed[id];
+    return left > 0.0f ? left : 0.0f;
+}
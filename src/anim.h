@@ -0,0 +1,76 @@
+#ifndef ANIM_H
+#define ANIM_H
+
+#include "atlas.h"
+#include <SDL.h>
+#include <stdbool.h>
+
+/* How a clip plays its frames. */
+typedef enum {
+    ANIM_LOOP,     /* first → last, forever */
+    ANIM_ONCE,     /* first → last, then holds the last frame */
+    ANIM_REVERSE,  /* last → first, then holds the first frame */
+} AnimMode;
+
+/* A clip is data: frames shown frame_time seconds each. The frames array
+ * must outlive every entity playing the clip. */
+typedef struct AnimClip {
+    const Sprite *frames;
+    int           frame_count;
+    float         frame_time;
+    AnimMode      mode;
+} AnimClip;
+
+/* Animated entities kept as parallel arrays (time, speed, per-clip
+ * constants, frame, position), so anim_world_update is one pass over
+ * contiguous floats. Frames are computed in closed form from each entity's
+ * clock, so a long step costs the same as a short one and never loops.
+ * Ids are slot indexes; a despawned slot is reused by a later spawn. */
+typedef struct AnimWorld AnimWorld;
+
+/* capacity: slots to reserve (grows as needed). Returns NULL on failure. */
+AnimWorld *anim_world_create(int capacity);
+
+void anim_world_destroy(AnimWorld *world);
+
+/* Despawns everything; keeps the memory. */
+void anim_world_clear(AnimWorld *world);
+
+/* Starts clip at its first frame (last for ANIM_REVERSE) at x, y. Returns
+ * the entity id, or -1 if the world cannot grow. */
+int anim_spawn(AnimWorld *world, const AnimClip *clip, float x, float y);
+
+void anim_despawn(AnimWorld *world, int id);
+
+/* Restarts the entity on clip (which may be the one it is playing). */
+void anim_play(AnimWorld *world, int id, const AnimClip *clip);
+
+/* Playback rate: 1 is normal, 0 pauses. */
+void anim_set_speed(AnimWorld *world, int id, float speed);
+
+void anim_set_position(AnimWorld *world, int id, float x, float y);
+
+/* Advances every entity by delta_s seconds. */
+void anim_world_update(AnimWorld *world, float delta_s);
+
+/* Slots in use or freed, for iterating ids 0..size-1 with anim_alive. */
+int anim_world_size(const AnimWorld *world);
+
+bool anim_alive(const AnimWorld *world, int id);
+
+/* Current frame index into the clip's frames, and that sprite (NULL for a
+ * dead id). */
+int anim_frame(const AnimWorld *world, int id);
+const Sprite *anim_sprite(const AnimWorld *world, int id);
+
+void anim_position(const AnimWorld *world, int id, float *x, float *y);
+
+/* True once an ANIM_ONCE or ANIM_REVERSE clip has shown its final frame for
+ * its full frame_time; loops never finish. */
+bool anim_finished(const AnimWorld *world, int id);
+
+/* Seconds until the entity's frame next changes or its clip finishes;
+ * 0 once finished, -1 while paused or dead. */
+float anim_next_change(const AnimWorld *world, int id);
+
+#endif /* ANIM_H */
@@ -0,0 +1,156 @@
+#include "arena.h"
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_DEFAULT_BLOCK  (64 * 1024)
+#define ARENA_ALIGN          alignof(max_align_t)
+
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;  /* older block */
+    size_t             size;  /* usable bytes after the header */
+    size_t             used;
+} ArenaBlock;
+
+/* Header rounded up so block data starts aligned. */
+#define ARENA_HEADER  ((sizeof(ArenaBlock) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+
+struct Arena {
+    ArenaBlock *head;       /* newest block; allocations come from here */
+    size_t      block_size;
+    size_t      used;       /* across all blocks */
+    ArenaStats  stats;
+};
+
+static ArenaBlock *block_create(size_t size)
+{
+    ArenaBlock *block = malloc(ARENA_HEADER + size);
+    if (!block)
+        return NULL;
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
+
+Arena *arena_create(size_t block_size)
+{
+    Arena *arena = calloc(1, sizeof(Arena));
+    if (!arena)
+        return NULL;
+    arena->block_size = block_size ? block_size : ARENA_DEFAULT_BLOCK;
+    arena->head = block_create(arena->block_size);
+    if (!arena->head) {
+        free(arena);
+        return NULL;
+    }
+    arena->stats.capacity = arena->block_size;
+    arena->stats.blocks = 1;
+    return arena;
+}
+
+static void free_blocks(ArenaBlock *block)
+{
+    while (block) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+}
+
+void arena_destroy(Arena *arena)
+{
+    if (!arena)
+        return;
+    free_blocks(arena->head);
+    free(arena);
+}
+
+void *arena_alloc(Arena *arena, size_t size)
+{
+    if (!arena)
+        return NULL;
+    if (size == 0)
+        size = 1;
+    if (size > SIZE_MAX - ARENA_HEADER - ARENA_ALIGN)
+        return NULL;
+    size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+    ArenaBlock *block = arena->head;
+    if (block->size - block->used < size) {
+        size_t block_size = size > arena->block_size ? size : arena->block_size;
+        ArenaBlock *grown = block_create(block_size);
+        if (!grown)
+            return NULL;
+        grown->next = block;
+        arena->head = block = grown;
+        arena->stats.capacity += block_size;
+        arena->stats.blocks++;
+        arena->stats.grows++;
+    }
+    void *p = (char *)block + ARENA_HEADER + block->used;
+    block->used += size;
+    arena->used += size;
+    if (arena->used > arena->stats.high_water)
+        arena->stats.high_water = arena->used;
+    return p;
+}
+
+void *arena_calloc(Arena *arena, size_t count, size_t size)
+{
+    if (size && count > SIZE_MAX / size)
+        return NULL;
+    void *p = arena_alloc(arena, count * size);
+    if (p)
+        memset(p, 0, count * size);
+    return p;
+}
+
+char *arena_strdup(Arena *arena, const char *str)
+{
+    if (!str)
+        return NULL;
+    size_t len = strlen(str) + 1;
+    char *copy = arena_alloc(arena, len);
+    if (copy)
+        memcpy(copy, str, len);
+    return copy;
+}
+
+void arena_reset(Arena *arena)
+{
+    if (!arena)
+        return;
+    /* Spilled into several blocks: swap them for one that fits the round.
+     * If that fails, keep just the newest block. */
+    if (arena->head->next) {
+        ArenaBlock *merged = block_create(arena->stats.capacity);
+        if (merged) {
+            free_blocks(arena->head);
+            arena->head = merged;
+            arena->block_size = merged->size;
+            arena->stats.grows++;
+        } else {
+            free_blocks(arena->head->next);
+            arena->head->next = NULL;
+        }
+        arena->stats.capacity = arena->head->size;
+        arena->stats.blocks = 1;
+    }
+    arena->head->used = 0;
+    arena->used = 0;
+    arena->stats.resets++;
+}
+
+void arena_get_stats(const Arena *arena, ArenaStats *out)
+{
+    if (!out)
+        return;
+    if (!arena) {
+        *out = (ArenaStats){ 0 };
+        return;
+    }
+    *out = arena->stats;
+    out->used = arena->used;
+}
@@ -0,0 +1,44 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <SDL.h>
+#include <stddef.h>
+
+/* Linear allocator: allocations bump a pointer and are freed all at once by
+ * arena_reset. When a block fills up another is chained on; the next reset
+ * merges them into one block big enough for the whole round, so a workload
+ * that repeats stops calling malloc after its first round. Not thread-safe:
+ * one thread at a time. */
+typedef struct Arena Arena;
+
+typedef struct ArenaStats {
+    size_t used;        /* bytes handed out since the last reset */
+    size_t high_water;  /* most bytes in use at once, ever */
+    size_t capacity;    /* bytes held in blocks */
+    int    blocks;
+    Uint64 resets;
+    Uint64 grows;       /* blocks malloc'd after create */
+} ArenaStats;
+
+/* block_size: bytes in the first block (0 picks a default). Returns NULL
+ * on failure. */
+Arena *arena_create(size_t block_size);
+
+void arena_destroy(Arena *arena);
+
+/* Returns size bytes aligned for any type, uninitialised, valid until the
+ * next reset; NULL if out of memory. */
+void *arena_alloc(Arena *arena, size_t size);
+
+/* Zeroed array of count elements; NULL on overflow or out of memory. */
+void *arena_calloc(Arena *arena, size_t count, size_t size);
+
+/* Copy of a string in the arena; NULL if out of memory. */
+char *arena_strdup(Arena *arena, const char *str);
+
+/* Frees everything allocated since create or the last reset. */
+void arena_reset(Arena *arena);
+
+void arena_get_stats(const Arena *arena, ArenaStats *out);
+
+#endif /* ARENA_H */
@@ -0,0 +1,177 @@
+#include "atlas.h"
+#include "chroma.h"
+#include <SDL_image.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ATLAS_NAME_MAX  48
+
+typedef struct {
+    char     name[ATLAS_NAME_MAX];
+    SDL_Rect src;
+    int      offset_x;
+    int      offset_y;
+    int      frame_w;
+    int      frame_h;
+} AtlasEntry;
+
+struct SpriteAtlas {
+    SDL_Texture *texture;
+    AtlasEntry  *entries;
+    int          count;
+};
+
+/* Parses the index text ("name x y w h offset_x offset_y frame_w frame_h" per
+ * line, '#' comments, one "atlas W H" header). */
+static int parse_index(SpriteAtlas *atlas, const char *text, size_t len)
+{
+    char line[256];
+    int capacity = 0;
+    size_t pos = 0;
+    while (pos < len) {
+        size_t n = 0;
+        while (pos < len && text[pos] != '\n') {
+            if (n + 1 < sizeof line)
+                line[n++] = text[pos];
+            pos++;
+        }
+        pos++;
+        line[n] = '\0';
+        if (line[0] == '#' || line[0] == '\0' || line[0] == '\r')
+            continue;
+        int aw, ah;
+        if (sscanf(line, "atlas %d %d", &aw, &ah) == 2)
+            continue;
+
+        AtlasEntry e;
+        if (sscanf(line, "%47s %d %d %d %d %d %d %d %d", e.name, &e.src.x, &e.src.y, &e.src.w, &e.src.h,
+                   &e.offset_x, &e.offset_y, &e.frame_w, &e.frame_h) != 9) {
+            fprintf(stderr, "atlas index: bad line '%s'\n", line);
+            return -1;
+        }
+        if (atlas->count == capacity) {
+            int new_cap = capacity ? capacity * 2 : 32;
+            AtlasEntry *grown = realloc(atlas->entries, (size_t)new_cap * sizeof(AtlasEntry));
+            if (!grown)
+                return -1;
+            atlas->entries = grown;
+            capacity = new_cap;
+        }
+        atlas->entries[atlas->count++] = e;
+    }
+    return atlas->count > 0 ? 0 : -1;
+}
+
+SpriteAtlas *sprite_atlas_create(SDL_Texture *texture, const char *index, size_t index_len)
+{
+    if (!texture || !index)
+        return NULL;
+    SpriteAtlas *atlas = calloc(1, sizeof(SpriteAtlas));
+    if (!atlas)
+        return NULL;
+    if (parse_index(atlas, index, index_len) != 0) {
+        free(atlas->entries);
+        free(atlas);
+        return NULL;
+    }
+    atlas->texture = texture;
+    /* The atlas tool writes premultiplied pixels. */
+    chroma_set_premultiplied_blend(atlas->texture);
+    return atlas;
+}
+
+SpriteAtlas *sprite_atlas_load(SDL_Renderer *renderer, const char *png_path, const char *index_path)
+{
+    size_t index_len = 0;
+    char *index = SDL_LoadFile(index_path, &index_len);
+    if (!index)
+        return NULL;
+
+    /* Chroma keys were baked into alpha by the packer. */
+    SDL_Surface *surf = IMG_Load(png_path);
+    if (!surf) {
+        fprintf(stderr, "Failed to load '%s': %s\n", png_path, IMG_GetError());
+        SDL_free(index);
+        return NULL;
+    }
+    SDL_Texture *tex = SDL_CreateTextureFromSurface(renderer, surf);
+    SDL_FreeSurface(surf);
+    if (!tex) {
+        fprintf(stderr, "SDL_CreateTextureFromSurface: %s\n", SDL_GetError());
+        SDL_free(index);
+        return NULL;
+    }
+    SpriteAtlas *atlas = sprite_atlas_create(tex, index, index_len);
+    SDL_free(index);
+    if (!atlas)
+        SDL_DestroyTexture(tex);
+    return atlas;
+}
+
+void sprite_atlas_destroy(SpriteAtlas *atlas)
+{
+    if (!atlas)
+        return;
+    if (atlas->texture)
+        SDL_DestroyTexture(atlas->texture);
+    free(atlas->entries);
+    free(atlas);
+}
+
+SDL_Texture *sprite_atlas_texture(const SpriteAtlas *atlas)
+{
+    return atlas ? atlas->texture : NULL;
+}
+
+int sprite_atlas_find(const SpriteAtlas *atlas, const char *name, Sprite *out)
+{
+    if (!atlas || !name || !out)
+        return -1;
+    for (int i = 0; i < atlas->count; i++) {
+        const AtlasEntry *e = &atlas->entries[i];
+        if (strcmp(e->name, name) == 0) {
+            *out = (Sprite){
+                .texture  = atlas->texture,
+                .src      = e->src,
+                .offset_x = e->offset_x,
+                .offset_y = e->offset_y,
+                .frame_w  = e->frame_w,
+                .frame_h  = e->frame_h,
+            };
+            return 0;
+        }
+    }
+    return -1;
+}
+
+Sprite sprite_from_sheet(SDL_Texture *texture, SDL_Rect src)
+{
+    return (Sprite){
+        .texture = texture,
+        .src     = src,
+        .frame_w = src.w,
+        .frame_h = src.h,
+    };
+}
+
+int sprite_dest_rect(const Sprite *sprite, const SDL_Rect *dst, SDL_Rect *out)
+{
+    if (!sprite || !sprite->texture || !dst || sprite->frame_w <= 0 || sprite->frame_h <= 0)
+        return -1;
+    /* Scale the trimmed region's placement by the same factor as the frame. */
+    *out = (SDL_Rect){
+        .x = dst->x + sprite->offset_x * dst->w / sprite->frame_w,
+        .y = dst->y + sprite->offset_y * dst->h / sprite->frame_h,
+        .w = sprite->src.w * dst->w / sprite->frame_w,
+        .h = sprite->src.h * dst->h / sprite->frame_h,
+    };
+    return 0;
+}
+
+void sprite_draw(SDL_Renderer *renderer, const Sprite *sprite, const SDL_Rect *dst)
+{
+    SDL_Rect d;
+    if (sprite_dest_rect(sprite, dst, &d) == 0)
+        SDL_RenderCopy(renderer, sprite->texture, &sprite->src, &d);
+}
@@ -0,0 +1,46 @@
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include <SDL.h>
+
+/* A drawable sprite: a (possibly trimmed) region of a texture plus where
+ * that region sits inside the original frame_w×frame_h frame. */
+typedef struct Sprite {
+    SDL_Texture *texture;
+    SDL_Rect     src;
+    int          offset_x;
+    int          offset_y;
+    int          frame_w;
+    int          frame_h;
+} Sprite;
+
+typedef struct SpriteAtlas SpriteAtlas;
+
+/* Wraps an already-uploaded atlas texture and its index text. Takes
+ * ownership of texture on success. Returns NULL if the index is invalid. */
+SpriteAtlas *sprite_atlas_create(SDL_Texture *texture, const char *index, size_t index_len);
+
+/* Loads a packed atlas (PNG + index written by tools/pack_atlas).
+ * Returns NULL if either file is missing or invalid. */
+SpriteAtlas *sprite_atlas_load(SDL_Renderer *renderer, const char *png_path, const char *index_path);
+
+/* Frees the atlas texture and index. */
+void sprite_atlas_destroy(SpriteAtlas *atlas);
+
+/* The texture every sprite found in the atlas points at. */
+SDL_Texture *sprite_atlas_texture(const SpriteAtlas *atlas);
+
+/* Looks up a sprite by name. Returns 0 on success, -1 if not present. */
+int sprite_atlas_find(const SpriteAtlas *atlas, const char *name, Sprite *out);
+
+/* Sprite covering src of a standalone sheet (no trimming). */
+Sprite sprite_from_sheet(SDL_Texture *texture, SDL_Rect src);
+
+/* Where the trimmed region lands when the untrimmed frame fills dst.
+ * Returns -1 for an empty sprite. */
+int sprite_dest_rect(const Sprite *sprite, const SDL_Rect *dst, SDL_Rect *out);
+
+/* Draws the sprite so its untrimmed frame fills dst. */
+void sprite_draw(SDL_Renderer *renderer, const Sprite *sprite, const SDL_Rect *dst);
+
+#endif /* ATLAS_H */
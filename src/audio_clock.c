@@ -0,0 +1,98 @@
+#include "audio_clock.h"
+#include <SDL_mixer.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+struct AudioClock {
+    int    rate;
+    int    bytes_per_frame;
+    /* Written only by the audio thread under a sequence counter: odd while
+     * an update is in progress, so readers retry instead of locking. */
+    SDL_atomic_t seq;
+    Uint64 frames;      /* total frames handed to the device */
+    Uint64 stamp;       /* performance counter at the last callback */
+    Uint32 buf_frames;  /* frames in the last callback */
+    /* Main thread only. */
+    double last;
+};
+
+static void post_mix(void *udata, Uint8 *stream, int len)
+{
+    (void)stream;
+    AudioClock *clock = udata;
+    SDL_AtomicAdd(&clock->seq, 1);
+    SDL_MemoryBarrierRelease();
+    clock->buf_frames = (Uint32)(len / clock->bytes_per_frame);
+    clock->frames += clock->buf_frames;
+    clock->stamp = SDL_GetPerformanceCounter();
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicAdd(&clock->seq, 1);
+}
+
+AudioClock *audio_clock_create(void)
+{
+    int freq = 0, chans = 0;
+    Uint16 fmt = 0;
+    if (Mix_QuerySpec(&freq, &fmt, &chans) == 0 || freq <= 0) {
+        fprintf(stderr, "audio clock: audio not open\n");
+        return NULL;
+    }
+    AudioClock *clock = calloc(1, sizeof(AudioClock));
+    if (!clock)
+        return NULL;
+    clock->rate = freq;
+    clock->bytes_per_frame = chans * (SDL_AUDIO_BITSIZE(fmt) / 8);
+    if (clock->bytes_per_frame <= 0)
+        clock->bytes_per_frame = 1;
+    Mix_SetPostMix(post_mix, clock);
+    return clock;
+}
+
+void audio_clock_destroy(AudioClock *clock)
+{
+    if (!clock)
+        return;
+    /* Mix_SetPostMix takes the audio lock, so no callback is running after this. */
+    Mix_SetPostMix(NULL, NULL);
+    free(clock);
+}
+
+double audio_clock_now(AudioClock *clock)
+{
+    if (!clock)
+        return 0.0;
+    Uint64 frames, stamp;
+    Uint32 buf;
+    for (;;) {
+        int s1 = SDL_AtomicGet(&clock->seq);
+        if (s1 & 1)
+            continue;
+        SDL_MemoryBarrierAcquire();
+        frames = clock->frames;
+        stamp  = clock->stamp;
+        buf    = clock->buf_frames;
+        SDL_MemoryBarrierAcquire();
+        if (SDL_AtomicGet(&clock->seq) == s1)
+            break;
+    }
+    if (frames == 0)
+        return clock->last;
+
+    /* The buffer just mixed is queued behind the one playing, so what is
+     * audible lags the mix position by one buffer. Interpolate across that
+     * buffer, but never past the data the mixer actually produced. */
+    double buf_s = (double)buf / (double)clock->rate;
+    double since = (double)(SDL_GetPerformanceCounter() - stamp) / (double)SDL_GetPerformanceFrequency();
+    if (since > buf_s)
+        since = buf_s;
+    double now = (double)(frames - buf) / (double)clock->rate + since;
+    if (now < clock->last)
+        now = clock->last;
+    clock->last = now;
+    return now;
+}
+
+int audio_clock_rate(const AudioClock *clock)
+{
+    return clock ? clock->rate : 0;
+}
@@ -0,0 +1,34 @@
+#ifndef AUDIO_CLOCK_H
+#define AUDIO_CLOCK_H
+
+#include <SDL.h>
+
+/* Playback position taken from the mixer's post-mix callback: sample frames
+ * the device has consumed, interpolated between callbacks with the
+ * performance counter. It advances at exactly the rate music plays. */
+typedef struct AudioClock AudioClock;
+
+/* How far a frame-delta clock wandered from the audio clock, and how often
+ * it had to be snapped back instead of slewed. */
+typedef struct AudioDriftStats {
+    int    samples;
+    double mean_abs_ms;
+    double max_abs_ms;
+    int    snaps;
+} AudioDriftStats;
+
+/* Installs the Mix_SetPostMix hook (there is only one; the clock owns it).
+ * Call after Mix_OpenAudio. Returns NULL if audio is not open. */
+AudioClock *audio_clock_create(void);
+
+/* Removes the hook. */
+void audio_clock_destroy(AudioClock *clock);
+
+/* Seconds of audio played so far; never goes backwards between calls.
+ * Main thread only. */
+double audio_clock_now(AudioClock *clock);
+
+/* Device sample rate in Hz. */
+int audio_clock_rate(const AudioClock *clock);
+
+#endif /* AUDIO_CLOCK_H */
@@ -0,0 +1,203 @@
+#include "batch.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct {
+    SDL_Texture     *texture;
+    int              layer;
+    int              seq;     /* insertion order, keeps the sort stable */
+    SDL_Rect         src;     /* w = 0: whole texture */
+    SDL_Rect         dst;
+    SDL_RendererFlip flip;
+    SDL_Color        tint;
+} BatchQuad;
+
+struct SpriteBatch {
+    SDL_Renderer     *renderer;
+    BatchQuad        *quads;
+    int               count;
+    int               cap;
+    /* Scratch geometry reused by every flush so steady-state drawing never
+     * allocates; sized for the largest run seen so far. */
+    SDL_Vertex       *verts;
+    int              *indices;
+    int               geom_cap;  /* quads */
+    SpriteBatchStats  stats;
+};
+
+SpriteBatch *sprite_batch_create(SDL_Renderer *renderer)
+{
+    if (!renderer)
+        return NULL;
+    SpriteBatch *batch = calloc(1, sizeof(SpriteBatch));
+    if (!batch)
+        return NULL;
+    batch->renderer = renderer;
+    return batch;
+}
+
+void sprite_batch_destroy(SpriteBatch *batch)
+{
+    if (!batch)
+        return;
+    free(batch->indices);
+    free(batch->verts);
+    free(batch->quads);
+    free(batch);
+}
+
+int sprite_batch_add(SpriteBatch *batch, SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect *dst,
+                     SDL_RendererFlip flip, SDL_Color tint, int layer)
+{
+    if (!batch || !texture || !dst || dst->w <= 0 || dst->h <= 0 || tint.a == 0)
+        return 0;
+    if (src && (src->w <= 0 || src->h <= 0))
+        return 0;
+    if (batch->count == batch->cap) {
+        int cap = batch->cap ? batch->cap * 2 : 64;
+        BatchQuad *grown = realloc(batch->quads, (size_t)cap * sizeof(BatchQuad));
+        if (!grown)
+            return -1;
+        batch->quads = grown;
+        batch->cap = cap;
+    }
+    batch->quads[batch->count] = (BatchQuad){
+        .texture = texture,
+        .layer   = layer,
+        .seq     = batch->count,
+        .src     = src ? *src : (SDL_Rect){ 0, 0, 0, 0 },
+        .dst     = *dst,
+        .flip    = flip,
+        .tint    = tint,
+    };
+    batch->count++;
+    return 0;
+}
+
+int sprite_batch_add_sprite(SpriteBatch *batch, const Sprite *sprite, const SDL_Rect *dst,
+                            SDL_RendererFlip flip, SDL_Color tint, int layer)
+{
+    if (!sprite)
+        return 0;
+    /* Mirror the trim offsets so a flipped sprite still fills its frame. */
+    Sprite s = *sprite;
+    if (flip & SDL_FLIP_HORIZONTAL)
+        s.offset_x = s.frame_w - s.offset_x - s.src.w;
+    if (flip & SDL_FLIP_VERTICAL)
+        s.offset_y = s.frame_h - s.offset_y - s.src.h;
+    SDL_Rect d;
+    if (sprite_dest_rect(&s, dst, &d) != 0)
+        return 0;
+    return sprite_batch_add(batch, s.texture, &s.src, &d, flip, tint, layer);
+}
+
+int sprite_batch_pending(const SpriteBatch *batch)
+{
+    return batch ? batch->count : 0;
+}
+
+static int compare_quads(const void *a, const void *b)
+{
+    const BatchQuad *qa = a, *qb = b;
+    if (qa->layer != qb->layer)
+        return qa->layer < qb->layer ? -1 : 1;
+    if (qa->texture != qb->texture)
+        return (uintptr_t)qa->texture < (uintptr_t)qb->texture ? -1 : 1;
+    return qa->seq - qb->seq;
+}
+
+static int ensure_geometry(SpriteBatch *batch, int quads)
+{
+    if (quads <= batch->geom_cap)
+        return 0;
+    int cap = batch->geom_cap ? batch->geom_cap : 64;
+    while (cap < quads)
+        cap *= 2;
+    SDL_Vertex *verts = realloc(batch->verts, (size_t)cap * 4 * sizeof(SDL_Vertex));
+    if (!verts)
+        return -1;
+    batch->verts = verts;
+    int *indices = realloc(batch->indices, (size_t)cap * 6 * sizeof(int));
+    if (!indices)
+        return -1;
+    batch->indices = indices;
+    /* The index pattern never changes; only the new tail needs filling. */
+    for (int q = batch->geom_cap; q < cap; q++) {
+        int *ix = &indices[q * 6], base = q * 4;
+        ix[0] = base; ix[1] = base + 1; ix[2] = base + 2;
+        ix[3] = base + 2; ix[4] = base + 1; ix[5] = base + 3;
+    }
+    batch->geom_cap = cap;
+    return 0;
+}
+
+static void emit_quad(SDL_Vertex *v, const BatchQuad *q, float inv_w, float inv_h, int tex_w, int tex_h)
+{
+    SDL_Rect src = q->src.w > 0 ? q->src : (SDL_Rect){ 0, 0, tex_w, tex_h };
+    float x0 = (float)q->dst.x, y0 = (float)q->dst.y;
+    float x1 = x0 + (float)q->dst.w, y1 = y0 + (float)q->dst.h;
+    float u0 = (float)src.x * inv_w, v0 = (float)src.y * inv_h;
+    float u1 = (float)(src.x + src.w) * inv_w, v1 = (float)(src.y + src.h) * inv_h;
+    if (q->flip & SDL_FLIP_HORIZONTAL) {
+        float t = u0; u0 = u1; u1 = t;
+    }
+    if (q->flip & SDL_FLIP_VERTICAL) {
+        float t = v0; v0 = v1; v1 = t;
+    }
+    /* Premultiplied textures: fading by the tint's alpha scales colour too. */
+    SDL_Color c = q->tint;
+    if (c.a < 255) {
+        c.r = (Uint8)((c.r * c.a + 127) / 255);
+        c.g = (Uint8)((c.g * c.a + 127) / 255);
+        c.b = (Uint8)((c.b * c.a + 127) / 255);
+    }
+    v[0] = (SDL_Vertex){ { x0, y0 }, c, { u0, v0 } };
+    v[1] = (SDL_Vertex){ { x1, y0 }, c, { u1, v0 } };
+    v[2] = (SDL_Vertex){ { x0, y1 }, c, { u0, v1 } };
+    v[3] = (SDL_Vertex){ { x1, y1 }, c, { u1, v1 } };
+}
+
+void sprite_batch_flush(SpriteBatch *batch)
+{
+    if (!batch || batch->count == 0)
+        return;
+    qsort(batch->quads, (size_t)batch->count, sizeof(BatchQuad), compare_quads);
+
+    for (int start = 0; start < batch->count;) {
+        const BatchQuad *first = &batch->quads[start];
+        int end = start + 1;
+        while (end < batch->count && batch->quads[end].layer == first->layer &&
+               batch->quads[end].texture == first->texture)
+            end++;
+        int n = end - start;
+
+        int tex_w = 0, tex_h = 0;
+        if (SDL_QueryTexture(first->texture, NULL, NULL, &tex_w, &tex_h) != 0 || tex_w <= 0 || tex_h <= 0 ||
+            ensure_geometry(batch, n) != 0) {
+            fprintf(stderr, "sprite batch: dropping %d quads: %s\n", n, SDL_GetError());
+            start = end;
+            continue;
+        }
+        float inv_w = 1.0f / (float)tex_w, inv_h = 1.0f / (float)tex_h;
+        for (int i = 0; i < n; i++)
+            emit_quad(&batch->verts[i * 4], &batch->quads[start + i], inv_w, inv_h, tex_w, tex_h);
+        SDL_RenderGeometry(batch->renderer, first->texture, batch->verts, n * 4, batch->indices, n * 6);
+        batch->stats.draw_calls++;
+        batch->stats.quads += (Uint64)n;
+        start = end;
+    }
+    batch->stats.flushes++;
+    batch->count = 0;
+}
+
+void sprite_batch_get_stats(const SpriteBatch *batch, SpriteBatchStats *out)
+{
+    if (!out)
+        return;
+    if (!batch) {
+        *out = (SpriteBatchStats){ 0 };
+        return;
+    }
+    *out = batch->stats;
+}
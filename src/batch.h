@@ -0,0 +1,46 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "atlas.h"
+#include <SDL.h>
+
+/* Collects textured quads during the draw phase and submits them with one
+ * SDL_RenderGeometry call per run of equal (layer, texture). Quads are
+ * sorted by layer first, then by texture; within a texture they keep the
+ * order they were added in. Sprites that must overlap in a set order across
+ * textures therefore need different layers.
+ * Textures are assumed premultiplied (as loader, pack and atlas textures
+ * are), so a tint's alpha scales its colour too. */
+typedef struct SpriteBatch SpriteBatch;
+
+typedef struct SpriteBatchStats {
+    Uint64 quads;       /* quads submitted */
+    Uint64 draw_calls;  /* SDL_RenderGeometry calls */
+    Uint64 flushes;     /* non-empty flushes */
+} SpriteBatchStats;
+
+/* Returns NULL on failure. */
+SpriteBatch *sprite_batch_create(SDL_Renderer *renderer);
+
+void sprite_batch_destroy(SpriteBatch *batch);
+
+/* Queues src of texture (NULL = all of it) stretched over dst. Returns 0,
+ * or -1 if the queue cannot grow (the quad is dropped). */
+int sprite_batch_add(SpriteBatch *batch, SDL_Texture *texture, const SDL_Rect *src, const SDL_Rect *dst,
+                     SDL_RendererFlip flip, SDL_Color tint, int layer);
+
+/* Queues a sprite so its untrimmed frame fills dst, as sprite_draw does;
+ * trimmed margins are mirrored along with a flip. */
+int sprite_batch_add_sprite(SpriteBatch *batch, const Sprite *sprite, const SDL_Rect *dst,
+                            SDL_RendererFlip flip, SDL_Color tint, int layer);
+
+/* Number of quads waiting for the next flush. */
+int sprite_batch_pending(const SpriteBatch *batch);
+
+/* Sorts and draws everything queued, then empties the queue. Call before
+ * drawing anything else that must land on top, and before presenting. */
+void sprite_batch_flush(SpriteBatch *batch);
+
+void sprite_batch_get_stats(const SpriteBatch *batch, SpriteBatchStats *out);
+
+#endif /* BATCH_H */
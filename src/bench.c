@@ -0,0 +1,560 @@
+/*
+ * Headless benchmark: drives the elevator scene at a fixed timestep with
+ * scripted input and draws into an offscreen software renderer, as fast as
+ * the CPU allows. No window, display or sound card is needed.
+ * With --checksum every drawn frame is hashed, so a run doubles as a
+ * rendering regression test: same options, same checksum.
+ * With --stress N every frame also draws N extra sprites, batched or (with
+ * --no-batch) one SDL_RenderCopyEx each, to show how draw calls and frame
+ * time scale with sprite count.
+ * With --entities N, N animated entities (mixed clips, modes and speeds)
+ * are advanced every tick, timed on their own.
+ * In a DEBUG=1 build, allocations are counted per tick; --assert-no-alloc
+ * fails the run if any steady tick (see elevator_scene_is_steady) allocated.
+ * With --replay PATH the input comes from a session recorded with
+ * `warioware --record PATH` instead of the SPACE script, and the run lasts as
+ * long as the session; --realtime paces it at the recorded tick rate.
+ * --expect-checksum HEX fails the run if the frame checksum comes out
+ * different (make bench-replay checks each recording this way).
+ * Build and run: make bench   (extra flags via BENCH_ARGS="...")
+ */
+#include "allocstats.h"
+#include "anim.h"
+#include "batch.h"
+#include "chroma.h"
+#include "elevator.h"
+#include "replay.h"
+#include "softrender.h"
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_mixer.h>
+#include <SDL_ttf.h>
+#include <stdio.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_WIDTH   240
+#define BENCH_HEIGHT  160
+
+#define BENCH_LOAD_TIMEOUT_MS  10000
+
+/* Stress sprites: two textures of STRESS_TILES tiles each, two layers. */
+#define STRESS_TILE    16
+#define STRESS_TILES   4
+#define STRESS_LAYERS  2
+
+typedef struct {
+    long  ticks;        /* simulation steps to run */
+    float dt;           /* fixed step in seconds */
+    long  space_every;  /* press SPACE every N ticks (0 = never) */
+    long  draw_every;   /* draw a frame every N ticks (0 = never) */
+    int   json;         /* 1 = one JSON object, 0 = key=value lines */
+    int   soft;         /* draw with the CPU rasterizer instead of SDL's software renderer */
+    const char *kernels;  /* force a rasterizer kernel set (avx2, sse2, scalar) */
+    int   checksum;     /* hash every drawn frame (outside the timed section) */
+    const char *expect_checksum;  /* fail unless the frame checksum is this (lowercase hex) */
+    long  stress;       /* extra sprites drawn per frame */
+    int   no_batch;     /* draw stress sprites one copy each */
+    long  entities;     /* animated entities advanced per tick */
+    int   assert_no_alloc;  /* fail if a steady tick allocated (DEBUG=1 builds) */
+    const char *replay;   /* recorded session to play instead of scripted input */
+    int   realtime;       /* wait out each tick instead of running flat out */
+} BenchOptions;
+
+typedef struct {
+    SDL_Texture *textures[2];
+    SpriteBatch *batch;
+    Uint64       draw_calls;
+} StressSprites;
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [--ticks N] [--dt SECONDS] [--space-every N] [--draw-every N] [--format json|kv]\n"
+            "       [--soft] [--kernels avx2|sse2|scalar] [--checksum] [--stress N] [--no-batch]\n"
+            "       [--entities N] [--assert-no-alloc] [--replay PATH [--realtime]] [--expect-checksum HEX]\n",
+            prog);
+}
+
+static int parse_args(int argc, char **argv, BenchOptions *opt)
+{
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--soft") == 0) {
+            opt->soft = 1;
+            continue;
+        }
+        if (strcmp(arg, "--checksum") == 0) {
+            opt->checksum = 1;
+            continue;
+        }
+        if (strcmp(arg, "--no-batch") == 0) {
+            opt->no_batch = 1;
+            continue;
+        }
+        if (strcmp(arg, "--assert-no-alloc") == 0) {
+            opt->assert_no_alloc = 1;
+            continue;
+        }
+        if (strcmp(arg, "--realtime") == 0) {
+            opt->realtime = 1;
+            continue;
+        }
+        if (!val) {
+            usage(argv[0]);
+            return -1;
+        }
+        if (strcmp(arg, "--ticks") == 0)
+            opt->ticks = strtol(val, NULL, 10);
+        else if (strcmp(arg, "--dt") == 0)
+            opt->dt = strtof(val, NULL);
+        else if (strcmp(arg, "--space-every") == 0)
+            opt->space_every = strtol(val, NULL, 10);
+        else if (strcmp(arg, "--draw-every") == 0)
+            opt->draw_every = strtol(val, NULL, 10);
+        else if (strcmp(arg, "--format") == 0)
+            opt->json = strcmp(val, "json") == 0;
+        else if (strcmp(arg, "--kernels") == 0)
+            opt->kernels = val;
+        else if (strcmp(arg, "--stress") == 0)
+            opt->stress = strtol(val, NULL, 10);
+        else if (strcmp(arg, "--entities") == 0)
+            opt->entities = strtol(val, NULL, 10);
+        else if (strcmp(arg, "--replay") == 0)
+            opt->replay = val;
+        else if (strcmp(arg, "--expect-checksum") == 0) {
+            opt->expect_checksum = val;
+            opt->checksum = 1;
+        }
+        else {
+            usage(argv[0]);
+            return -1;
+        }
+        i++;
+    }
+    if (opt->ticks <= 0 || opt->dt <= 0.0f || opt->stress < 0 || opt->entities < 0 || opt->entities > INT_MAX) {
+        usage(argv[0]);
+        return -1;
+    }
+    if (opt->stress > 0 && opt->soft) {
+        fprintf(stderr, "--stress measures SDL draw submission; it cannot be combined with --soft\n");
+        return -1;
+    }
+    return 0;
+}
+
+static int init_sdl(void)
+{
+    /* Default to the dummy drivers; an explicit environment setting still wins. */
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+
+    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) != 0) {
+        fprintf(stderr, "SDL_Init: %s\n", SDL_GetError());
+        return -1;
+    }
+    if ((IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) != IMG_INIT_PNG) {
+        fprintf(stderr, "IMG_Init: %s\n", IMG_GetError());
+        SDL_Quit();
+        return -1;
+    }
+    if (TTF_Init() != 0) {
+        fprintf(stderr, "TTF_Init: %s\n", TTF_GetError());
+        IMG_Quit();
+        SDL_Quit();
+        return -1;
+    }
+    /* Audio is optional here: a missing MP3 decoder should not stop a benchmark. */
+    Mix_Init(MIX_INIT_MP3);
+    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 1024) != 0)
+        fprintf(stderr, "Mix_OpenAudio: %s (continuing without audio)\n", Mix_GetError());
+    return 0;
+}
+
+static void quit_sdl(void)
+{
+    Mix_CloseAudio();
+    Mix_Quit();
+    TTF_Quit();
+    IMG_Quit();
+    SDL_Quit();
+}
+
+/* A strip of STRESS_TILES solid tiles with a transparent corner, so both the
+ * colour and the blend path get exercised. Premultiplied like game sprites. */
+static SDL_Texture *create_stress_texture(SDL_Renderer *renderer, Uint8 seed)
+{
+    enum { W = STRESS_TILE * STRESS_TILES, H = STRESS_TILE };
+    static Uint8 pixels[W * H * 4];
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            Uint8 *p = &pixels[(y * W + x) * 4];
+            int tile = x / STRESS_TILE, lx = x % STRESS_TILE;
+            int clear = lx + y < STRESS_TILE / 4;
+            p[0] = clear ? 0 : (Uint8)(seed + tile * 60);
+            p[1] = clear ? 0 : (Uint8)(lx * 16);
+            p[2] = clear ? 0 : (Uint8)(y * 16);
+            p[3] = clear ? 0 : 255;
+        }
+    }
+    SDL_Texture *tex = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, W, H);
+    if (!tex || SDL_UpdateTexture(tex, NULL, pixels, W * 4) != 0) {
+        fprintf(stderr, "stress texture: %s\n", SDL_GetError());
+        if (tex)
+            SDL_DestroyTexture(tex);
+        return NULL;
+    }
+    chroma_set_premultiplied_blend(tex);
+    return tex;
+}
+
+static int stress_create(StressSprites *stress, SDL_Renderer *renderer)
+{
+    stress->textures[0] = create_stress_texture(renderer, 40);
+    stress->textures[1] = create_stress_texture(renderer, 160);
+    stress->batch = sprite_batch_create(renderer);
+    return stress->textures[0] && stress->textures[1] && stress->batch ? 0 : -1;
+}
+
+static void stress_destroy(StressSprites *stress)
+{
+    for (int i = 0; i < 2; i++) {
+        if (stress->textures[i])
+            SDL_DestroyTexture(stress->textures[i]);
+    }
+    sprite_batch_destroy(stress->batch);
+}
+
+/* Deterministic sprites drifting across the screen: mixed textures, tiles,
+ * flips, tints and layers, so sorting has real work to do. */
+static void stress_draw(StressSprites *stress, SDL_Renderer *renderer, long count, long frame, int batched)
+{
+    for (long i = 0; i < count; i++) {
+        SDL_Texture *tex = stress->textures[i & 1];
+        SDL_Rect src = { (int)(i % STRESS_TILES) * STRESS_TILE, 0, STRESS_TILE, STRESS_TILE };
+        SDL_Rect dst = {
+            (int)((i * 37 + frame * (1 + i % 5)) % (BENCH_WIDTH + STRESS_TILE)) - STRESS_TILE,
+            (int)((i * 53 + frame * (1 + i % 3)) % (BENCH_HEIGHT + STRESS_TILE)) - STRESS_TILE,
+            STRESS_TILE + (int)(i % 3) * 4, STRESS_TILE + (int)(i % 3) * 4,
+        };
+        SDL_RendererFlip flip = (SDL_RendererFlip)(i % 4 == 3 ? SDL_FLIP_HORIZONTAL | SDL_FLIP_VERTICAL : i % 4);
+        SDL_Color tint = { 255, (Uint8)(255 - i % 64), 255, (Uint8)(i % 8 ? 255 : 160) };
+        if (batched) {
+            sprite_batch_add(stress->batch, tex, &src, &dst, flip, tint, (int)(i % STRESS_LAYERS));
+        } else {
+            /* Same premultiplied tint the batch applies. */
+            SDL_SetTextureColorMod(tex, (Uint8)((tint.r * tint.a + 127) / 255), (Uint8)((tint.g * tint.a + 127) / 255),
+                                   (Uint8)((tint.b * tint.a + 127) / 255));
+            SDL_SetTextureAlphaMod(tex, tint.a);
+            SDL_RenderCopyEx(renderer, tex, &src, &dst, 0.0, NULL, flip);
+            stress->draw_calls++;
+        }
+    }
+    if (batched) {
+        SpriteBatchStats before, after;
+        sprite_batch_get_stats(stress->batch, &before);
+        sprite_batch_flush(stress->batch);
+        sprite_batch_get_stats(stress->batch, &after);
+        stress->draw_calls += after.draw_calls - before.draw_calls;
+    }
+}
+
+/* Entity clips: the elevator's frame timings over placeholder frames
+ * (updates never touch the sprites). */
+#define ENTITY_FRAMES  10
+static const Sprite ENTITY_SPRITES[ENTITY_FRAMES];
+static const AnimClip ENTITY_CLIPS[] = {
+    { ENTITY_SPRITES, 3, 0.07f, ANIM_LOOP },
+    { ENTITY_SPRITES, ENTITY_FRAMES, 0.08f, ANIM_ONCE },
+    { ENTITY_SPRITES, ENTITY_FRAMES, 0.08f, ANIM_REVERSE },
+    { ENTITY_SPRITES, 4, 0.125f, ANIM_LOOP },
+};
+#define ENTITY_CLIP_COUNT  (int)(sizeof ENTITY_CLIPS / sizeof ENTITY_CLIPS[0])
+
+static AnimWorld *entities_create(long count)
+{
+    AnimWorld *world = anim_world_create((int)count);
+    for (long i = 0; world && i < count; i++) {
+        int id = anim_spawn(world, &ENTITY_CLIPS[i % ENTITY_CLIP_COUNT], (float)(i % BENCH_WIDTH),
+                            (float)(i / BENCH_WIDTH % BENCH_HEIGHT));
+        if (id < 0) {
+            anim_world_destroy(world);
+            return NULL;
+        }
+        anim_set_speed(world, id, 0.5f + (float)(i % 7) * 0.25f);
+    }
+    return world;
+}
+
+static void press_key(ElevatorScene *scene, SDL_Keycode sym)
+{
+    SDL_Event ev;
+    memset(&ev, 0, sizeof ev);
+    ev.type = SDL_KEYDOWN;
+    ev.key.state = SDL_PRESSED;
+    ev.key.keysym.sym = sym;
+    (void)elevator_scene_process_event(scene, &ev);
+    ev.type = SDL_KEYUP;
+    ev.key.state = SDL_RELEASED;
+    (void)elevator_scene_process_event(scene, &ev);
+}
+
+int main(int argc, char **argv)
+{
+    BenchOptions opt = {
+        .ticks       = 20000,
+        .dt          = 1.0f / 60.0f,
+        .space_every = 120,
+        .draw_every  = 1,
+        .json        = 1,
+    };
+    if (parse_args(argc, argv, &opt) != 0)
+        return EXIT_FAILURE;
+    /* Before SDL allocates anything, so every block is seen. */
+    bool count_allocs = alloc_stats_install() == 0;
+    if (opt.assert_no_alloc && !count_allocs) {
+        fprintf(stderr, "--assert-no-alloc needs allocation counting: rebuild with make DEBUG=1\n");
+        return EXIT_FAILURE;
+    }
+
+    if (init_sdl() != 0)
+        return EXIT_FAILURE;
+
+    SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, BENCH_WIDTH, BENCH_HEIGHT, 32, SDL_PIXELFORMAT_RGBA32);
+    SDL_Renderer *renderer = target ? SDL_CreateSoftwareRenderer(target) : NULL;
+    if (!renderer) {
+        fprintf(stderr, "SDL_CreateSoftwareRenderer: %s\n", SDL_GetError());
+        if (target)
+            SDL_FreeSurface(target);
+        quit_sdl();
+        return EXIT_FAILURE;
+    }
+
+    Uint64 create_start = SDL_GetPerformanceCounter();
+    ElevatorScene *scene = elevator_scene_create(renderer);
+    double create_ms = (double)(SDL_GetPerformanceCounter() - create_start) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+    if (!scene) {
+        SDL_DestroyRenderer(renderer);
+        SDL_FreeSurface(target);
+        quit_sdl();
+        return EXIT_FAILURE;
+    }
+
+    /* Past here every failure goes through the cleanup at the end. */
+    int status = EXIT_FAILURE;
+    SoftRenderer *soft = NULL;
+    StressSprites stress = { 0 };
+    AnimWorld *entities = NULL;
+    ReplayReader *replay = NULL;
+    if (opt.soft) {
+        soft = soft_renderer_create(renderer, BENCH_WIDTH, BENCH_HEIGHT);
+        if (soft && opt.kernels && soft_renderer_set_kernels(soft, opt.kernels) != 0)
+            fprintf(stderr, "Kernels '%s' unavailable; using %s\n", opt.kernels, soft_renderer_kernels(soft));
+        if (!soft || elevator_scene_set_soft_renderer(scene, soft) != 0) {
+            fprintf(stderr, "Failed to set up the software rasterizer\n");
+            goto done;
+        }
+    }
+
+    /* Assets arrive in the background; time the wait separately from the run. */
+    Uint64 load_start = SDL_GetPerformanceCounter();
+    Uint32 load_deadline = SDL_GetTicks() + BENCH_LOAD_TIMEOUT_MS;
+    while (elevator_scene_is_loading(scene) && !elevator_scene_load_failed(scene) &&
+           !SDL_TICKS_PASSED(SDL_GetTicks(), load_deadline)) {
+        elevator_scene_update(scene, 0.0f);
+        SDL_Delay(1);
+    }
+    double load_ms = (double)(SDL_GetPerformanceCounter() - load_start) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+    if (elevator_scene_is_loading(scene)) {
+        fprintf(stderr, elevator_scene_load_failed(scene) ? "Elevator sprites failed to load\n"
+                                                          : "Assets did not finish loading\n");
+        goto done;
+    }
+    elevator_scene_set_window_size(scene, BENCH_WIDTH, BENCH_HEIGHT);
+    /* Minigames start on a fixed tick, whatever the prefetch thread's timing. */
+    elevator_scene_set_blocking_prefetch(scene, true);
+
+    if (opt.stress > 0 && stress_create(&stress, renderer) != 0) {
+        fprintf(stderr, "Failed to set up the stress sprites\n");
+        goto done;
+    }
+
+    if (opt.entities > 0 && !(entities = entities_create(opt.entities))) {
+        fprintf(stderr, "Failed to spawn %ld entities\n", opt.entities);
+        goto done;
+    }
+
+    /* A recording brings its own seed and tick; its ticks count from here. */
+    if (opt.replay) {
+        if (!(replay = replay_reader_open(opt.replay)))
+            goto done;
+        elevator_scene_set_seed(scene, replay_reader_seed(replay));
+        opt.dt = replay_reader_tick(replay);
+    }
+
+    Uint64 freq = SDL_GetPerformanceFrequency();
+    Uint64 update_counts = 0, draw_counts = 0, entity_counts = 0;
+    long frames = 0;
+    Uint64 checksum = 0xcbf29ce484222325ull;
+    long steady_ticks = 0, steady_alloc_ticks = 0;
+    AllocStats run_mark;
+    alloc_stats_get(&run_mark);
+    Uint64 start = SDL_GetPerformanceCounter();
+    Uint64 paced = start;  /* --realtime: when the next tick is due */
+    status = EXIT_SUCCESS;
+
+    long tick;
+    for (tick = 0; replay ? !replay_reader_done(replay, (Uint32)tick) : tick < opt.ticks; tick++) {
+        AllocStats tick_mark;
+        alloc_stats_get(&tick_mark);
+        if (replay) {
+            SDL_Event ev;
+            int rc;
+            while ((rc = replay_reader_next(replay, (Uint32)tick, &ev)) == 1)
+                (void)elevator_scene_process_event(scene, &ev);
+            if (rc < 0) {
+                fprintf(stderr, "Replay '%s' is damaged at tick %ld\n", opt.replay, tick);
+                status = EXIT_FAILURE;
+                break;
+            }
+        } else if (opt.space_every > 0 && tick % opt.space_every == 0) {
+            press_key(scene, SDLK_SPACE);
+        }
+        if (opt.realtime) {
+            paced += (Uint64)((double)opt.dt * (double)freq);
+            Uint64 now = SDL_GetPerformanceCounter();
+            if (paced > now)
+                SDL_Delay((Uint32)((paced - now) * 1000 / freq));
+        }
+
+        Uint64 t0 = SDL_GetPerformanceCounter();
+        if (entities) {
+            anim_world_update(entities, opt.dt);
+            Uint64 te = SDL_GetPerformanceCounter();
+            entity_counts += te - t0;
+            t0 = te;
+        }
+        elevator_scene_update(scene, opt.dt);
+        Uint64 t1 = SDL_GetPerformanceCounter();
+        update_counts += t1 - t0;
+
+        if (opt.draw_every > 0 && tick % opt.draw_every == 0) {
+            if (soft) {
+                soft_renderer_clear(soft, 0x1a, 0x4d, 0x2e);
+                elevator_scene_draw(scene);
+                soft_renderer_present(soft, NULL);
+            } else {
+                SDL_SetRenderDrawColor(renderer, 0x1a, 0x4d, 0x2e, 255);
+                SDL_RenderClear(renderer);
+                elevator_scene_draw(scene);
+                if (opt.stress > 0)
+                    stress_draw(&stress, renderer, opt.stress, frames, !opt.no_batch);
+            }
+            SDL_RenderPresent(renderer);
+            Uint64 t2 = SDL_GetPerformanceCounter();
+            draw_counts += t2 - t1;
+            frames++;
+            if (opt.checksum) {
+                /* Chain per-frame hashes so order matters, and keep it out of the draw time. */
+                Uint64 frame = soft ? soft_renderer_checksum(soft)
+                                    : soft_checksum_pixels(target->pixels, target->w, target->h, target->pitch);
+                checksum = (checksum ^ frame) * 0x100000001b3ull;
+                start += SDL_GetPerformanceCounter() - t2;
+            }
+        }
+        if (elevator_scene_is_steady(scene)) {
+            steady_ticks++;
+            if (alloc_stats_since(&tick_mark, NULL))
+                steady_alloc_ticks++;
+        }
+    }
+
+    opt.ticks = tick > 0 ? tick : 1;
+    replay_reader_close(replay);
+    double elapsed  = (double)(SDL_GetPerformanceCounter() - start) / (double)freq;
+    double update_s = (double)update_counts / (double)freq;
+    double draw_s   = (double)draw_counts / (double)freq;
+    double entity_s = (double)entity_counts / (double)freq;
+    if (elapsed <= 0.0)
+        elapsed = 1e-9;
+
+    TextStats text;
+    elevator_scene_get_text_stats(scene, &text);
+    SpriteBatchStats batch;
+    elevator_scene_get_batch_stats(scene, &batch);
+    double sprite_calls = frames ? (double)(batch.draw_calls + stress.draw_calls) / (double)frames : 0.0;
+    AllocStats run_allocs;
+    alloc_stats_since(&run_mark, &run_allocs);
+    /* -1: counting not built in. */
+    long long heap_allocs = count_allocs ? (long long)run_allocs.mallocs : -1;
+    long long textures_created = count_allocs ? (long long)run_allocs.textures : -1;
+    if (!count_allocs)
+        steady_alloc_ticks = -1;
+    int floor = elevator_scene_get_floor(scene);
+    int lives = elevator_scene_get_lives(scene);
+    char backend[32] = "sdl";
+    if (soft)
+        (void)snprintf(backend, sizeof backend, "soft-%s", soft_renderer_kernels(soft));
+    char checksum_str[24] = "";
+    if (opt.checksum)
+        (void)snprintf(checksum_str, sizeof checksum_str, "%016llx", (unsigned long long)checksum);
+
+    if (opt.json) {
+        printf("{\"ticks\":%ld,\"frames\":%ld,\"dt\":%.6f,\"scene_create_ms\":%.3f,\"load_ms\":%.3f,\"elapsed_s\":%.6f,"
+               "\"ticks_per_s\":%.1f,\"frames_per_s\":%.1f,"
+               "\"update_us_per_tick\":%.3f,\"draw_us_per_frame\":%.3f,"
+               "\"floor\":%d,\"lives\":%d,"
+               "\"text_surface_allocs\":%llu,\"text_texture_uploads\":%llu,"
+               "\"renderer\":\"%s\",\"frame_checksum\":\"%s\","
+               "\"stress_sprites\":%ld,\"batched\":%s,\"sprite_draw_calls_per_frame\":%.2f,"
+               "\"entities\":%ld,\"entity_update_us_per_tick\":%.3f,"
+               "\"heap_allocs\":%lld,\"textures_created\":%lld,\"steady_ticks\":%ld,\"steady_alloc_ticks\":%ld,"
+               "\"replay\":\"%s\"}\n",
+               opt.ticks, frames, opt.dt, create_ms, load_ms, elapsed,
+               (double)opt.ticks / elapsed, (double)frames / elapsed,
+               update_s * 1e6 / (double)opt.ticks, frames ? draw_s * 1e6 / (double)frames : 0.0,
+               floor, lives,
+               (unsigned long long)text.surface_allocs, (unsigned long long)text.texture_uploads,
+               backend, checksum_str,
+               opt.stress, opt.no_batch ? "false" : "true", sprite_calls,
+               opt.entities, entity_s * 1e6 / (double)opt.ticks,
+               heap_allocs, textures_created, steady_ticks, steady_alloc_ticks, opt.replay ? opt.replay : "");
+    } else {
+        printf("ticks=%ld\nframes=%ld\ndt=%.6f\nscene_create_ms=%.3f\nload_ms=%.3f\nelapsed_s=%.6f\n",
+               opt.ticks, frames, opt.dt, create_ms, load_ms, elapsed);
+        printf("ticks_per_s=%.1f\nframes_per_s=%.1f\n", (double)opt.ticks / elapsed, (double)frames / elapsed);
+        printf("update_us_per_tick=%.3f\ndraw_us_per_frame=%.3f\n",
+               update_s * 1e6 / (double)opt.ticks, frames ? draw_s * 1e6 / (double)frames : 0.0);
+        printf("floor=%d\nlives=%d\n", floor, lives);
+        printf("text_surface_allocs=%llu\ntext_texture_uploads=%llu\n",
+               (unsigned long long)text.surface_allocs, (unsigned long long)text.texture_uploads);
+        printf("renderer=%s\nframe_checksum=%s\n", backend, checksum_str);
+        printf("stress_sprites=%ld\nbatched=%d\nsprite_draw_calls_per_frame=%.2f\n",
+               opt.stress, !opt.no_batch, sprite_calls);
+        printf("entities=%ld\nentity_update_us_per_tick=%.3f\n", opt.entities, entity_s * 1e6 / (double)opt.ticks);
+        printf("heap_allocs=%lld\ntextures_created=%lld\nsteady_ticks=%ld\nsteady_alloc_ticks=%ld\n",
+               heap_allocs, textures_created, steady_ticks, steady_alloc_ticks);
+        printf("replay=%s\n", opt.replay ? opt.replay : "");
+    }
+
+    if (opt.expect_checksum && strcmp(checksum_str, opt.expect_checksum) != 0) {
+        fprintf(stderr, "frame checksum %s, expected %s\n", checksum_str, opt.expect_checksum);
+        status = EXIT_FAILURE;
+    }
+    if (opt.assert_no_alloc && steady_alloc_ticks > 0) {
+        fprintf(stderr, "%ld of %ld steady ticks allocated\n", steady_alloc_ticks, steady_ticks);
+        status = EXIT_FAILURE;
+    }
+
+done:
+    anim_world_destroy(entities);
+    stress_destroy(&stress);
+    elevator_scene_destroy(scene);
+    soft_renderer_destroy(soft);
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    quit_sdl();
+    return status;
+}
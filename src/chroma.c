@@ -0,0 +1,209 @@
+#include "chroma.h"
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CHROMA_X86 1
+#include <emmintrin.h>
+#endif
+
+#define CHROMA_MAX_THREADS      8
+#define CHROMA_ROWS_PER_THREAD  64
+
+/* Per-call constants shared by the scalar and SSE2 kernels. */
+typedef struct {
+    int   kr, kg, kb;
+    int   tolerance;
+    int   cap;       /* distance past the tolerance at which alpha reaches 255 */
+    int   ramp;      /* alpha = (min(d - tolerance, cap) << 8) * ramp >> 16 */
+    int   despill;   /* dominant channel of the key (0..2), or -1 */
+} KeyParams;
+
+typedef struct {
+    Uint8          *pixels;
+    int             w;
+    int             pitch;
+    int             y0;
+    int             y1;
+    const KeyParams *params;
+} KeyJob;
+
+static inline int div255(int x)
+{
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+static inline int iabs(int x) { return x < 0 ? -x : x; }
+static inline int imax(int a, int b) { return a > b ? a : b; }
+static inline int imin(int a, int b) { return a < b ? a : b; }
+
+static void key_span_scalar(Uint8 *px, int n, const KeyParams *p)
+{
+    for (int i = 0; i < n; i++, px += 4) {
+        int c[3] = { px[0], px[1], px[2] };
+        int d = imax(iabs(c[0] - p->kr), imax(iabs(c[1] - p->kg), iabs(c[2] - p->kb)));
+        int t = imin(imax(d - p->tolerance, 0), p->cap);
+        int ramp = (int)(((unsigned)(t << 8) * (unsigned)p->ramp) >> 16);
+        int a = div255(ramp * px[3]);
+        if (p->despill >= 0 && a > 0 && a < 255) {
+            int k = p->despill;
+            c[k] = imin(c[k], imax(c[(k + 1) % 3], c[(k + 2) % 3]));
+        }
+        px[0] = (Uint8)div255(c[0] * a);
+        px[1] = (Uint8)div255(c[1] * a);
+        px[2] = (Uint8)div255(c[2] * a);
+        px[3] = (Uint8)a;
+    }
+}
+
+#ifdef CHROMA_X86
+/* Four pixels at a time, one channel per 32-bit lane. Values never exceed
+ * 16 bits and the high half of every lane stays zero, so 16-bit ops are
+ * exact; each step mirrors key_span_scalar. */
+__attribute__((target("sse2")))
+static inline __m128i div255_sse2(__m128i x)
+{
+    x = _mm_add_epi16(x, _mm_set1_epi32(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+__attribute__((target("sse2")))
+static inline __m128i absdiff_sse2(__m128i a, __m128i b)
+{
+    return _mm_max_epi16(_mm_sub_epi16(a, b), _mm_sub_epi16(b, a));
+}
+
+__attribute__((target("sse2")))
+static void key_span_sse2(Uint8 *px, int n, const KeyParams *p)
+{
+    const __m128i lo8  = _mm_set1_epi32(0xFF);
+    const __m128i c255 = _mm_set1_epi32(255);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i kr = _mm_set1_epi32(p->kr), kg = _mm_set1_epi32(p->kg), kb = _mm_set1_epi32(p->kb);
+    const __m128i tol = _mm_set1_epi32(p->tolerance);
+    const __m128i cap = _mm_set1_epi32(p->cap);
+    const __m128i ramp = _mm_set1_epi32(p->ramp);
+    int i = 0;
+    for (; i + 4 <= n; i += 4, px += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)px);
+        __m128i c[3] = {
+            _mm_and_si128(v, lo8),
+            _mm_and_si128(_mm_srli_epi32(v, 8), lo8),
+            _mm_and_si128(_mm_srli_epi32(v, 16), lo8),
+        };
+        __m128i src_a = _mm_srli_epi32(v, 24);
+
+        __m128i d = _mm_max_epi16(absdiff_sse2(c[0], kr), _mm_max_epi16(absdiff_sse2(c[1], kg), absdiff_sse2(c[2], kb)));
+        __m128i t = _mm_min_epi16(_mm_max_epi16(_mm_sub_epi16(d, tol), zero), cap);
+        /* mulhi on the low halves; the zero high halves multiply to zero. */
+        __m128i r = _mm_mulhi_epu16(_mm_slli_epi32(t, 8), ramp);
+        __m128i a = div255_sse2(_mm_mullo_epi16(r, src_a));
+
+        if (p->despill >= 0) {
+            int k = p->despill;
+            __m128i edge = _mm_and_si128(_mm_cmpgt_epi32(a, zero), _mm_cmplt_epi32(a, c255));
+            __m128i limited = _mm_min_epi16(c[k], _mm_max_epi16(c[(k + 1) % 3], c[(k + 2) % 3]));
+            c[k] = _mm_or_si128(_mm_and_si128(edge, limited), _mm_andnot_si128(edge, c[k]));
+        }
+        __m128i out = div255_sse2(_mm_mullo_epi16(c[0], a));
+        out = _mm_or_si128(out, _mm_slli_epi32(div255_sse2(_mm_mullo_epi16(c[1], a)), 8));
+        out = _mm_or_si128(out, _mm_slli_epi32(div255_sse2(_mm_mullo_epi16(c[2], a)), 16));
+        out = _mm_or_si128(out, _mm_slli_epi32(a, 24));
+        _mm_storeu_si128((__m128i *)px, out);
+    }
+    key_span_scalar(px, n - i, p);
+}
+#endif
+
+static int key_rows(void *arg)
+{
+    const KeyJob *job = arg;
+    void (*span)(Uint8 *, int, const KeyParams *) = key_span_scalar;
+#ifdef CHROMA_X86
+    if (SDL_HasSSE2())
+        span = key_span_sse2;
+#endif
+    for (int y = job->y0; y < job->y1; y++)
+        span(job->pixels + (size_t)y * (size_t)job->pitch, job->w, job->params);
+    return 0;
+}
+
+static void run_rows(Uint8 *pixels, int w, int h, int pitch, const KeyParams *params, int threads)
+{
+    if (threads <= 0)
+        threads = SDL_GetCPUCount();
+    int by_size = h / CHROMA_ROWS_PER_THREAD;
+    if (threads > by_size)
+        threads = by_size;
+    if (threads > CHROMA_MAX_THREADS)
+        threads = CHROMA_MAX_THREADS;
+    if (threads < 1)
+        threads = 1;
+
+    KeyJob jobs[CHROMA_MAX_THREADS];
+    SDL_Thread *workers[CHROMA_MAX_THREADS] = { NULL };
+    for (int i = 0; i < threads; i++) {
+        jobs[i] = (KeyJob){ pixels, w, pitch, h * i / threads, h * (i + 1) / threads, params };
+        /* The calling thread takes the first band itself. */
+        if (i > 0)
+            workers[i] = SDL_CreateThread(key_rows, "chroma-key", &jobs[i]);
+    }
+    key_rows(&jobs[0]);
+    for (int i = 1; i < threads; i++) {
+        if (workers[i])
+            SDL_WaitThread(workers[i], NULL);
+        else
+            key_rows(&jobs[i]);  /* thread creation failed: do it here */
+    }
+}
+
+void chroma_key_apply(void *pixels, int w, int h, int pitch, const ChromaKey *key, int threads)
+{
+    if (!pixels || !key || w <= 0 || h <= 0)
+        return;
+    KeyParams p = {
+        .kr = key->r, .kg = key->g, .kb = key->b,
+        .tolerance = key->tolerance,
+        /* Rounded up so a distance of `cap` lands on exactly 255. feather 0:
+         * one step past the tolerance is already opaque. */
+        .cap  = key->feather ? key->feather : 1,
+        .ramp = key->feather ? ((255 << 8) + key->feather - 1) / key->feather : 0xFFFF,
+        .despill = -1,
+    };
+    /* Despill needs a clearly dominant key channel (green or blue screen). */
+    if (key->despill) {
+        int c[3] = { key->r, key->g, key->b };
+        int k = c[1] >= c[0] && c[1] >= c[2] ? 1 : c[2] >= c[0] ? 2 : 0;
+        if (c[k] - imax(c[(k + 1) % 3], c[(k + 2) % 3]) >= 32)
+            p.despill = k;
+    }
+    run_rows(pixels, w, h, pitch, &p, threads);
+}
+
+void chroma_premultiply(void *pixels, int w, int h, int pitch)
+{
+    if (!pixels)
+        return;
+    for (int y = 0; y < h; y++) {
+        Uint8 *px = (Uint8 *)pixels + (size_t)y * (size_t)pitch;
+        for (int x = 0; x < w; x++, px += 4) {
+            int a = px[3];
+            if (a == 255)
+                continue;
+            px[0] = (Uint8)div255(px[0] * a);
+            px[1] = (Uint8)div255(px[1] * a);
+            px[2] = (Uint8)div255(px[2] * a);
+        }
+    }
+}
+
+int chroma_set_premultiplied_blend(SDL_Texture *texture)
+{
+    SDL_BlendMode premul = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+    if (SDL_SetTextureBlendMode(texture, premul) == 0)
+        return 0;
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    return -1;
+}
@@ -0,0 +1,31 @@
+#ifndef CHROMA_H
+#define CHROMA_H
+
+#include <SDL.h>
+
+/* A key colour with a tolerance box around it. Pixels within `tolerance` of
+ * the key on every channel become transparent; alpha then ramps up over the
+ * next `feather` levels, so compression noise and anti-aliased edges fade
+ * out instead of leaving a fringe. */
+typedef struct ChromaKey {
+    Uint8 r, g, b;
+    Uint8 tolerance;
+    Uint8 feather;   /* 0 = hard edge */
+    Uint8 despill;   /* pull the key's dominant channel out of edge pixels */
+} ChromaKey;
+
+/* Keys RGBA32 pixels in place and leaves them premultiplied (colour scaled
+ * by alpha). Existing alpha is kept and multiplied with the key's. Rows are
+ * split over `threads` workers (<= 0 picks from the CPU count; small images
+ * stay on the calling thread). */
+void chroma_key_apply(void *pixels, int w, int h, int pitch, const ChromaKey *key, int threads);
+
+/* Premultiplies RGBA32 pixels in place without keying. */
+void chroma_premultiply(void *pixels, int w, int h, int pitch);
+
+/* Sets the blend mode for premultiplied textures. Returns 0 if the renderer
+ * supports it; otherwise falls back to BLEND (partially transparent edges
+ * then draw slightly dark) and returns -1. */
+int chroma_set_premultiplied_blend(SDL_Texture *texture);
+
+#endif /* CHROMA_H */
@@ -1,54 +1,155 @@
 #include "elevator.h"
+#include "anim.h"
+#include "arena.h"
+#include "atlas.h"
+#include "audio_clock.h"
+#include "batch.h"
+#include "elevator_rects.h"
+#include "latency.h"
+#include "layer.h"
+#include "loader.h"
+#include "minigame.h"
+#include "music.h"
+#include "pack.h"
+#include "replay.h"
+#include "softrender.h"
+#include "sound.h"
+#include "texcache.h"
+#include "text.h"
+#include "triple.h"
 #include <SDL_image.h>
 #include <SDL_mixer.h>
 #include <SDL_ttf.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define MINIGAME_MUSIC_PATH "assets/sounds/wario whirled.mp3"
 
 #define ELEVATOR_FONT_PATH "assets/warioware font.otf/warioware-inc-mega-microgame-big.otf"
 #define ELEVATOR_FONT_SIZE 14
 
-/* Exact sprite rects in elevator.png (inclusive coords: top-left to bottom-right).
- * Sprite 1: 4,66 to 243,225   Sprite 2: 254,66 to 493,225   Sprite 3: 504,66 to 743,225 */
-#define ELEVATOR_SPRITE_W  240
-#define ELEVATOR_SPRITE_H  160
-static const SDL_Rect ELEVATOR_SRC_RECTS[3] = {
-    {  4, 66, ELEVATOR_SPRITE_W, ELEVATOR_SPRITE_H },
-    { 254, 66, ELEVATOR_SPRITE_W, ELEVATOR_SPRITE_H },
-    { 504, 66, ELEVATOR_SPRITE_W, ELEVATOR_SPRITE_H },
-};
+/* Prebaked asset pack from `make assets` (or linked in with EMBED_PACK=1). */
+#define ELEVATOR_PACK_PATH   "assets/warioware.pak"
+
+/* Packed atlas from `make atlas`; the separate sheets are used when it's absent. */
+#define ELEVATOR_ATLAS_PNG   "assets/graphics/atlas.png"
+#define ELEVATOR_ATLAS_INDEX "assets/graphics/atlas.idx"
+
+#define ELEVATOR_SHEET_PATH     "assets/graphics/elevator.png"
+#define MUG_SHOT_SHEET_PATH     "assets/graphics/mug shot.png"
+#define BOMB_TIMER_SHEET_PATH   "assets/graphics/bomb timer.png"
 
-/* "Next" row has 3 frames; cycle through them. */
+/* Door frames are runs of ELEVATOR_RECTS: every sprite on elevator.png in
+ * reading order, generated into build/elevator_rects.h by `make rects`. The
+ * runs' positions (ELEVATOR_NEXT_FIRST, ELEVATOR_OPEN_FIRST) come from
+ * assets/graphics/elevator_names.txt, so they follow the sheet.
+ * "Next" row has 3 frames; cycle through them. */
 #define ELEVATOR_NEXT_FRAMES      3
 #define ELEVATOR_FRAME_DURATION   0.07f
+/* "Open" animation: 2 rows of 5 sprites. */
 #define ELEVATOR_OPEN_FRAMES      10
 #define ELEVATOR_OPEN_FRAME_TIME  0.08f
+_Static_assert(ELEVATOR_NEXT_COUNT == ELEVATOR_NEXT_FRAMES && ELEVATOR_OPEN_COUNT == ELEVATOR_OPEN_FRAMES,
+               "elevator_names.txt door frame counts differ from elevator.c");
 
-/* "Open" animation: 2 rows of 5 sprites. Exact coords (top-left to bottom-right inclusive). */
-static const SDL_Rect ELEVATOR_OPEN_RECTS[10] = {
-    {   1, 310, ELEVATOR_SPRITE_W, ELEVATOR_SPRITE_H },  /*  1: 1,310 to 240,469 */
-    { 251, 311, ELEVATOR_SPRITE_W, ELEVATOR_SPRITE_H },  /*  2: 251,311 to 490,470 */
-    { 501, 311, ELEVATOR_SPRITE_W, ELEVATOR_SPRITE_H },  /*  3: 501,311 to 740,470 */
-    { 751, 311, ELEVATOR_SPRITE_W, ELEVATOR_SPRITE_H },  /*  4: 751,311 to 990,470 */
-    {1001, 311, ELEVATOR_SPRITE_W, ELEVATOR_SPRITE_H },  /*  5: 1001,311 to 1240,470 */
-    {   1, 476, ELEVATOR_SPRITE_W, ELEVATOR_SPRITE_H },  /*  6: 1,476 to 240,635 */
-    { 251, 476, ELEVATOR_SPRITE_W, ELEVATOR_SPRITE_H },  /*  7: 251,476 to 490,635 */
-    { 501, 476, ELEVATOR_SPRITE_W, ELEVATOR_SPRITE_H },  /*  8: 501,476 to 740,635 */
-    { 751, 476, ELEVATOR_SPRITE_W, ELEVATOR_SPRITE_H },  /*  9: 751,476 to 990,635 */
-    {1001, 476, ELEVATOR_SPRITE_W, ELEVATOR_SPRITE_H },  /* 10: 1001,476 to 1240,635 */
-};
+/* Bomb timer: 3 seconds, 4 frames (rope long → short → explosion). Sheet 240×129, 4 frames in a row. */
+#define BOMB_TIMER_DURATION    3.0f
+#define BOMB_TIMER_FRAMES      4
+#define BOMB_TIMER_FRAME_W     60
+#define BOMB_TIMER_FRAME_H     129
+
+/* Minigame time follows the audio clock. Small drift decays with this time
+ * constant whatever the update rate (about 10% per 60 Hz tick); anything
+ * past the snap threshold (a hitch) is jumped. */
+#define AUDIO_SYNC_TAU_S       0.16f
+#define AUDIO_SYNC_SNAP_S      0.1f
+
+typedef enum { ELEVATOR_STATE_LOADING, ELEVATOR_STATE_IDLE, ELEVATOR_STATE_DOORS_OPENING, ELEVATOR_STATE_MINIGAME, ELEVATOR_STATE_DOORS_CLOSING } ElevatorState;
+
+#define ELEVATOR_START_LIVES  4
+/* Seeds the minigame picker, so a run from launch always plays the same games. */
+#define ELEVATOR_GAME_SEED    0x5741u
 
-typedef enum { ELEVATOR_STATE_IDLE, ELEVATOR_STATE_DOORS_OPENING, ELEVATOR_STATE_MINIGAME, ELEVATOR_STATE_DOORS_CLOSING } ElevatorState;
+/* Tags for background loads, so on_asset_ready knows where each result goes. */
+enum { ASSET_TAG_ATLAS, ASSET_TAG_ELEVATOR, ASSET_TAG_MUG_SHOT, ASSET_TAG_BOMB_TIMER, ASSET_TAG_ATLAS_INDEX,
+       ASSET_TAG_FONT };
+/* Set on hot reloads: the result replaces an asset already in use. */
+#define ASSET_TAG_RELOAD  0x100
+
+/* First-block sizes; both grow to fit and then stay put. */
+#define ELEVATOR_GAME_ARENA   (64 * 1024)
+#define ELEVATOR_FRAME_ARENA  (16 * 1024)
+/* Animated objects reserved for a minigame; grows if a game spawns more. */
+#define ELEVATOR_GAME_ANIMS   256
+/* GPU bytes minigame sheets may hold between them; the least recently drawn
+ * go first. About six 1240-wide sheets. */
+#define ELEVATOR_TEXTURE_BUDGET  (32u * 1024u * 1024u)
+/* Decoded music kept in memory (about a minute and a half of 44.1 kHz
+ * stereo); packed tracks play from the pack and don't count. */
+#define ELEVATOR_MUSIC_CACHE     (16u * 1024u * 1024u)
+/* A game won early fades the fuse music out rather than cutting it. */
+#define ELEVATOR_MUSIC_FADE_S    0.15f
+
+/* Texture uploads per frame while streaming, so the loading screen stays smooth. */
+#define ELEVATOR_UPLOADS_PER_FRAME  1
+
+/* Input events waiting for the sim thread; more than this in one tick are dropped. */
+#define ELEVATOR_INPUT_QUEUE  64
+/* Most backlog the sim thread replays after a stall. */
+#define ELEVATOR_SIM_MAX_CATCHUP_S  0.25
+
+/* Everything a draw needs from the simulation, published once per update. */
+typedef struct {
+    ElevatorState      state;
+    const Sprite      *doors;         /* current door frame */
+    float              minigame_timer;
+    float              prev_minigame_timer;
+    int                floor;
+    int                lives;
+    const MinigameDef *game;
+    float              next_change;   /* elevator_scene_next_change as of this update */
+    Uint64             input_time;    /* latest input the simulation acted on */
+    Uint32             input_seq;     /* bumped with input_time */
+    Uint64             published;     /* performance counter */
+} ElevatorSnapshot;
 
 struct ElevatorScene {
     SDL_Renderer *renderer;
+    AssetPack    *pack;          /* mapped for the scene's lifetime; music and font read from it */
+    AssetLoader  *loader;        /* decodes loose files off the main thread */
+    TextureCache *textures;      /* minigame sheets, kept across games within a budget */
+    char         *atlas_index;   /* atlas.idx text, held until atlas.png arrives */
+    size_t        atlas_index_len;
+    bool          load_failed;
     SDL_Texture  *sprite_sheet;
     SDL_Texture  *mug_shot_sheet;
     SDL_Texture  *bomb_timer_sheet;
-    Mix_Music    *minigame_music;
+    SpriteAtlas  *atlas;         /* when loaded, every sprite below points into it */
+    Sprite        next_sprites[ELEVATOR_NEXT_FRAMES];
+    Sprite        open_sprites[ELEVATOR_OPEN_FRAMES];
+    Sprite        mug_shot_sprite;
+    Sprite        bomb_sprites[BOMB_TIMER_FRAMES];
+    MusicPlayer  *music;         /* NULL plays the fuse silently */
+    int           minigame_track;
+    SoundBank    *sounds;        /* short cues, preloaded as PCM */
     TTF_Font     *font;
+    void         *font_data;     /* file a hot-reloaded font reads from */
+    TextAtlas    *text;          /* glyphs rasterized once; HUD draws from here */
+    /* Hot reloads waiting for the old asset to go out of use (swap_reloaded). */
+    char         *reload_index;  /* atlas.idx, held until atlas.png arrives */
+    size_t        reload_index_len;
+    bool          atlas_reloading;  /* index, then image, in flight */
+    bool          atlas_changed;    /* saved again meanwhile: one more round after this */
+    TTF_Font     *reload_font;
+    void         *reload_font_data;
+    TextAtlas    *reload_text;
+    SoftRenderer *soft;            /* borrowed; when set, everything is drawn on the CPU */
+    RenderLayer  *backdrop_layer;  /* black + mug shot behind the doors; NULL draws directly */
+    RenderLayer  *hud_layer;       /* floor and lives text */
+    SpriteBatch  *batch;           /* sprites queued per draw; NULL draws each directly */
+    int           hud_floor;       /* values hud_layer was composed with */
+    int           hud_lives;
     int           sheet_w;
     int           sheet_h;
     int           window_w;
@@ -56,20 +157,68 @@ struct ElevatorScene {
     int           current_floor;
     int           lives;
     ElevatorState state;
-    int           anim_frame;
-    float         anim_timer;
+    AnimWorld    *anims;           /* the doors */
+    int           doors;           /* entity in anims; -1 until the sprites are in */
+    AnimClip      idle_clip;       /* frames point into the sprite arrays above */
+    AnimClip      open_clip;
+    AnimClip      close_clip;
     float         minigame_timer;  /* countdown 3→0, then return to elevator */
+    float         prev_minigame_timer;  /* value before the last update, for interpolation */
+    float         render_alpha;    /* 0..1 between the last two updates; 1 draws the latest */
+    AudioClock   *clock;           /* borrowed; NULL runs on frame deltas alone */
+    double        minigame_audio_start;
+    bool          minigame_synced; /* music started, so the audio clock is authoritative */
+    AudioDriftStats drift;
+    double        drift_sum_abs_ms;
+    Uint32        game_rng;        /* picks each next game and its seed */
+    const MinigameDef *next_game;  /* chosen on arrival at idle */
+    const MinigameDef *game;       /* being prefetched or played */
+    void         *game_state;      /* game->create's result; NULL plays the bare fuse */
+    const MinigameDef *retired;    /* ended on the sim thread, destroyed by the main thread */
+    void         *retired_state;
+    MinigameContext game_ctx;
+    SDL_Thread   *prefetch_thread; /* runs game->create while the doors open */
+    SDL_atomic_t  prefetch_done;
+    bool          blocking_prefetch;
+    Arena        *game_arena;      /* the minigame's memory; reset when the doors close */
+    Arena        *frame_arena;     /* per-update scratch */
+    AnimWorld    *game_anims;      /* the minigame's animated objects */
+    int           steady_ticks;    /* updates in a row with nothing that allocates in flight */
+    SDL_atomic_t  steady;          /* steady_ticks >= 2, readable from the main thread */
+    TripleBuffer *snapshots;       /* ElevatorSnapshot, sim → draw */
+    const ElevatorSnapshot *view;  /* the snapshot the main thread last took */
+    SDL_Thread   *sim_thread;      /* NULL: the caller updates on its own thread */
+    SDL_atomic_t  sim_quit;
+    SDL_atomic_t  paused;          /* focus lost: time stands still, input is dropped */
+    double        pause_audio;     /* audio clock when paused */
+    float         sim_tick_s;
+    SDL_mutex    *game_lock;       /* load delivery and minigame hooks vs the sim thread */
+    SDL_Event     input[ELEVATOR_INPUT_QUEUE];  /* main → sim, single producer and consumer */
+    SDL_atomic_t  input_head;      /* next slot the main thread writes */
+    SDL_atomic_t  input_tail;      /* next slot the sim thread reads */
+    Uint64        input_time;      /* sim: event time of the latest input acted on */
+    Uint32        input_seq;
+    Uint32        drawn_seq;       /* main: input_seq of the last snapshot drawn */
+    Uint64        shown_input;     /* main: input first shown by the last draw, 0 if none */
+    Uint32        seed;            /* game_rng's starting value */
+    Uint32        tick;            /* updates since loading finished; indexes recorded input */
+    ReplayWriter *recorder;        /* borrowed; NULL records nothing */
 };
 
-/* Green background in the elevator sheet (chroma key). */
-#define ELEVATOR_CHROMA_R  25
-#define ELEVATOR_CHROMA_G  128
-#define ELEVATOR_CHROMA_B  93
+/* Green background in the elevator sheet. The tolerance absorbs the noise
+ * in the backdrop; the feather and despill clean up the green fringe on
+ * anti-aliased edges. */
+static const ChromaKey ELEVATOR_CHROMA = { 25, 128, 93, 12, 24, 1 };
+
+/* Green background in mug shot sheet. */
+static const ChromaKey MUG_SHOT_CHROMA = { 24, 126, 55, 12, 24, 1 };
+
+/* Grey background of the bomb timer. Kept tight so greys in the artwork
+ * survive; despill has no dominant channel to pull here. */
+static const ChromaKey BOMB_TIMER_CHROMA = { 0x88, 0x88, 0x88, 4, 8, 0 };
 
-/* Green background in mug shot sheet (chroma key). */
-#define MUG_SHOT_CHROMA_R  24
-#define MUG_SHOT_CHROMA_G  126
-#define MUG_SHOT_CHROMA_B  55
+/* The fuse music: once, as recorded, starting on the first frame of the game. */
+static const MusicPlayParams FUSE_MUSIC = { .tempo = 1.0f };
 
 /* Mug shot overlay sprite: 2,2 to 241,161 (240×160) */
 #define MUG_SHOT_SRC_X  2
@@ -77,78 +226,321 @@ struct ElevatorScene {
 #define MUG_SHOT_SRC_W  240
 #define MUG_SHOT_SRC_H  160
 
-/* Bomb timer: 3 seconds, 4 frames (rope long → short → explosion). Sheet 240×129, 4 frames in a row. */
-#define BOMB_TIMER_DURATION    3.0f
-#define BOMB_TIMER_FRAMES      4
-#define BOMB_TIMER_FRAME_W     60
-#define BOMB_TIMER_FRAME_H     129
-#define BOMB_TIMER_CHROMA_R    0x88
-#define BOMB_TIMER_CHROMA_G    0x88
-#define BOMB_TIMER_CHROMA_B    0x88
+/* Points every sprite at the packed atlas. Returns -1 if any name is missing. */
+static int bind_atlas_sprites(ElevatorScene *scene)
+{
+    char name[32];
+    for (int i = 0; i < ELEVATOR_NEXT_FRAMES; i++) {
+        (void)snprintf(name, sizeof name, "elevator_next_%d", i);
+        if (sprite_atlas_find(scene->atlas, name, &scene->next_sprites[i]) != 0)
+            return -1;
+    }
+    for (int i = 0; i < ELEVATOR_OPEN_FRAMES; i++) {
+        (void)snprintf(name, sizeof name, "elevator_open_%d", i);
+        if (sprite_atlas_find(scene->atlas, name, &scene->open_sprites[i]) != 0)
+            return -1;
+    }
+    for (int i = 0; i < BOMB_TIMER_FRAMES; i++) {
+        (void)snprintf(name, sizeof name, "bomb_%d", i);
+        if (sprite_atlas_find(scene->atlas, name, &scene->bomb_sprites[i]) != 0)
+            return -1;
+    }
+    return sprite_atlas_find(scene->atlas, "mug_shot", &scene->mug_shot_sprite);
+}
 
-static SDL_Texture *load_texture_with_chroma(SDL_Renderer *renderer, const char *path, Uint8 r, Uint8 g, Uint8 b)
+/* Point sprites at the hard-coded rects in the separate sheets, one sheet
+ * at a time: a reloaded sheet takes over its own sprites even while the
+ * rest come from the atlas. */
+static void bind_elevator_sprites(ElevatorScene *scene)
 {
-    SDL_Surface *surf = IMG_Load(path);
-    if (!surf) {
-        fprintf(stderr, "Failed to load '%s': %s\n", path, IMG_GetError());
-        return NULL;
+    for (int i = 0; i < ELEVATOR_NEXT_FRAMES; i++)
+        scene->next_sprites[i] = sprite_from_sheet(scene->sprite_sheet, ELEVATOR_RECTS[ELEVATOR_NEXT_FIRST + i]);
+    for (int i = 0; i < ELEVATOR_OPEN_FRAMES; i++)
+        scene->open_sprites[i] = sprite_from_sheet(scene->sprite_sheet, ELEVATOR_RECTS[ELEVATOR_OPEN_FIRST + i]);
+}
+
+static void bind_mug_shot_sprite(ElevatorScene *scene)
+{
+    SDL_Rect mug_src = { MUG_SHOT_SRC_X, MUG_SHOT_SRC_Y, MUG_SHOT_SRC_W, MUG_SHOT_SRC_H };
+    scene->mug_shot_sprite = sprite_from_sheet(scene->mug_shot_sheet, mug_src);
+}
+
+static void bind_bomb_sprites(ElevatorScene *scene)
+{
+    for (int i = 0; i < BOMB_TIMER_FRAMES; i++) {
+        SDL_Rect bomb_src = { i * BOMB_TIMER_FRAME_W, 0, BOMB_TIMER_FRAME_W, BOMB_TIMER_FRAME_H };
+        scene->bomb_sprites[i] = sprite_from_sheet(scene->bomb_timer_sheet, bomb_src);
     }
-    Uint32 key = SDL_MapRGB(surf->format, r, g, b);
-    if (SDL_SetColorKey(surf, SDL_TRUE, key) != 0) {
-        fprintf(stderr, "SDL_SetColorKey: %s\n", SDL_GetError());
-        SDL_FreeSurface(surf);
+}
+
+/* Atlas straight from the pack: pixels are uploaded from the mapping. */
+static SpriteAtlas *load_packed_atlas(ElevatorScene *scene)
+{
+    const PackEntry *index = asset_pack_find(scene->pack, "atlas_index", PACK_ENTRY_BLOB);
+    if (!index)
         return NULL;
-    }
-    SDL_Texture *tex = SDL_CreateTextureFromSurface(renderer, surf);
-    SDL_FreeSurface(surf);
+    SDL_Texture *tex = asset_pack_create_texture(scene->pack, scene->renderer, "atlas");
     if (!tex)
-        fprintf(stderr, "SDL_CreateTextureFromSurface: %s\n", SDL_GetError());
-    return tex;
+        return NULL;
+    SpriteAtlas *atlas = sprite_atlas_create(tex, asset_pack_data(scene->pack, index), index->size);
+    if (!atlas)
+        SDL_DestroyTexture(tex);
+    return atlas;
 }
 
-static SDL_Texture *load_elevator_texture(SDL_Renderer *renderer, const char *path)
+static int submit_image(ElevatorScene *scene, int tag, const char *path, const ChromaKey *key);
+static void on_asset_ready(void *user, const AssetResult *res);
+
+/* Queues the three separate sheets (used when there is no atlas). */
+static void submit_sheets(ElevatorScene *scene)
 {
-    return load_texture_with_chroma(renderer, path, ELEVATOR_CHROMA_R, ELEVATOR_CHROMA_G, ELEVATOR_CHROMA_B);
+    submit_image(scene, ASSET_TAG_ELEVATOR, ELEVATOR_SHEET_PATH, &ELEVATOR_CHROMA);
+    submit_image(scene, ASSET_TAG_MUG_SHOT, MUG_SHOT_SHEET_PATH, &MUG_SHOT_CHROMA);
+    submit_image(scene, ASSET_TAG_BOMB_TIMER, BOMB_TIMER_SHEET_PATH, &BOMB_TIMER_CHROMA);
 }
 
-/* Render text at (x, y); caller does not own the returned texture (short-lived). */
-static void draw_text(SDL_Renderer *rend, TTF_Font *font, const char *text, int x, int y, Uint8 red, Uint8 grn, Uint8 blu)
+/* Frees a texture that has been replaced (and its software copy). */
+static void free_texture(ElevatorScene *scene, SDL_Texture *texture)
 {
-    if (!font || !text)
+    if (!texture)
         return;
-    SDL_Color color = { red, grn, blu, 255 };
-    SDL_Surface *surf = TTF_RenderText_Blended(font, text, color);
-    if (!surf)
+    soft_renderer_remove_image(scene->soft, texture);
+    SDL_DestroyTexture(texture);
+}
+
+/* Hot reload of the atlas: the index is read first and its arrival queues
+ * the image, so the two always come from one round. atlas.png and atlas.idx
+ * are usually saved together; changes while a round is in flight fold into
+ * a single next one. */
+static void submit_atlas_reload(ElevatorScene *scene)
+{
+    AssetRequest req = { .kind = ASSET_FILE, .tag = ASSET_TAG_ATLAS_INDEX | ASSET_TAG_RELOAD,
+                         .on_ready = on_asset_ready, .user = scene };
+    (void)snprintf(req.path, sizeof req.path, "%s", ELEVATOR_ATLAS_INDEX);
+    scene->atlas_reloading = asset_loader_submit(scene->loader, &req) == 0;
+}
+
+static void finish_atlas_reload(ElevatorScene *scene)
+{
+    scene->atlas_reloading = false;
+    if (scene->atlas_changed) {
+        scene->atlas_changed = false;
+        submit_atlas_reload(scene);
+    }
+}
+
+/* Hot reload: moves every atlas sprite to the new image and the index that
+ * arrived before it. If the index lacks a sprite, the old atlas stays. */
+static void reload_atlas(ElevatorScene *scene, SDL_Texture *texture)
+{
+    SpriteAtlas *atlas = sprite_atlas_create(texture, scene->reload_index, scene->reload_index_len);
+    SDL_free(scene->reload_index);
+    scene->reload_index = NULL;
+    if (!atlas) {
+        fprintf(stderr, "hot reload: '%s' unusable; keeping the old atlas\n", ELEVATOR_ATLAS_INDEX);
+        free_texture(scene, texture);
         return;
-    SDL_Texture *tex = SDL_CreateTextureFromSurface(rend, surf);
-    SDL_FreeSurface(surf);
-    if (!tex)
+    }
+    SpriteAtlas *old = scene->atlas;
+    Sprite next[ELEVATOR_NEXT_FRAMES], open[ELEVATOR_OPEN_FRAMES], bomb[BOMB_TIMER_FRAMES];
+    Sprite mug = scene->mug_shot_sprite;
+    memcpy(next, scene->next_sprites, sizeof next);
+    memcpy(open, scene->open_sprites, sizeof open);
+    memcpy(bomb, scene->bomb_sprites, sizeof bomb);
+    scene->atlas = atlas;
+    if (bind_atlas_sprites(scene) != 0) {
+        fprintf(stderr, "hot reload: '%s' is missing sprites; keeping the old atlas\n", ELEVATOR_ATLAS_INDEX);
+        memcpy(scene->next_sprites, next, sizeof next);
+        memcpy(scene->open_sprites, open, sizeof open);
+        memcpy(scene->bomb_sprites, bomb, sizeof bomb);
+        scene->mug_shot_sprite = mug;
+        scene->atlas = old;
+        soft_renderer_remove_image(scene->soft, texture);
+        sprite_atlas_destroy(atlas);
         return;
-    int w, h;
-    SDL_QueryTexture(tex, NULL, NULL, &w, &h);
-    SDL_Rect dst = { .x = x, .y = y, .w = w, .h = h };
-    SDL_RenderCopy(rend, tex, NULL, &dst);
-    SDL_DestroyTexture(tex);
+    }
+    if (old) {
+        soft_renderer_remove_image(scene->soft, sprite_atlas_texture(old));
+        sprite_atlas_destroy(old);
+    }
 }
 
-/* Render text centered at (cx, cy). */
-static void draw_text_centered(SDL_Renderer *rend, TTF_Font *font, const char *text, int cx, int cy, Uint8 red, Uint8 grn, Uint8 blu)
+/* Hot reload: a new font and its glyph atlas. They go into use in
+ * swap_reloaded, since a minigame holds on to the atlas it started with.
+ * Takes ownership of data (the font reads from it). */
+static void reload_font(ElevatorScene *scene, void *data, size_t size)
 {
-    if (!font || !text)
-        return;
-    SDL_Color color = { red, grn, blu, 255 };
-    SDL_Surface *surf = TTF_RenderText_Blended(font, text, color);
-    if (!surf)
+    SDL_RWops *rw = SDL_RWFromConstMem(data, (int)size);
+    TTF_Font *font = rw ? TTF_OpenFontRW(rw, 1, ELEVATOR_FONT_SIZE) : NULL;
+    TextAtlas *text = font ? text_atlas_create(scene->renderer, font) : NULL;
+    if (text && scene->soft && text_atlas_set_soft_renderer(text, scene->soft) != 0) {
+        text_atlas_destroy(text);
+        text = NULL;
+    }
+    if (!text) {
+        fprintf(stderr, "hot reload: '%s' unusable; keeping the old font\n", ELEVATOR_FONT_PATH);
+        if (font)
+            TTF_CloseFont(font);
+        SDL_free(data);
         return;
-    SDL_Texture *tex = SDL_CreateTextureFromSurface(rend, surf);
-    SDL_FreeSurface(surf);
-    if (!tex)
+    }
+    /* A newer save supersedes one still waiting. */
+    if (scene->reload_text) {
+        text_atlas_destroy(scene->reload_text);
+        TTF_CloseFont(scene->reload_font);
+        SDL_free(scene->reload_font_data);
+    }
+    scene->reload_font = font;
+    scene->reload_font_data = data;
+    scene->reload_text = text;
+}
+
+/* Main thread, after the pump: puts waiting reloads into use once nothing
+ * needs the old ones. Runs between frames, so no draw sees half a swap. */
+static void swap_reloaded(ElevatorScene *scene)
+{
+    if (scene->reload_text && !scene->game) {
+        if (scene->text)
+            text_atlas_destroy(scene->text);
+        if (scene->font)
+            TTF_CloseFont(scene->font);
+        SDL_free(scene->font_data);
+        scene->text = scene->reload_text;
+        scene->font = scene->reload_font;
+        scene->font_data = scene->reload_font_data;
+        scene->reload_text = NULL;
+        scene->reload_font = NULL;
+        scene->reload_font_data = NULL;
+        render_layer_invalidate(scene->hud_layer);
+    }
+}
+
+/* Runs on the main thread from asset_loader_pump; takes ownership of the result. */
+static void on_asset_ready(void *user, const AssetResult *res)
+{
+    ElevatorScene *scene = user;
+    bool reload = (res->tag & ASSET_TAG_RELOAD) != 0;
+    /* A sheet arriving can change what the backdrop shows. */
+    if (res->texture)
+        render_layer_invalidate(scene->backdrop_layer);
+    /* A failed reload (say, a half-written file) leaves the old asset up. */
+    if (reload && !res->texture && !res->data) {
+        fprintf(stderr, "hot reload: cannot load '%s'; keeping the old one\n", res->path);
+        int kind = res->tag & ~ASSET_TAG_RELOAD;
+        if (kind == ASSET_TAG_ATLAS || kind == ASSET_TAG_ATLAS_INDEX) {
+            SDL_free(scene->reload_index);
+            scene->reload_index = NULL;
+            finish_atlas_reload(scene);
+        }
         return;
-    int w, h;
-    SDL_QueryTexture(tex, NULL, NULL, &w, &h);
-    SDL_Rect dst = { .x = cx - w / 2, .y = cy - h / 2, .w = w, .h = h };
-    SDL_RenderCopy(rend, tex, NULL, &dst);
-    SDL_DestroyTexture(tex);
+    }
+    SDL_Texture *old;
+    switch (res->tag & ~ASSET_TAG_RELOAD) {
+    case ASSET_TAG_ATLAS:
+        if (reload) {
+            reload_atlas(scene, res->texture);
+            finish_atlas_reload(scene);
+            break;
+        }
+        if (res->texture)
+            scene->atlas = sprite_atlas_create(res->texture, scene->atlas_index, scene->atlas_index_len);
+        if (scene->atlas && bind_atlas_sprites(scene) != 0) {
+            soft_renderer_remove_image(scene->soft, res->texture);
+            sprite_atlas_destroy(scene->atlas);
+            scene->atlas = NULL;
+        } else if (!scene->atlas && res->texture) {
+            soft_renderer_remove_image(scene->soft, res->texture);
+            SDL_DestroyTexture(res->texture);
+        }
+        SDL_free(scene->atlas_index);
+        scene->atlas_index = NULL;
+        if (!scene->atlas) {
+            fprintf(stderr, "'%s' unusable; using separate sheets\n", ELEVATOR_ATLAS_PNG);
+            submit_sheets(scene);
+        }
+        break;
+    case ASSET_TAG_ATLAS_INDEX:
+        /* Reloads only: the image is read once its index is in. */
+        SDL_free(scene->reload_index);
+        scene->reload_index = res->data;
+        scene->reload_index_len = res->size;
+        if (submit_image(scene, ASSET_TAG_ATLAS | ASSET_TAG_RELOAD, ELEVATOR_ATLAS_PNG, NULL) != 0) {
+            SDL_free(scene->reload_index);
+            scene->reload_index = NULL;
+            finish_atlas_reload(scene);
+        }
+        break;
+    case ASSET_TAG_ELEVATOR:
+        old = scene->sprite_sheet;
+        scene->sprite_sheet = res->texture;
+        if (!scene->sprite_sheet || SDL_QueryTexture(scene->sprite_sheet, NULL, NULL, &scene->sheet_w, &scene->sheet_h) != 0)
+            scene->load_failed = true;
+        bind_elevator_sprites(scene);
+        free_texture(scene, old);
+        break;
+    case ASSET_TAG_MUG_SHOT:
+        old = scene->mug_shot_sheet;
+        scene->mug_shot_sheet = res->texture;
+        bind_mug_shot_sprite(scene);
+        free_texture(scene, old);
+        break;
+    case ASSET_TAG_BOMB_TIMER:
+        old = scene->bomb_timer_sheet;
+        scene->bomb_timer_sheet = res->texture;
+        bind_bomb_sprites(scene);
+        free_texture(scene, old);
+        break;
+    case ASSET_TAG_FONT:
+        reload_font(scene, res->data, res->size);
+        break;
+    }
+}
+
+/* key NULL: the image is used as is (already premultiplied). Returns 0 if queued. */
+static int submit_image(ElevatorScene *scene, int tag, const char *path, const ChromaKey *key)
+{
+    AssetRequest req = {
+        .kind      = ASSET_IMAGE,
+        .tag       = tag,
+        .keyed     = key != NULL,
+        .on_ready  = on_asset_ready,
+        .user      = scene,
+    };
+    if (key)
+        req.key = *key;
+    (void)snprintf(req.path, sizeof req.path, "%s", path);
+    if (asset_loader_submit(scene->loader, &req) == 0)
+        return 0;
+    if (tag == ASSET_TAG_ELEVATOR)
+        scene->load_failed = true;
+    return -1;
+}
+
+static float sim_next_change(const ElevatorScene *scene);
+
+/* Copies what the draw reads into the triple buffer's write slot. */
+static void publish(ElevatorScene *scene)
+{
+    ElevatorSnapshot *snap = triple_buffer_write_slot(scene->snapshots);
+    snap->state               = scene->state;
+    snap->doors               = anim_sprite(scene->anims, scene->doors);
+    snap->minigame_timer      = scene->minigame_timer;
+    snap->prev_minigame_timer = scene->prev_minigame_timer;
+    snap->floor               = scene->current_floor;
+    snap->lives               = scene->lives;
+    snap->game                = scene->game;
+    snap->next_change         = sim_next_change(scene);
+    snap->input_time          = scene->input_time;
+    snap->input_seq           = scene->input_seq;
+    snap->published           = SDL_GetPerformanceCounter();
+    triple_buffer_publish(scene->snapshots);
+}
+
+/* Main thread: takes the newest snapshot, if one was published. */
+static const ElevatorSnapshot *latest(ElevatorScene *scene)
+{
+    scene->view = triple_buffer_read(scene->snapshots, NULL);
+    return scene->view;
 }
 
 ElevatorScene *elevator_scene_create(SDL_Renderer *renderer)
@@ -158,121 +550,515 @@ ElevatorScene *elevator_scene_create(SDL_Renderer *renderer)
         return NULL;
 
     scene->renderer   = renderer;
-    scene->lives      = 4;
+    scene->lives      = ELEVATOR_START_LIVES;
     scene->current_floor = 1;
+    scene->state      = ELEVATOR_STATE_LOADING;
+    scene->render_alpha = 1.0f;
+    scene->backdrop_layer = render_layer_create(renderer);
+    scene->hud_layer      = render_layer_create(renderer);
+    scene->batch          = sprite_batch_create(renderer);
+    scene->seed           = ELEVATOR_GAME_SEED;
+    scene->game_rng       = ELEVATOR_GAME_SEED;
+    scene->doors          = -1;
+    scene->idle_clip  = (AnimClip){ scene->next_sprites, ELEVATOR_NEXT_FRAMES, ELEVATOR_FRAME_DURATION, ANIM_LOOP };
+    scene->open_clip  = (AnimClip){ scene->open_sprites, ELEVATOR_OPEN_FRAMES, ELEVATOR_OPEN_FRAME_TIME, ANIM_ONCE };
+    scene->close_clip = (AnimClip){ scene->open_sprites, ELEVATOR_OPEN_FRAMES, ELEVATOR_OPEN_FRAME_TIME, ANIM_REVERSE };
 
-    scene->sprite_sheet = load_elevator_texture(renderer, "assets/graphics/elevator.png");
-    if (!scene->sprite_sheet) {
-        elevator_scene_destroy(scene);
-        return NULL;
-    }
-
-    scene->mug_shot_sheet = load_texture_with_chroma(renderer, "assets/graphics/mug shot.png",
-                                                      MUG_SHOT_CHROMA_R, MUG_SHOT_CHROMA_G, MUG_SHOT_CHROMA_B);
-    if (!scene->mug_shot_sheet)
-        fprintf(stderr, "Failed to load mug shot sheet\n");
-
-    scene->bomb_timer_sheet = load_texture_with_chroma(renderer, "assets/graphics/bomb timer.png",
-                                                        BOMB_TIMER_CHROMA_R, BOMB_TIMER_CHROMA_G, BOMB_TIMER_CHROMA_B);
-    if (!scene->bomb_timer_sheet)
-        fprintf(stderr, "Failed to load bomb timer sheet\n");
-
-    scene->minigame_music = Mix_LoadMUS(MINIGAME_MUSIC_PATH);
-    if (!scene->minigame_music)
-        fprintf(stderr, "Mix_LoadMUS '%s': %s\n", MINIGAME_MUSIC_PATH, Mix_GetError());
-
-    scene->font = TTF_OpenFont(ELEVATOR_FONT_PATH, ELEVATOR_FONT_SIZE);
+    /* Font and text atlas first (small): the loading screen needs them. */
+    scene->pack = asset_pack_open_default(ELEVATOR_PACK_PATH);
+    SDL_RWops *font_rw = asset_pack_open_rw(scene->pack, "font", PACK_ENTRY_BLOB);
+    if (font_rw)
+        scene->font = TTF_OpenFontRW(font_rw, 1, ELEVATOR_FONT_SIZE);
+    if (!scene->font)
+        scene->font = TTF_OpenFont(ELEVATOR_FONT_PATH, ELEVATOR_FONT_SIZE);
     if (!scene->font)
         fprintf(stderr, "TTF_OpenFont '%s': %s\n", ELEVATOR_FONT_PATH, TTF_GetError());
 
-    if (SDL_QueryTexture(scene->sprite_sheet, NULL, NULL, &scene->sheet_w, &scene->sheet_h) != 0) {
-        fprintf(stderr, "SDL_QueryTexture: %s\n", SDL_GetError());
+    if (scene->font) {
+        scene->text = text_atlas_create(renderer, scene->font);
+        if (!scene->text)
+            fprintf(stderr, "Failed to build text atlas\n");
+    }
+
+    /* The pack needs no decoding, so it is used directly; anything else is
+     * decoded on the loader's workers and uploaded a little each frame. */
+    if (scene->pack) {
+        scene->atlas = load_packed_atlas(scene);
+        if (scene->atlas && bind_atlas_sprites(scene) != 0) {
+            sprite_atlas_destroy(scene->atlas);
+            scene->atlas = NULL;
+        }
+    }
+
+    scene->loader = asset_loader_create(0);
+    if (!scene->loader) {
+        fprintf(stderr, "Failed to start asset loader\n");
+        elevator_scene_destroy(scene);
+        return NULL;
+    }
+    scene->textures = texture_cache_create(renderer, scene->loader, scene->pack, ELEVATOR_TEXTURE_BUDGET);
+    if (!scene->textures) {
+        fprintf(stderr, "Failed to create texture cache\n");
+        elevator_scene_destroy(scene);
+        return NULL;
+    }
+    scene->game_arena  = arena_create(ELEVATOR_GAME_ARENA);
+    scene->frame_arena = arena_create(ELEVATOR_FRAME_ARENA);
+    scene->anims       = anim_world_create(1);
+    scene->game_anims  = anim_world_create(ELEVATOR_GAME_ANIMS);
+    if (!scene->game_arena || !scene->frame_arena || !scene->anims || !scene->game_anims) {
+        fprintf(stderr, "Failed to create minigame arenas\n");
         elevator_scene_destroy(scene);
         return NULL;
     }
+    scene->snapshots = triple_buffer_create(sizeof(ElevatorSnapshot));
+    scene->game_lock = SDL_CreateMutex();
+    if (!scene->snapshots || !scene->game_lock) {
+        fprintf(stderr, "Failed to create scene snapshots\n");
+        elevator_scene_destroy(scene);
+        return NULL;
+    }
+    if (!scene->atlas) {
+        scene->atlas_index = SDL_LoadFile(ELEVATOR_ATLAS_INDEX, &scene->atlas_index_len);
+        if (!scene->atlas_index || submit_image(scene, ASSET_TAG_ATLAS, ELEVATOR_ATLAS_PNG, NULL) != 0) {
+            SDL_free(scene->atlas_index);
+            scene->atlas_index = NULL;
+            submit_sheets(scene);
+        }
+    }
+    scene->sounds = sound_bank_create(scene->pack, scene->loader);
+    if (!scene->sounds)
+        fprintf(stderr, "Sound effects disabled\n");
+
+    /* Packed music is already PCM and plays from the pack; a loose file is
+     * decoded to PCM once, in the background, so the fuse starts at once. */
+    scene->music = music_player_create(scene->pack, scene->loader, ELEVATOR_MUSIC_CACHE);
+    scene->minigame_track = music_player_define(scene->music, "minigame_music", MINIGAME_MUSIC_PATH);
+    if (scene->music)
+        music_player_prefetch(scene->music, scene->minigame_track);
+    else
+        fprintf(stderr, "Minigame music disabled\n");
 
+    /* The loading screen draws from this until the first update. */
+    publish(scene);
+    latest(scene);
     return scene;
 }
 
+static void finish_prefetch(ElevatorScene *scene);
+static void retire_minigame(ElevatorScene *scene);
+
 void elevator_scene_destroy(ElevatorScene *scene)
 {
     if (!scene)
         return;
+    elevator_scene_stop_sim_thread(scene);
+    /* The prefetch may still be submitting loads. */
+    finish_prefetch(scene);
+    /* Stop the workers before freeing anything their callbacks write into. */
+    if (scene->loader)
+        asset_loader_destroy(scene->loader);
+    retire_minigame(scene);
+    if (scene->game_state && scene->game->destroy)
+        scene->game->destroy(scene->game_state, &scene->game_ctx);
+    texture_cache_destroy(scene->textures);
+    music_player_destroy(scene->music);
+    arena_destroy(scene->game_arena);
+    arena_destroy(scene->frame_arena);
+    anim_world_destroy(scene->anims);
+    anim_world_destroy(scene->game_anims);
+    triple_buffer_destroy(scene->snapshots);
+    if (scene->game_lock)
+        SDL_DestroyMutex(scene->game_lock);
+    SDL_free(scene->atlas_index);
+    SDL_free(scene->reload_index);
+    if (scene->sounds)
+        sound_bank_destroy(scene->sounds);
+    render_layer_destroy(scene->backdrop_layer);
+    render_layer_destroy(scene->hud_layer);
+    sprite_batch_destroy(scene->batch);
+    if (scene->text)
+        text_atlas_destroy(scene->text);
     if (scene->font)
         TTF_CloseFont(scene->font);
+    SDL_free(scene->font_data);
+    if (scene->reload_text)
+        text_atlas_destroy(scene->reload_text);
+    if (scene->reload_font)
+        TTF_CloseFont(scene->reload_font);
+    SDL_free(scene->reload_font_data);
     if (scene->mug_shot_sheet)
         SDL_DestroyTexture(scene->mug_shot_sheet);
     if (scene->bomb_timer_sheet)
         SDL_DestroyTexture(scene->bomb_timer_sheet);
-    if (scene->minigame_music)
-        Mix_FreeMusic(scene->minigame_music);
     if (scene->sprite_sheet)
         SDL_DestroyTexture(scene->sprite_sheet);
+    if (scene->atlas)
+        sprite_atlas_destroy(scene->atlas);
+    /* Last: music and font above were reading from the mapping. */
+    if (scene->pack)
+        asset_pack_close(scene->pack);
     free(scene);
 }
 
-void elevator_scene_update(ElevatorScene *scene, float delta_s)
+/* Pulls the frame-delta countdown onto the music's clock, so the fuse frames
+ * stay on the beat through hitches and vsync jitter. */
+static void sync_minigame_timer(ElevatorScene *scene, float delta_s)
 {
-    if (!scene)
-        return;
+    float audio_elapsed = (float)(audio_clock_now(scene->clock) - scene->minigame_audio_start);
+    float game_elapsed  = BOMB_TIMER_DURATION - scene->minigame_timer;
+    float drift = game_elapsed - audio_elapsed;
+    float abs_drift = drift < 0.0f ? -drift : drift;
 
-    if (scene->state == ELEVATOR_STATE_MINIGAME) {
-        scene->minigame_timer -= delta_s;
-        if (scene->minigame_timer <= 0.0f) {
-            scene->current_floor++;
-            scene->state = ELEVATOR_STATE_DOORS_CLOSING;
-            scene->anim_frame = ELEVATOR_OPEN_FRAMES - 1;
-            scene->anim_timer = 0.0f;
+    scene->drift.samples++;
+    scene->drift_sum_abs_ms += abs_drift * 1000.0;
+    scene->drift.mean_abs_ms = scene->drift_sum_abs_ms / scene->drift.samples;
+    if (abs_drift * 1000.0 > scene->drift.max_abs_ms)
+        scene->drift.max_abs_ms = abs_drift * 1000.0;
+
+    if (abs_drift > AUDIO_SYNC_SNAP_S) {
+        scene->minigame_timer = BOMB_TIMER_DURATION - audio_elapsed;
+        scene->drift.snaps++;
+    } else {
+        scene->minigame_timer += drift * (1.0f - SDL_expf(-delta_s / AUDIO_SYNC_TAU_S));
+    }
+}
+
+static void pick_next_game(ElevatorScene *scene)
+{
+    scene->next_game = MINIGAMES[minigame_random(&scene->game_rng) % (Uint32)MINIGAME_COUNT];
+}
+
+static int prefetch_main(void *data)
+{
+    ElevatorScene *scene = data;
+    scene->game_state = scene->game->create(&scene->game_ctx);
+    if (!scene->game_state)
+        fprintf(stderr, "minigame '%s' failed to start; playing the bare fuse\n", scene->game->name);
+    SDL_AtomicSet(&scene->prefetch_done, 1);
+    return 0;
+}
+
+/* Builds the next game's state off the main thread while the doors open;
+ * create only submits its loads, which upload through the per-frame pump. */
+static void start_prefetch(ElevatorScene *scene)
+{
+    if (!scene->next_game)
+        pick_next_game(scene);
+    scene->game = scene->next_game;
+    scene->game_state = NULL;
+    scene->game_ctx = (MinigameContext){
+        .renderer = scene->renderer,
+        .loader   = scene->loader,
+        .batch    = scene->batch,
+        .soft     = scene->soft,
+        .text     = scene->text,
+        .textures = scene->textures,
+        .arena    = scene->game_arena,
+        .scratch  = scene->frame_arena,
+        .anims    = scene->game_anims,
+        .w        = scene->window_w > 0 ? scene->window_w : 1,
+        .h        = scene->window_h > 0 ? scene->window_h : 1,
+        .level    = scene->current_floor,
+        .seed     = minigame_random(&scene->game_rng),
+    };
+    /* Decoded again if the cache let it go. */
+    music_player_prefetch(scene->music, scene->minigame_track);
+    SDL_AtomicSet(&scene->prefetch_done, 0);
+    scene->prefetch_thread = SDL_CreateThread(prefetch_main, "minigame prefetch", scene);
+    if (!scene->prefetch_thread)
+        prefetch_main(scene);
+}
+
+static void finish_prefetch(ElevatorScene *scene)
+{
+    if (scene->prefetch_thread) {
+        SDL_WaitThread(scene->prefetch_thread, NULL);
+        scene->prefetch_thread = NULL;
+    }
+}
+
+/* True once create has returned and the game's assets are in, fuse music
+ * included. */
+static bool prefetch_ready(ElevatorScene *scene)
+{
+    if (!music_player_ready(scene->music, scene->minigame_track))
+        return false;
+    if (!scene->game)
+        return true;
+    if (!SDL_AtomicGet(&scene->prefetch_done))
+        return false;
+    finish_prefetch(scene);
+    return !scene->game_state || !scene->game->ready || scene->game->ready(scene->game_state);
+}
+
+/* Main thread, under game_lock: runs the ended game's destroy, which may
+ * free textures. Its arena stays until the doors have closed after this. */
+static void retire_minigame(ElevatorScene *scene)
+{
+    if (scene->retired_state && scene->retired->destroy)
+        scene->retired->destroy(scene->retired_state, &scene->game_ctx);
+    scene->retired_state = NULL;
+    scene->retired = NULL;
+}
+
+static void end_minigame(ElevatorScene *scene, MinigameResult result)
+{
+    /* May be on the sim thread: leave destroy to the main thread. */
+    scene->retired = scene->game;
+    scene->retired_state = scene->game_state;
+    scene->game_state = NULL;
+    scene->game = NULL;
+    /* Won early: the fuse music has nothing left to count down. */
+    if (scene->minigame_timer > 0.0f)
+        music_player_stop(scene->music, ELEVATOR_MUSIC_FADE_S);
+
+    if (result == MINIGAME_WON) {
+        sound_bank_play(scene->sounds, SOUND_WIN);
+        scene->current_floor++;
+    } else if (--scene->lives <= 0) {
+        sound_bank_play(scene->sounds, SOUND_GAME_OVER);
+        scene->lives = ELEVATOR_START_LIVES;
+        scene->current_floor = 1;
+    } else {
+        sound_bank_play(scene->sounds, SOUND_LOSS);
+    }
+    scene->state = ELEVATOR_STATE_DOORS_CLOSING;
+    anim_play(scene->anims, scene->doors, &scene->close_clip);
+}
+
+/* Nothing that allocates is in flight: no loads queued, no prefetch thread. */
+static bool scene_quiet(const ElevatorScene *scene)
+{
+    int done, total;
+    asset_loader_progress(scene->loader, &done, &total);
+    return done == total && !scene->prefetch_thread;
+}
+
+static void step(ElevatorScene *scene, float delta_s)
+{
+    /* The scene stays in LOADING until the elevator frames are in; the rest
+     * may stream in afterwards. */
+    if (scene->state == ELEVATOR_STATE_LOADING) {
+        if (scene->next_sprites[0].texture) {
+            scene->doors = anim_spawn(scene->anims, &scene->idle_clip, 0.0f, 0.0f);
+            scene->state = ELEVATOR_STATE_IDLE;
+            pick_next_game(scene);
         }
         return;
     }
+    anim_world_update(scene->anims, delta_s);
 
-    /* DOORS_CLOSING: play door frames in reverse (9→0), then return to idle */
-    if (scene->state == ELEVATOR_STATE_DOORS_CLOSING) {
-        scene->anim_timer += delta_s;
-        while (scene->anim_timer >= ELEVATOR_OPEN_FRAME_TIME) {
-            scene->anim_timer -= ELEVATOR_OPEN_FRAME_TIME;
-            scene->anim_frame--;
-            if (scene->anim_frame < 0) {
-                scene->anim_frame = 0;
-                scene->state = ELEVATOR_STATE_IDLE;
-                break;
+    switch (scene->state) {
+    case ELEVATOR_STATE_MINIGAME: {
+        scene->prev_minigame_timer = scene->minigame_timer;
+        scene->minigame_timer -= delta_s;
+        if (scene->minigame_synced)
+            sync_minigame_timer(scene, delta_s);
+        anim_world_update(scene->game_anims, delta_s);
+        MinigameResult result = MINIGAME_RUNNING;
+        if (scene->game_state)
+            result = scene->game->update(scene->game_state, delta_s);
+        if (result == MINIGAME_RUNNING && scene->minigame_timer <= 0.0f)
+            result = scene->game_state ? scene->game->timeout_result : MINIGAME_WON;
+        if (result != MINIGAME_RUNNING)
+            end_minigame(scene, result);
+        break;
+    }
+    case ELEVATOR_STATE_DOORS_CLOSING:
+        /* Door frames in reverse (9→0), then back to idle once the last
+         * game is destroyed. */
+        if (anim_finished(scene->anims, scene->doors) && !scene->retired_state) {
+            scene->state = ELEVATOR_STATE_IDLE;
+            anim_play(scene->anims, scene->doors, &scene->idle_clip);
+            /* Everything the last game allocated goes in one step. */
+            anim_world_clear(scene->game_anims);
+            arena_reset(scene->game_arena);
+            pick_next_game(scene);
+        }
+        break;
+    case ELEVATOR_STATE_DOORS_OPENING:
+        /* Frames 0→9, then the minigame. The doors hold open on the last
+         * frame until the prefetched game is ready. */
+        if (!anim_finished(scene->anims, scene->doors))
+            break;
+        while (scene->blocking_prefetch && !prefetch_ready(scene)) {
+            if (scene->sim_thread) {
+                /* The main thread's pump delivers the game's loads. */
+                SDL_UnlockMutex(scene->game_lock);
+                SDL_Delay(1);
+                SDL_LockMutex(scene->game_lock);
+            } else {
+                asset_loader_pump(scene->loader, scene->renderer, 0);
+                SDL_Delay(1);
             }
         }
-        return;
+        if (!prefetch_ready(scene))
+            break;
+        scene->state = ELEVATOR_STATE_MINIGAME;
+        scene->minigame_timer = BOMB_TIMER_DURATION;
+        scene->prev_minigame_timer = BOMB_TIMER_DURATION;
+        scene->minigame_synced = false;
+        if (music_player_play(scene->music, scene->minigame_track, &FUSE_MUSIC) == 0 && scene->clock) {
+            scene->minigame_audio_start = audio_clock_now(scene->clock);
+            scene->minigame_synced = true;
+        }
+        break;
+    default:
+        break;
     }
+}
 
-    if (scene->state == ELEVATOR_STATE_IDLE) {
-        scene->anim_timer += delta_s;
-        while (scene->anim_timer >= ELEVATOR_FRAME_DURATION) {
-            scene->anim_timer -= ELEVATOR_FRAME_DURATION;
-            scene->anim_frame = (scene->anim_frame + 1) % ELEVATOR_NEXT_FRAMES;
-        }
+/* One simulation update, on whichever thread owns the simulation. */
+static void advance(ElevatorScene *scene, float delta_s)
+{
+    /* Loading carries on while paused; nothing else moves. */
+    if (SDL_AtomicGet(&scene->paused) && scene->state != ELEVATOR_STATE_LOADING)
+        return;
+    ElevatorState before = scene->state;
+    bool quiet = scene_quiet(scene);
+    arena_reset(scene->frame_arena);
+    step(scene, delta_s);
+    /* Two updates in the same state, so the first draw after a transition
+     * (which may build layer targets) is not counted as steady. */
+    if (quiet && scene_quiet(scene) && scene->state == before && scene->state != ELEVATOR_STATE_LOADING)
+        scene->steady_ticks++;
+    else
+        scene->steady_ticks = 0;
+    SDL_AtomicSet(&scene->steady, scene->steady_ticks >= 2);
+    if (before != ELEVATOR_STATE_LOADING)
+        scene->tick++;
+    publish(scene);
+}
+
+void elevator_scene_pump(ElevatorScene *scene)
+{
+    if (!scene)
+        return;
+    /* Load callbacks write sprites, sounds and minigame state the sim reads. */
+    SDL_LockMutex(scene->game_lock);
+    asset_loader_pump(scene->loader, scene->renderer, ELEVATOR_UPLOADS_PER_FRAME);
+    texture_cache_pump(scene->textures);
+    swap_reloaded(scene);
+    retire_minigame(scene);
+    SDL_UnlockMutex(scene->game_lock);
+}
+
+void elevator_scene_update(ElevatorScene *scene, float delta_s)
+{
+    if (!scene || scene->sim_thread)
+        return;
+    /* Deliver finished background loads, then simulate. */
+    asset_loader_pump(scene->loader, scene->renderer, ELEVATOR_UPLOADS_PER_FRAME);
+    texture_cache_pump(scene->textures);
+    swap_reloaded(scene);
+    retire_minigame(scene);
+    advance(scene, delta_s);
+}
+
+/* Draw primitives: the SDL renderer, or the software rasterizer when attached. */
+static void fill_rect(ElevatorScene *scene, const SDL_Rect *rect, Uint8 r, Uint8 g, Uint8 b)
+{
+    if (scene->soft) {
+        soft_renderer_fill_rect(scene->soft, rect, r, g, b, 255);
         return;
     }
+    SDL_SetRenderDrawColor(scene->renderer, r, g, b, 255);
+    SDL_RenderFillRect(scene->renderer, rect);
+}
 
-    /* DOORS_OPENING: advance through 10 frames, then sit on minigame (don't return to idle) */
-    scene->anim_timer += delta_s;
-    while (scene->anim_timer >= ELEVATOR_OPEN_FRAME_TIME) {
-        scene->anim_timer -= ELEVATOR_OPEN_FRAME_TIME;
-        scene->anim_frame++;
-        if (scene->anim_frame >= ELEVATOR_OPEN_FRAMES) {
-            scene->anim_frame = ELEVATOR_OPEN_FRAMES - 1;
-            scene->state = ELEVATOR_STATE_MINIGAME;
-            scene->minigame_timer = BOMB_TIMER_DURATION;
-            if (scene->minigame_music)
-                Mix_PlayMusic(scene->minigame_music, 0);
-            break;
-        }
+/* Batch layers, back to front. */
+enum {
+    SPRITE_LAYER_BACKDROP,
+    SPRITE_LAYER_DOORS,
+    SPRITE_LAYER_OVERLAY,
+};
+
+/* Queues the sprite in the batch; flush_sprites draws it. */
+static void draw_sprite(ElevatorScene *scene, const Sprite *sprite, const SDL_Rect *dst, int layer)
+{
+    static const SDL_Color opaque = { 255, 255, 255, 255 };
+    SDL_Rect d;
+    if (scene->soft) {
+        if (sprite_dest_rect(sprite, dst, &d) == 0)
+            soft_renderer_copy(scene->soft, sprite->texture, &sprite->src, &d, 255, 255, 255);
+    } else if (!scene->batch || sprite_batch_add_sprite(scene->batch, sprite, dst, SDL_FLIP_NONE, opaque, layer) != 0) {
+        sprite_draw(scene->renderer, sprite, dst);
+    }
+}
+
+/* Submits queued sprites; needed before anything drawn outside the batch
+ * (fills, text, layer copies) that must land on top of them. */
+static void flush_sprites(ElevatorScene *scene)
+{
+    sprite_batch_flush(scene->batch);
+}
+
+static void draw_loading(ElevatorScene *scene)
+{
+    int win_w = scene->window_w > 0 ? scene->window_w : 1;
+    int win_h = scene->window_h > 0 ? scene->window_h : 1;
+    SDL_Rect dst = { 0, 0, win_w, win_h };
+    fill_rect(scene, &dst, 0, 0, 0);
+
+    text_atlas_draw_centered(scene->text, scene->load_failed ? "Load failed" : "Loading",
+                             win_w / 2, win_h / 2 - 8, 255, 255, 255);
+
+    int done, total;
+    asset_loader_progress(scene->loader, &done, &total);
+    SDL_Rect bar = { win_w / 4, win_h / 2 + 8, win_w / 2, 4 };
+    fill_rect(scene, &bar, 80, 80, 80);
+    if (total > 0) {
+        bar.w = bar.w * done / total;
+        fill_rect(scene, &bar, 255, 255, 255);
     }
 }
 
+static void draw_backdrop(ElevatorScene *scene, const SDL_Rect *dst)
+{
+    fill_rect(scene, dst, 0, 0, 0);
+    draw_sprite(scene, &scene->mug_shot_sprite, dst, SPRITE_LAYER_BACKDROP);
+    flush_sprites(scene);
+}
+
+static void draw_hud(ElevatorScene *scene)
+{
+    char buf[32];
+    (void)snprintf(buf, sizeof buf, "Floor %d", scene->hud_floor);
+    text_atlas_draw(scene->text, buf, 8, 8, 255, 255, 255);
+    (void)snprintf(buf, sizeof buf, "Lives: %d", scene->hud_lives);
+    text_atlas_draw(scene->text, buf, 8, 24, 255, 255, 255);
+}
+
+/* Where the draw falls between the snapshot's update and the next one. */
+static float snapshot_alpha(const ElevatorScene *scene, const ElevatorSnapshot *snap)
+{
+    if (!scene->sim_thread)
+        return scene->render_alpha;
+    double age = (double)(SDL_GetPerformanceCounter() - snap->published) / (double)SDL_GetPerformanceFrequency();
+    float alpha = (float)(age / scene->sim_tick_s);
+    return alpha > 1.0f ? 1.0f : alpha;
+}
+
 void elevator_scene_draw(ElevatorScene *scene)
 {
-    if (!scene || !scene->sprite_sheet)
+    if (!scene)
+        return;
+    /* Everything the simulation owns comes from the snapshot, so the sim
+     * thread can run the next update while this one is drawn. */
+    const ElevatorSnapshot *snap = latest(scene);
+    texture_cache_frame(scene->textures);
+    if (snap->input_seq != scene->drawn_seq) {
+        scene->drawn_seq = snap->input_seq;
+        scene->shown_input = snap->input_time;
+    }
+    if (snap->state == ELEVATOR_STATE_LOADING) {
+        draw_loading(scene);
+        return;
+    }
+    if (!scene->next_sprites[0].texture)
         return;
 
-    SDL_Renderer *r = scene->renderer;
     int win_w = scene->window_w;
     int win_h = scene->window_h;
     if (win_w <= 0) win_w = 1;
@@ -280,33 +1066,34 @@ void elevator_scene_draw(ElevatorScene *scene)
 
     SDL_Rect dst = { .x = 0, .y = 0, .w = win_w, .h = win_h };
 
-    if (scene->state == ELEVATOR_STATE_DOORS_OPENING || scene->state == ELEVATOR_STATE_MINIGAME || scene->state == ELEVATOR_STATE_DOORS_CLOSING) {
+    if (snap->state == ELEVATOR_STATE_DOORS_OPENING || snap->state == ELEVATOR_STATE_MINIGAME || snap->state == ELEVATOR_STATE_DOORS_CLOSING) {
         /* Black background + mug shot overlay (visible during doors opening, minigame, and doors closing). */
-        SDL_SetRenderDrawColor(r, 0, 0, 0, 255);
-        SDL_RenderFillRect(r, &dst);
-        if (scene->mug_shot_sheet) {
-            SDL_Rect mug_src = { MUG_SHOT_SRC_X, MUG_SHOT_SRC_Y, MUG_SHOT_SRC_W, MUG_SHOT_SRC_H };
-            SDL_RenderCopy(r, scene->mug_shot_sheet, &mug_src, &dst);
+        /* The software path has no render targets; it redraws the backdrop. */
+        if (!scene->soft && render_layer_begin(scene->backdrop_layer, win_w, win_h)) {
+            draw_backdrop(scene, &dst);
+            render_layer_end(scene->backdrop_layer);
         }
-        /* Doors opening or closing: draw door sprite (opening = frame 0→9, closing = frame 9→0). */
-        if (scene->state == ELEVATOR_STATE_DOORS_OPENING || scene->state == ELEVATOR_STATE_DOORS_CLOSING) {
-            int frame = scene->anim_frame;
-            if (frame < 0) frame = 0;
-            if (frame >= ELEVATOR_OPEN_FRAMES) frame = ELEVATOR_OPEN_FRAMES - 1;
-            SDL_Rect src = ELEVATOR_OPEN_RECTS[frame];
-            SDL_RenderCopy(r, scene->sprite_sheet, &src, &dst);
+        if (scene->soft || !render_layer_draw(scene->backdrop_layer, &dst))
+            draw_backdrop(scene, &dst);
+        /* The game plays on the backdrop, under the fuse. */
+        if (snap->state == ELEVATOR_STATE_MINIGAME) {
+            /* The game's state is live: hold the sim thread off it. */
+            SDL_LockMutex(scene->game_lock);
+            if (scene->state == ELEVATOR_STATE_MINIGAME && scene->game_state)
+                scene->game->draw(scene->game_state, &scene->game_ctx);
+            SDL_UnlockMutex(scene->game_lock);
+            flush_sprites(scene);
         }
+        /* Doors opening or closing: draw door sprite (opening = frame 0→9, closing = frame 9→0). */
+        if (snap->state == ELEVATOR_STATE_DOORS_OPENING || snap->state == ELEVATOR_STATE_DOORS_CLOSING)
+            draw_sprite(scene, snap->doors, &dst, SPRITE_LAYER_DOORS);
         /* During minigame: draw bomb timer (rope shortens over 3s, then explosion). */
-        if (scene->state == ELEVATOR_STATE_MINIGAME && scene->bomb_timer_sheet && scene->minigame_timer > 0.0f) {
-            float t = BOMB_TIMER_DURATION - scene->minigame_timer;
+        float timer = snap->prev_minigame_timer +
+                      (snap->minigame_timer - snap->prev_minigame_timer) * snapshot_alpha(scene, snap);
+        if (snap->state == ELEVATOR_STATE_MINIGAME && timer > 0.0f) {
+            float t = BOMB_TIMER_DURATION - timer;
             int frame = (int)(t / BOMB_TIMER_DURATION * (float)BOMB_TIMER_FRAMES);
             if (frame >= BOMB_TIMER_FRAMES) frame = BOMB_TIMER_FRAMES - 1;
-            SDL_Rect bomb_src = {
-                .x = frame * BOMB_TIMER_FRAME_W,
-                .y = 0,
-                .w = BOMB_TIMER_FRAME_W,
-                .h = BOMB_TIMER_FRAME_H
-            };
             /* Draw bomb timer in top-right corner, scaled to fit. */
             SDL_Rect bomb_dst = {
                 .x = win_w - BOMB_TIMER_FRAME_W,
@@ -314,48 +1101,465 @@ void elevator_scene_draw(ElevatorScene *scene)
                 .w = BOMB_TIMER_FRAME_W,
                 .h = BOMB_TIMER_FRAME_H
             };
-            SDL_RenderCopy(r, scene->bomb_timer_sheet, &bomb_src, &bomb_dst);
+            draw_sprite(scene, &scene->bomb_sprites[frame], &bomb_dst, SPRITE_LAYER_OVERLAY);
         }
     } else {
         /* Idle: just the elevator sprite. */
-        int frame = scene->anim_frame;
-        if (frame < 0) frame = 0;
-        if (frame >= ELEVATOR_NEXT_FRAMES) frame = ELEVATOR_NEXT_FRAMES - 1;
-        SDL_Rect src = ELEVATOR_SRC_RECTS[frame];
-        SDL_RenderCopy(r, scene->sprite_sheet, &src, &dst);
+        draw_sprite(scene, snap->doors, &dst, SPRITE_LAYER_DOORS);
     }
+    flush_sprites(scene);
+
+    if (snap->state == ELEVATOR_STATE_DOORS_OPENING && snap->game && snap->game->prompt)
+        text_atlas_draw_centered(scene->text, snap->game->prompt, win_w / 2, win_h / 2, 255, 255, 255);
 
     /* Floor and lives only visible in elevator idle. */
-    if (scene->font && scene->state == ELEVATOR_STATE_IDLE) {
-        char buf[32];
-        (void)snprintf(buf, sizeof buf, "Floor %d", scene->current_floor);
-        draw_text(r, scene->font, buf, 8, 8, 255, 255, 255);
-        (void)snprintf(buf, sizeof buf, "Lives: %d", scene->lives);
-        draw_text(r, scene->font, buf, 8, 24, 255, 255, 255);
+    if (scene->text && snap->state == ELEVATOR_STATE_IDLE) {
+        if (scene->hud_floor != snap->floor || scene->hud_lives != snap->lives) {
+            render_layer_invalidate(scene->hud_layer);
+            scene->hud_floor = snap->floor;
+            scene->hud_lives = snap->lives;
+        }
+        if (!scene->soft && render_layer_begin(scene->hud_layer, win_w, win_h)) {
+            draw_hud(scene);
+            render_layer_end(scene->hud_layer);
+        }
+        if (scene->soft || !render_layer_draw(scene->hud_layer, &dst))
+            draw_hud(scene);
     }
 }
 
 void elevator_scene_set_window_size(ElevatorScene *scene, int w, int h)
 {
-    if (scene) {
+    /* Written only on change: a minigame being set up reads the size. */
+    if (scene && (scene->window_w != w || scene->window_h != h)) {
         scene->window_w = w;
         scene->window_h = h;
     }
 }
 
-bool elevator_scene_process_event(ElevatorScene *scene, const SDL_Event *event)
+void elevator_scene_set_render_alpha(ElevatorScene *scene, float alpha)
 {
-    if (event->type == SDL_QUIT)
+    if (scene)
+        scene->render_alpha = alpha < 0.0f ? 0.0f : alpha > 1.0f ? 1.0f : alpha;
+}
+
+static float sim_next_change(const ElevatorScene *scene)
+{
+    /* Background loads still need pumping every update. */
+    int done, total;
+    asset_loader_progress(scene->loader, &done, &total);
+    if (done < total)
+        return 0.0f;
+
+    switch (scene->state) {
+    case ELEVATOR_STATE_IDLE:
+    case ELEVATOR_STATE_DOORS_OPENING:
+    case ELEVATOR_STATE_DOORS_CLOSING:
+        /* 0 once the doors are open: holding polls the prefetch every update. */
+        return anim_next_change(scene->anims, scene->doors);
+    default:
+        return 0.0f;
+    }
+}
+
+float elevator_scene_next_change(ElevatorScene *scene)
+{
+    if (!scene)
+        return -1.0f;
+    if (!scene->sim_thread)
+        return sim_next_change(scene);
+    /* Threaded: the sim keeps ticking regardless, but the picture only
+     * changes when it publishes, so never sleep past the next tick. */
+    const ElevatorSnapshot *snap = latest(scene);
+    float age = (float)((double)(SDL_GetPerformanceCounter() - snap->published) / (double)SDL_GetPerformanceFrequency());
+    float left = snap->next_change - age;
+    if (snap->next_change < 0.0f || left > scene->sim_tick_s)
+        left = scene->sim_tick_s;
+    return left > 0.0f ? left : 0.0f;
+}
+
+/* The simulation's own fields while the caller runs it, the last snapshot
+ * taken while the sim thread does. */
+bool elevator_scene_is_loading(const ElevatorScene *scene)
+{
+    if (!scene)
+        return false;
+    return (scene->sim_thread ? scene->view->state : scene->state) == ELEVATOR_STATE_LOADING;
+}
+
+bool elevator_scene_load_failed(const ElevatorScene *scene)
+{
+    /* A sheet that fails later (a hot reload) leaves the old one up. */
+    return scene && scene->load_failed && !scene->next_sprites[0].texture;
+}
+
+int elevator_scene_get_floor(const ElevatorScene *scene)
+{
+    if (!scene)
+        return 0;
+    return scene->sim_thread ? scene->view->floor : scene->current_floor;
+}
+
+int elevator_scene_get_lives(const ElevatorScene *scene)
+{
+    if (!scene)
+        return 0;
+    return scene->sim_thread ? scene->view->lives : scene->lives;
+}
+
+void elevator_scene_get_text_stats(const ElevatorScene *scene, TextStats *out)
+{
+    text_atlas_get_stats(scene ? scene->text : NULL, out);
+}
+
+void elevator_scene_get_batch_stats(const ElevatorScene *scene, SpriteBatchStats *out)
+{
+    sprite_batch_get_stats(scene ? scene->batch : NULL, out);
+}
+
+void elevator_scene_get_sound_latency(const ElevatorScene *scene, SoundLatencyStats *out)
+{
+    sound_bank_get_latency(scene ? scene->sounds : NULL, out);
+}
+
+/* Loader hook: keep a CPU copy of every image for the software rasterizer.
+ * Loader images are premultiplied (keyed, or the atlas tool's output). */
+static void on_image_uploaded(void *user, SDL_Texture *texture, const SDL_Surface *pixels)
+{
+    ElevatorScene *scene = user;
+    if (soft_renderer_add_image(scene->soft, texture, pixels->pixels, pixels->w, pixels->h, pixels->pitch, 1) != 0)
+        fprintf(stderr, "soft renderer: cannot copy a %dx%d image\n", pixels->w, pixels->h);
+}
+
+int elevator_scene_set_soft_renderer(ElevatorScene *scene, SoftRenderer *soft)
+{
+    if (!scene)
+        return -1;
+    scene->soft = soft;
+    asset_loader_set_upload_hook(scene->loader, soft ? on_image_uploaded : NULL, scene);
+    texture_cache_set_soft_renderer(scene->textures, soft);
+    if (!soft)
+        return text_atlas_set_soft_renderer(scene->text, NULL);
+
+    /* Already on the GPU: the text sheet and a packed atlas (still mapped). */
+    if (scene->text && text_atlas_set_soft_renderer(scene->text, soft) != 0)
+        return -1;
+    const PackEntry *entry = asset_pack_find(scene->pack, "atlas", PACK_ENTRY_RGBA);
+    if (scene->atlas && entry && scene->next_sprites[0].texture) {
+        int w = (int)entry->a, h = (int)entry->b;
+        if (soft_renderer_add_image(soft, scene->next_sprites[0].texture, asset_pack_data(scene->pack, entry),
+                                    w, h, w * 4, 1) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+void elevator_scene_set_audio_clock(ElevatorScene *scene, AudioClock *clock)
+{
+    if (scene)
+        scene->clock = clock;
+}
+
+void elevator_scene_get_audio_drift(const ElevatorScene *scene, AudioDriftStats *out)
+{
+    if (!out)
+        return;
+    *out = scene ? scene->drift : (AudioDriftStats){ 0 };
+}
+
+/* Input the simulation reacts to; everything else stays on the main thread. */
+static bool is_input(const SDL_Event *event)
+{
+    switch (event->type) {
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+    case SDL_MOUSEMOTION:
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        return true;
+    default:
         return false;
+    }
+}
+
+/* Main thread. Drops the event if the sim thread has fallen a whole queue behind. */
+static void push_input(ElevatorScene *scene, const SDL_Event *event)
+{
+    int head = SDL_AtomicGet(&scene->input_head);
+    int next = (head + 1) % ELEVATOR_INPUT_QUEUE;
+    int tail = SDL_AtomicGet(&scene->input_tail);
+    SDL_MemoryBarrierAcquire();  /* the sim thread is done with the slot */
+    if (next == tail)
+        return;
+    scene->input[head] = *event;
+    SDL_MemoryBarrierRelease();  /* the event is visible before the index */
+    SDL_AtomicSet(&scene->input_head, next);
+}
+
+/* Sim thread. Returns false once the queue is empty. */
+static bool pop_input(ElevatorScene *scene, SDL_Event *out)
+{
+    int tail = SDL_AtomicGet(&scene->input_tail);
+    int head = SDL_AtomicGet(&scene->input_head);
+    SDL_MemoryBarrierAcquire();  /* see the event push_input stored */
+    if (tail == head)
+        return false;
+    *out = scene->input[tail];
+    SDL_MemoryBarrierRelease();  /* the copy is done before the slot is freed */
+    SDL_AtomicSet(&scene->input_tail, (tail + 1) % ELEVATOR_INPUT_QUEUE);
+    return true;
+}
+
+/* Input's effect on the simulation, on whichever thread owns it. */
+static void apply_event(ElevatorScene *scene, const SDL_Event *event)
+{
+    bool press = (event->type == SDL_KEYDOWN && !event->key.repeat) || event->type == SDL_MOUSEBUTTONDOWN;
+    bool acted = false;
+    /* Input during loading changes nothing, and its tick isn't reproducible. */
+    if (scene->recorder && scene->state != ELEVATOR_STATE_LOADING)
+        replay_writer_event(scene->recorder, scene->tick, event);
+    if (scene->state == ELEVATOR_STATE_MINIGAME && scene->game_state && scene->game->event) {
+        scene->game->event(scene->game_state, event);
+        acted = press;
+    }
     if (event->type == SDL_KEYDOWN) {
-        if (event->key.keysym.sym == SDLK_ESCAPE)
-            return false;
         /* Spacebar: start doors-opening animation only from idle. */
         if (event->key.keysym.sym == SDLK_SPACE && scene->state == ELEVATOR_STATE_IDLE) {
+            acted = true;
             scene->state = ELEVATOR_STATE_DOORS_OPENING;
-            scene->anim_frame = 0;
-            scene->anim_timer = 0.0f;
+            anim_play(scene->anims, scene->doors, &scene->open_clip);
+            sound_bank_play(scene->sounds, SOUND_NEXT);
+            start_prefetch(scene);
+        }
+    }
+    /* Tagged for input-to-present latency; the next snapshot carries it. */
+    if (acted) {
+        scene->input_time = input_latency_event_time(event);
+        scene->input_seq++;
+    }
+}
+
+static int sim_main(void *data)
+{
+    ElevatorScene *scene = data;
+    Uint64 freq = SDL_GetPerformanceFrequency();
+    Uint64 tick = (Uint64)((double)scene->sim_tick_s * (double)freq);
+    Uint64 max_behind = (Uint64)(ELEVATOR_SIM_MAX_CATCHUP_S * (double)freq);
+    Uint64 next = SDL_GetPerformanceCounter();
+    SDL_Event event;
+
+    while (!SDL_AtomicGet(&scene->sim_quit)) {
+        /* Input is applied at the start of the tick after it arrives, however
+         * long the main thread spends drawing or presenting. */
+        SDL_LockMutex(scene->game_lock);
+        while (pop_input(scene, &event))
+            apply_event(scene, &event);
+        advance(scene, scene->sim_tick_s);
+        SDL_UnlockMutex(scene->game_lock);
+
+        next += tick;
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (now > next + max_behind)
+            next = now - max_behind;  /* stalled: replay at most the cap */
+        else if (next > now)
+            SDL_Delay((Uint32)((next - now) * 1000 / freq));
+    }
+    return 0;
+}
+
+int elevator_scene_start_sim_thread(ElevatorScene *scene, float tick_s)
+{
+    if (!scene || scene->sim_thread || tick_s <= 0.0f || scene->state == ELEVATOR_STATE_LOADING)
+        return -1;
+    scene->sim_tick_s = tick_s;
+    SDL_AtomicSet(&scene->sim_quit, 0);
+    SDL_AtomicSet(&scene->input_head, 0);
+    SDL_AtomicSet(&scene->input_tail, 0);
+    scene->sim_thread = SDL_CreateThread(sim_main, "elevator sim", scene);
+    if (!scene->sim_thread) {
+        fprintf(stderr, "SDL_CreateThread (sim): %s\n", SDL_GetError());
+        return -1;
+    }
+    return 0;
+}
+
+void elevator_scene_stop_sim_thread(ElevatorScene *scene)
+{
+    if (!scene || !scene->sim_thread)
+        return;
+    SDL_AtomicSet(&scene->sim_quit, 1);
+    SDL_WaitThread(scene->sim_thread, NULL);
+    scene->sim_thread = NULL;
+}
+
+bool elevator_scene_process_event(ElevatorScene *scene, const SDL_Event *event)
+{
+    /* Some backends (Direct3D) drop target contents on device loss. */
+    if (event->type == SDL_RENDER_TARGETS_RESET || event->type == SDL_RENDER_DEVICE_RESET) {
+        render_layer_invalidate(scene->backdrop_layer);
+        render_layer_invalidate(scene->hud_layer);
+    }
+    if (event->type == SDL_QUIT)
+        return false;
+    if (event->type == SDL_KEYDOWN && event->key.keysym.sym == SDLK_ESCAPE)
+        return false;
+    if (SDL_AtomicGet(&scene->paused) && is_input(event))
+        return true;
+    if (!scene->sim_thread)
+        apply_event(scene, event);
+    else if (is_input(event))
+        push_input(scene, event);
+    return true;
+}
+
+static bool reload_asset(ElevatorScene *scene, const char *path)
+{
+    if (scene->state == ELEVATOR_STATE_LOADING)
+        return false;
+    /* Sheets only matter while some sprite uses them; the atlas files only
+     * while the atlas is in use. Any sheet can take over from the atlas. */
+    AssetRequest req = { .kind = ASSET_FILE, .on_ready = on_asset_ready, .user = scene };
+    if (strcmp(path, ELEVATOR_SHEET_PATH) == 0) {
+        return submit_image(scene, ASSET_TAG_ELEVATOR | ASSET_TAG_RELOAD, path, &ELEVATOR_CHROMA) == 0;
+    } else if (strcmp(path, MUG_SHOT_SHEET_PATH) == 0) {
+        return submit_image(scene, ASSET_TAG_MUG_SHOT | ASSET_TAG_RELOAD, path, &MUG_SHOT_CHROMA) == 0;
+    } else if (strcmp(path, BOMB_TIMER_SHEET_PATH) == 0) {
+        return submit_image(scene, ASSET_TAG_BOMB_TIMER | ASSET_TAG_RELOAD, path, &BOMB_TIMER_CHROMA) == 0;
+    } else if (scene->atlas && (strcmp(path, ELEVATOR_ATLAS_PNG) == 0 || strcmp(path, ELEVATOR_ATLAS_INDEX) == 0)) {
+        if (scene->atlas_reloading) {
+            scene->atlas_changed = true;
+            return true;
         }
+        submit_atlas_reload(scene);
+        return scene->atlas_reloading;
+    } else if (strcmp(path, MINIGAME_MUSIC_PATH) == 0) {
+        return music_player_reload(scene->music, path) == 0;
+    } else if (strcmp(path, ELEVATOR_FONT_PATH) == 0) {
+        req.tag = ASSET_TAG_FONT | ASSET_TAG_RELOAD;
+        (void)snprintf(req.path, sizeof req.path, "%s", path);
+        return asset_loader_submit(scene->loader, &req) == 0;
+    } else if (texture_cache_reload(scene->textures, path)) {
+        return true;  /* a minigame's sheet */
+    } else {
+        return sound_bank_reload(scene->sounds, scene->loader, path) == 0;
     }
     return true;
 }
+
+bool elevator_scene_reload_asset(ElevatorScene *scene, const char *path)
+{
+    if (!scene || !path)
+        return false;
+    /* State, the atlas and its reload flags are the sim thread's too. */
+    SDL_LockMutex(scene->game_lock);
+    bool ok = reload_asset(scene, path);
+    SDL_UnlockMutex(scene->game_lock);
+    return ok;
+}
+
+void elevator_scene_set_paused(ElevatorScene *scene, bool paused)
+{
+    if (!scene || SDL_AtomicGet(&scene->paused) == (int)paused)
+        return;
+    /* The audio device keeps counting while the music is held, so the
+     * minigame's start moves on by the pause and the fuse doesn't jump. */
+    SDL_LockMutex(scene->game_lock);
+    SDL_AtomicSet(&scene->paused, paused);
+    if (scene->clock) {
+        if (paused)
+            scene->pause_audio = audio_clock_now(scene->clock);
+        else
+            scene->minigame_audio_start += audio_clock_now(scene->clock) - scene->pause_audio;
+    }
+    SDL_UnlockMutex(scene->game_lock);
+    music_player_pause(scene->music, paused);
+    if (paused)
+        Mix_Pause(-1);
+    else
+        Mix_Resume(-1);
+}
+
+void elevator_scene_set_blocking_prefetch(ElevatorScene *scene, bool blocking)
+{
+    if (scene)
+        scene->blocking_prefetch = blocking;
+}
+
+const char *elevator_scene_get_minigame(const ElevatorScene *scene)
+{
+    if (!scene)
+        return NULL;
+    const MinigameDef *def = scene->game ? scene->game : scene->next_game;
+    return def ? def->name : NULL;
+}
+
+void elevator_scene_set_seed(ElevatorScene *scene, Uint32 seed)
+{
+    if (!scene)
+        return;
+    /* xorshift never leaves 0. */
+    scene->seed = seed ? seed : ELEVATOR_GAME_SEED;
+    scene->game_rng = scene->seed;
+    /* Already picked on arrival at idle: pick again, as that arrival would have. */
+    if (scene->next_game)
+        pick_next_game(scene);
+}
+
+Uint32 elevator_scene_get_seed(const ElevatorScene *scene)
+{
+    return scene ? scene->seed : 0;
+}
+
+Uint32 elevator_scene_get_tick(const ElevatorScene *scene)
+{
+    return scene ? scene->tick : 0;
+}
+
+void elevator_scene_set_recorder(ElevatorScene *scene, ReplayWriter *recorder)
+{
+    if (scene)
+        scene->recorder = recorder;
+}
+
+Uint64 elevator_scene_take_shown_input(ElevatorScene *scene)
+{
+    if (!scene)
+        return 0;
+    Uint64 t = scene->shown_input;
+    scene->shown_input = 0;
+    return t;
+}
+
+bool elevator_scene_is_steady(const ElevatorScene *scene)
+{
+    /* SDL_AtomicGet takes a non-const pointer but only reads. */
+    return scene && SDL_AtomicGet((SDL_atomic_t *)&scene->steady);
+}
+
+void elevator_scene_get_arena_stats(const ElevatorScene *scene, ArenaStats *game, ArenaStats *frame)
+{
+    arena_get_stats(scene ? scene->game_arena : NULL, game);
+    arena_get_stats(scene ? scene->frame_arena : NULL, frame);
+}
+
+void elevator_scene_set_texture_budget(ElevatorScene *scene, size_t budget_bytes)
+{
+    if (scene)
+        texture_cache_set_budget(scene->textures, budget_bytes);
+}
+
+void elevator_scene_get_texture_stats(const ElevatorScene *scene, TextureCacheStats *out)
+{
+    texture_cache_get_stats(scene ? scene->textures : NULL, out);
+}
+
+void elevator_scene_set_music_cache(ElevatorScene *scene, size_t cache_bytes)
+{
+    if (scene)
+        music_player_set_cache_size(scene->music, cache_bytes);
+}
+
+void elevator_scene_get_music_stats(const ElevatorScene *scene, MusicStats *out)
+{
+    music_player_get_stats(scene ? scene->music : NULL, out);
+}
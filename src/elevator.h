@@ -3,25 +3,160 @@
 
 #include <SDL.h>
 #include <stdbool.h>
+#include "arena.h"
+#include "audio_clock.h"
+#include "batch.h"
+#include "music.h"
+#include "replay.h"
+#include "softrender.h"
+#include "sound.h"
+#include "texcache.h"
+#include "text.h"
 
 typedef struct ElevatorScene ElevatorScene;
 
-/* Creates the elevator scene (loads sprites, etc.). Returns NULL on failure. */
+/* Creates the elevator scene. Returns quickly: sprites and music load in the
+ * background while the scene shows a loading screen. Returns NULL on failure. */
 ElevatorScene *elevator_scene_create(SDL_Renderer *renderer);
 
 /* Frees the elevator scene. */
 void elevator_scene_destroy(ElevatorScene *scene);
 
-/* Updates elevator state (animations, etc.). Delta in seconds. */
+/* Delivers finished background loads, then updates elevator state
+ * (animations, etc.). Delta in seconds. Does nothing while the sim thread
+ * runs. */
 void elevator_scene_update(ElevatorScene *scene, float delta_s);
 
-/* Draws the elevator scene to the current render target. */
+/* Draws the elevator scene to the current render target, from the latest
+ * snapshot the simulation published. */
 void elevator_scene_draw(ElevatorScene *scene);
 
+/* Runs the simulation on its own thread, one update every tick_s seconds,
+ * so a slow draw or present no longer delays input or game time. Events
+ * are still passed to process_event on the main thread, which also calls
+ * elevator_scene_pump and elevator_scene_draw each frame. Only once loading
+ * has finished. Returns 0 on success. */
+int elevator_scene_start_sim_thread(ElevatorScene *scene, float tick_s);
+
+/* Joins the sim thread; the caller owns the simulation again. Safe to call
+ * when it is not running. */
+void elevator_scene_stop_sim_thread(ElevatorScene *scene);
+
+/* Main thread, while the sim thread runs: uploads finished background loads. */
+void elevator_scene_pump(ElevatorScene *scene);
+
 /* Sets the window size for correct scaling. */
 void elevator_scene_set_window_size(ElevatorScene *scene, int w, int h);
 
+/* Hot reload, main thread: if path (as the scene names it, e.g.
+ * "assets/graphics/elevator.png") is a file the scene uses, decodes it again
+ * on a loader worker. The pump swaps the result in between frames, keeping
+ * the game state; new music takes over mid-play and the font waits for the
+ * minigame to end. Returns true if a reload was queued. */
+bool elevator_scene_reload_asset(ElevatorScene *scene, const char *path);
+
 /* Returns false when the game should quit. */
 bool elevator_scene_process_event(ElevatorScene *scene, const SDL_Event *event);
 
+/* After a draw: the event time (see input_latency_event_time) of the newest
+ * input that draw was first to show the effect of, or 0. Each input is
+ * returned once; the caller compares it with the present time. */
+Uint64 elevator_scene_take_shown_input(ElevatorScene *scene);
+
+/* Where the next draw falls between the last two updates (0..1). Continuous
+ * values such as the fuse are interpolated; 1, the default, draws the latest. */
+void elevator_scene_set_render_alpha(ElevatorScene *scene, float alpha);
+
+/* Seconds until the picture changes without input: 0 while it changes every
+ * update (minigame, loading), so callers can sleep instead of redrawing.
+ * With the sim thread running, at most one tick. */
+float elevator_scene_next_change(ElevatorScene *scene);
+
+/* True until the elevator sprites have finished loading. */
+bool elevator_scene_is_loading(const ElevatorScene *scene);
+
+/* True when the elevator sprites could not be loaded: the scene will never
+ * leave loading, so the caller should give up. Main thread. */
+bool elevator_scene_load_failed(const ElevatorScene *scene);
+
+/* Current floor and remaining lives (for HUDs, benchmarks and tests). */
+int elevator_scene_get_floor(const ElevatorScene *scene);
+int elevator_scene_get_lives(const ElevatorScene *scene);
+
+/* Text renderer counters; surfaces/uploads stay constant after create. */
+void elevator_scene_get_text_stats(const ElevatorScene *scene, TextStats *out);
+
+/* Sprite batch counters (quads and SDL_RenderGeometry calls); all zero on
+ * the software rasterizer path, which draws sprites one by one. */
+void elevator_scene_get_batch_stats(const ElevatorScene *scene, SpriteBatchStats *out);
+
+/* Sound-effect trigger-to-audible latency measured so far. */
+void elevator_scene_get_sound_latency(const ElevatorScene *scene, SoundLatencyStats *out);
+
+/* Draws through the software rasterizer instead of the SDL renderer (NULL
+ * switches back); the caller clears and presents it around
+ * elevator_scene_draw. Call right after create, before the first update, so
+ * every image is seen on its way in. Returns 0 on success. */
+int elevator_scene_set_soft_renderer(ElevatorScene *scene, SoftRenderer *soft);
+
+/* Drives minigame timing from the music's playback position instead of frame
+ * deltas. The clock must outlive the scene; NULL (the default) keeps the
+ * frame-delta timing, which is what deterministic runs want. */
+void elevator_scene_set_audio_clock(ElevatorScene *scene, AudioClock *clock);
+
+/* Game-clock vs audio-clock drift seen during minigames. Not while the sim
+ * thread runs. */
+void elevator_scene_get_audio_drift(const ElevatorScene *scene, AudioDriftStats *out);
+
+/* While the window is out of focus: holds the simulation, music and sound
+ * effects where they are and drops input. Loading carries on. Main thread. */
+void elevator_scene_set_paused(ElevatorScene *scene, bool paused);
+
+/* Each minigame is set up on a background thread while the doors open; if it
+ * is not ready by the last frame, the doors hold open until it is. Blocking
+ * mode waits inside that update instead, so the game starts on the same tick
+ * every run (benchmarks, frame checksums and replays). */
+void elevator_scene_set_blocking_prefetch(ElevatorScene *scene, bool blocking);
+
+/* Seeds the minigame picker; 0 restores the default. Call before the first
+ * minigame starts; the run then plays as if seeded from launch. */
+void elevator_scene_set_seed(ElevatorScene *scene, Uint32 seed);
+Uint32 elevator_scene_get_seed(const ElevatorScene *scene);
+
+/* Updates since loading finished. Input is recorded and replayed against
+ * this count, so a session replays the same whatever the frame rate. Not
+ * while the sim thread runs. */
+Uint32 elevator_scene_get_tick(const ElevatorScene *scene);
+
+/* Records every input the scene applies after loading (NULL stops). The
+ * writer must outlive the recording; for an exact replay, record with
+ * blocking prefetch and without an audio clock. */
+void elevator_scene_set_recorder(ElevatorScene *scene, ReplayWriter *recorder);
+
+/* Name of the minigame being played, or the one coming next. Reads the
+ * simulation directly: not while the sim thread runs. */
+const char *elevator_scene_get_minigame(const ElevatorScene *scene);
+
+/* True when the last updates ran in one state with no loads or minigame
+ * setup in flight: frames now should neither allocate nor create textures
+ * (checked with allocstats in debug builds). */
+bool elevator_scene_is_steady(const ElevatorScene *scene);
+
+/* Minigame arena (reset as the doors close) and per-update scratch arena.
+ * Not while the sim thread runs. */
+void elevator_scene_get_arena_stats(const ElevatorScene *scene, ArenaStats *game, ArenaStats *frame);
+
+/* GPU bytes minigame sheets may hold (0 = no limit); over it, the least
+ * recently drawn are evicted and reloaded when a game draws them again. */
+void elevator_scene_set_texture_budget(ElevatorScene *scene, size_t budget_bytes);
+
+/* Minigame texture cache hits, misses, evictions and resident bytes. */
+void elevator_scene_get_texture_stats(const ElevatorScene *scene, TextureCacheStats *out);
+
+/* Bytes of decoded music kept in memory (0 = no limit). */
+void elevator_scene_set_music_cache(ElevatorScene *scene, size_t cache_bytes);
+
+/* Music plays, cache hits, misses, evictions and decoded bytes held. */
+void elevator_scene_get_music_stats(const ElevatorScene *scene, MusicStats *out);
+
 #endif /* ELEVATOR_H */
@@ -0,0 +1,126 @@
+#include "framebuffer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct Framebuffer {
+    SDL_Renderer *renderer;
+    SDL_Texture  *native;
+    int           w;
+    int           h;
+    /* Sharp bilinear: the native image at an integer scale, kept between
+     * frames and recreated when the factor changes. */
+    SDL_Texture  *prescaled;
+    int           prescale;
+};
+
+static SDL_Texture *create_target(SDL_Renderer *renderer, int w, int h, SDL_ScaleMode scale)
+{
+    SDL_Texture *tex = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, w, h);
+    if (!tex) {
+        fprintf(stderr, "SDL_CreateTexture (framebuffer %dx%d): %s\n", w, h, SDL_GetError());
+        return NULL;
+    }
+    SDL_SetTextureScaleMode(tex, scale);
+    return tex;
+}
+
+Framebuffer *framebuffer_create(SDL_Renderer *renderer, int w, int h)
+{
+    if (!renderer || !SDL_RenderTargetSupported(renderer))
+        return NULL;
+    Framebuffer *fb = calloc(1, sizeof(Framebuffer));
+    if (!fb)
+        return NULL;
+    fb->renderer = renderer;
+    fb->w = w;
+    fb->h = h;
+    fb->native = create_target(renderer, w, h, SDL_ScaleModeNearest);
+    if (!fb->native) {
+        free(fb);
+        return NULL;
+    }
+    return fb;
+}
+
+void framebuffer_destroy(Framebuffer *fb)
+{
+    if (!fb)
+        return;
+    if (fb->prescaled)
+        SDL_DestroyTexture(fb->prescaled);
+    if (fb->native)
+        SDL_DestroyTexture(fb->native);
+    free(fb);
+}
+
+void framebuffer_begin(Framebuffer *fb)
+{
+    if (fb)
+        SDL_SetRenderTarget(fb->renderer, fb->native);
+}
+
+/* The native image scaled by `factor` with nearest, or NULL to fall back. */
+static SDL_Texture *prescale(Framebuffer *fb, int factor)
+{
+    if (factor != fb->prescale) {
+        if (fb->prescaled)
+            SDL_DestroyTexture(fb->prescaled);
+        fb->prescaled = create_target(fb->renderer, fb->w * factor, fb->h * factor, SDL_ScaleModeLinear);
+        fb->prescale = fb->prescaled ? factor : 0;
+    }
+    if (!fb->prescaled || SDL_SetRenderTarget(fb->renderer, fb->prescaled) != 0)
+        return NULL;
+    SDL_RenderCopy(fb->renderer, fb->native, NULL, NULL);
+    return fb->prescaled;
+}
+
+void framebuffer_present(Framebuffer *fb, UpscaleMode mode)
+{
+    if (!fb)
+        return;
+    int out_w = fb->w, out_h = fb->h;
+    SDL_SetRenderTarget(fb->renderer, NULL);
+    if (SDL_GetRendererOutputSize(fb->renderer, &out_w, &out_h) != 0 || out_w <= 0 || out_h <= 0)
+        return;
+
+    /* Fit the aspect ratio; integer mode rounds the factor down to a whole number. */
+    int fit_w = out_w, fit_h = out_w * fb->h / fb->w;
+    if (fit_h > out_h) {
+        fit_h = out_h;
+        fit_w = out_h * fb->w / fb->h;
+    }
+    int factor = fit_w / fb->w;
+    if (factor < 1)
+        factor = 1;
+    if (mode == UPSCALE_INTEGER && fit_w >= fb->w) {
+        fit_w = fb->w * factor;
+        fit_h = fb->h * factor;
+    }
+    SDL_Rect dst = { (out_w - fit_w) / 2, (out_h - fit_h) / 2, fit_w, fit_h };
+
+    SDL_Texture *src = fb->native;
+    if (mode == UPSCALE_SHARP_BILINEAR && factor > 1 && factor * fb->w != fit_w) {
+        src = prescale(fb, factor);
+        SDL_SetRenderTarget(fb->renderer, NULL);
+        if (!src)
+            src = fb->native;
+    }
+
+    SDL_SetRenderDrawColor(fb->renderer, 0, 0, 0, 255);
+    SDL_RenderClear(fb->renderer);
+    SDL_RenderCopy(fb->renderer, src, NULL, &dst);
+}
+
+int framebuffer_parse_mode(const char *name, UpscaleMode *out)
+{
+    if (strcmp(name, "integer") == 0)
+        *out = UPSCALE_INTEGER;
+    else if (strcmp(name, "nearest") == 0)
+        *out = UPSCALE_NEAREST;
+    else if (strcmp(name, "sharp") == 0)
+        *out = UPSCALE_SHARP_BILINEAR;
+    else
+        return -1;
+    return 0;
+}
@@ -0,0 +1,33 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include <SDL.h>
+
+/* How the native framebuffer is stretched to the window. Every mode keeps
+ * the aspect ratio and letterboxes the rest in black. */
+typedef enum {
+    UPSCALE_INTEGER,         /* largest whole multiple: pixel-perfect, may leave wide borders */
+    UPSCALE_NEAREST,         /* fill the window, nearest neighbour (uneven pixel widths) */
+    UPSCALE_SHARP_BILINEAR,  /* nearest to the largest whole multiple, then bilinear for the rest */
+} UpscaleMode;
+
+/* The game draws at its native resolution into one target texture, which is
+ * scaled to the window once per frame: draw cost no longer depends on the
+ * output size. */
+typedef struct Framebuffer Framebuffer;
+
+/* Returns NULL if the renderer has no render-target support. */
+Framebuffer *framebuffer_create(SDL_Renderer *renderer, int w, int h);
+
+void framebuffer_destroy(Framebuffer *fb);
+
+/* Makes the native texture the render target. */
+void framebuffer_begin(Framebuffer *fb);
+
+/* Switches back to the window, clears it and draws the native image scaled. */
+void framebuffer_present(Framebuffer *fb, UpscaleMode mode);
+
+/* Parses "integer", "nearest" or "sharp"; returns -1 for anything else. */
+int framebuffer_parse_mode(const char *name, UpscaleMode *out);
+
+#endif /* FRAMEBUFFER_H */
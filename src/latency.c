@@ -0,0 +1,95 @@
+#include "latency.h"
+#include <stdlib.h>
+
+/* Older timestamps are from before a stall or a clock wrap; the input is
+ * counted from when it was handled instead. */
+#define LATENCY_MAX_EVENT_AGE_MS  1000u
+
+struct InputLatency {
+    double *ring;     /* ms */
+    double *scratch;  /* sort buffer, capacity entries */
+    int     capacity;
+    Uint64  total;
+};
+
+InputLatency *input_latency_create(int capacity)
+{
+    if (capacity <= 0)
+        return NULL;
+    InputLatency *lat = calloc(1, sizeof(InputLatency));
+    if (!lat)
+        return NULL;
+    lat->ring = calloc((size_t)capacity, sizeof(double));
+    lat->scratch = calloc((size_t)capacity, sizeof(double));
+    if (!lat->ring || !lat->scratch) {
+        input_latency_destroy(lat);
+        return NULL;
+    }
+    lat->capacity = capacity;
+    return lat;
+}
+
+void input_latency_destroy(InputLatency *lat)
+{
+    if (!lat)
+        return;
+    free(lat->ring);
+    free(lat->scratch);
+    free(lat);
+}
+
+Uint64 input_latency_event_time(const SDL_Event *event)
+{
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint32 age_ms = SDL_GetTicks() - event->common.timestamp;
+    if (age_ms > LATENCY_MAX_EVENT_AGE_MS)
+        return now;
+    Uint64 age = (Uint64)age_ms * SDL_GetPerformanceFrequency() / 1000u;
+    return age < now ? now - age : now;
+}
+
+void input_latency_record(InputLatency *lat, Uint64 input_time, Uint64 presented)
+{
+    if (!lat || presented < input_time)
+        return;
+    double ms = (double)(presented - input_time) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+    lat->ring[lat->total % (Uint64)lat->capacity] = ms;
+    lat->total++;
+}
+
+static int compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted, int n, double p)
+{
+    int idx = (int)(p * (double)(n - 1) + 0.5);
+    return sorted[idx];
+}
+
+void input_latency_get_stats(InputLatency *lat, InputLatencyStats *out)
+{
+    if (!out)
+        return;
+    *out = (InputLatencyStats){ 0 };
+    if (!lat || lat->total == 0)
+        return;
+
+    int n = lat->total < (Uint64)lat->capacity ? (int)lat->total : lat->capacity;
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) {
+        lat->scratch[i] = lat->ring[i];
+        sum += lat->ring[i];
+    }
+    qsort(lat->scratch, (size_t)n, sizeof(double), compare_double);
+    out->samples = n;
+    out->total   = lat->total;
+    out->mean_ms = sum / (double)n;
+    out->min_ms  = lat->scratch[0];
+    out->p50_ms  = percentile(lat->scratch, n, 0.50);
+    out->p95_ms  = percentile(lat->scratch, n, 0.95);
+    out->p99_ms  = percentile(lat->scratch, n, 0.99);
+    out->max_ms  = lat->scratch[n - 1];
+}
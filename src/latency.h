@@ -0,0 +1,37 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <SDL.h>
+
+/* Input-to-present latency. An input is tagged with the performance-counter
+ * time of its SDL event; the first presented frame showing its effect
+ * records the difference. */
+typedef struct InputLatency InputLatency;
+
+typedef struct InputLatencyStats {
+    int    samples;  /* inputs currently held, up to capacity */
+    Uint64 total;    /* inputs recorded since create */
+    double mean_ms;
+    double min_ms;
+    double p50_ms;
+    double p95_ms;
+    double p99_ms;
+    double max_ms;
+} InputLatencyStats;
+
+/* Keeps the last `capacity` samples for percentiles. Returns NULL on failure. */
+InputLatency *input_latency_create(int capacity);
+
+void input_latency_destroy(InputLatency *lat);
+
+/* The event's SDL timestamp (milliseconds, stamped as SDL queued it) on the
+ * performance counter, so it can be compared with present times. */
+Uint64 input_latency_event_time(const SDL_Event *event);
+
+/* input_time: from input_latency_event_time. presented: counter right after
+ * SDL_RenderPresent returned for the first frame showing the input. */
+void input_latency_record(InputLatency *lat, Uint64 input_time, Uint64 presented);
+
+void input_latency_get_stats(InputLatency *lat, InputLatencyStats *out);
+
+#endif /* LATENCY_H */
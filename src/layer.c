@@ -0,0 +1,109 @@
+#include "layer.h"
+#include "chroma.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+struct RenderLayer {
+    SDL_Renderer *renderer;
+    SDL_Texture  *texture;
+    SDL_Texture  *prev_target;
+    int           w;
+    int           h;
+    bool          dirty;
+    LayerStats    stats;
+};
+
+RenderLayer *render_layer_create(SDL_Renderer *renderer)
+{
+    if (!renderer || !SDL_RenderTargetSupported(renderer))
+        return NULL;
+    RenderLayer *layer = calloc(1, sizeof(RenderLayer));
+    if (!layer)
+        return NULL;
+    layer->renderer = renderer;
+    layer->dirty = true;
+    return layer;
+}
+
+void render_layer_destroy(RenderLayer *layer)
+{
+    if (!layer)
+        return;
+    if (layer->texture)
+        SDL_DestroyTexture(layer->texture);
+    free(layer);
+}
+
+void render_layer_invalidate(RenderLayer *layer)
+{
+    if (layer)
+        layer->dirty = true;
+}
+
+static bool ensure_texture(RenderLayer *layer, int w, int h)
+{
+    if (layer->texture && layer->w == w && layer->h == h)
+        return true;
+    if (layer->texture)
+        SDL_DestroyTexture(layer->texture);
+    layer->texture = SDL_CreateTexture(layer->renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, w, h);
+    if (!layer->texture) {
+        fprintf(stderr, "SDL_CreateTexture (layer %dx%d): %s\n", w, h, SDL_GetError());
+        return false;
+    }
+    /* Content drawn onto transparent black ends up premultiplied. */
+    chroma_set_premultiplied_blend(layer->texture);
+    layer->w = w;
+    layer->h = h;
+    layer->dirty = true;
+    return true;
+}
+
+bool render_layer_begin(RenderLayer *layer, int w, int h)
+{
+    if (!layer || w <= 0 || h <= 0)
+        return false;
+    if (!ensure_texture(layer, w, h))
+        return false;
+    if (!layer->dirty)
+        return false;
+
+    layer->prev_target = SDL_GetRenderTarget(layer->renderer);
+    if (SDL_SetRenderTarget(layer->renderer, layer->texture) != 0) {
+        fprintf(stderr, "SDL_SetRenderTarget: %s\n", SDL_GetError());
+        return false;
+    }
+    SDL_BlendMode mode = SDL_BLENDMODE_NONE;
+    SDL_GetRenderDrawBlendMode(layer->renderer, &mode);
+    SDL_SetRenderDrawBlendMode(layer->renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(layer->renderer, 0, 0, 0, 0);
+    SDL_RenderClear(layer->renderer);
+    SDL_SetRenderDrawBlendMode(layer->renderer, mode);
+    return true;
+}
+
+void render_layer_end(RenderLayer *layer)
+{
+    if (!layer)
+        return;
+    SDL_SetRenderTarget(layer->renderer, layer->prev_target);
+    layer->prev_target = NULL;
+    layer->dirty = false;
+    layer->stats.rebuilds++;
+}
+
+bool render_layer_draw(RenderLayer *layer, const SDL_Rect *dst)
+{
+    if (!layer || !layer->texture || layer->dirty)
+        return false;
+    SDL_RenderCopy(layer->renderer, layer->texture, NULL, dst);
+    layer->stats.draws++;
+    return true;
+}
+
+void render_layer_get_stats(const RenderLayer *layer, LayerStats *out)
+{
+    if (!out)
+        return;
+    *out = layer ? layer->stats : (LayerStats){ 0 };
+}
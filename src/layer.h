@@ -0,0 +1,38 @@
+#ifndef LAYER_H
+#define LAYER_H
+
+#include <SDL.h>
+#include <stdbool.h>
+
+/* A cached layer: content composed once into a target texture and then
+ * drawn with a single copy until it is invalidated. */
+typedef struct RenderLayer RenderLayer;
+
+typedef struct LayerStats {
+    Uint64 rebuilds;  /* times the content was composed */
+    Uint64 draws;     /* single-copy draws */
+} LayerStats;
+
+/* Returns NULL if the renderer has no render-target support. */
+RenderLayer *render_layer_create(SDL_Renderer *renderer);
+
+void render_layer_destroy(RenderLayer *layer);
+
+/* Marks the content stale; the next render_layer_begin recomposes it. */
+void render_layer_invalidate(RenderLayer *layer);
+
+/* If the layer is stale or w×h differs from its size, makes it the render
+ * target, clears it to transparent and returns true: draw the content, then
+ * call render_layer_end. Returns false when the cached content is still good. */
+bool render_layer_begin(RenderLayer *layer, int w, int h);
+
+/* Restores the previous render target. */
+void render_layer_end(RenderLayer *layer);
+
+/* Copies the cached content to dst (NULL = whole target). Returns false if
+ * there is no valid content, in which case the caller draws directly. */
+bool render_layer_draw(RenderLayer *layer, const SDL_Rect *dst);
+
+void render_layer_get_stats(const RenderLayer *layer, LayerStats *out);
+
+#endif /* LAYER_H */
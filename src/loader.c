@@ -0,0 +1,292 @@
+#include "loader.h"
+#include <SDL_image.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LOADER_MAX_THREADS  4
+
+typedef struct AssetJob {
+    AssetRequest     req;
+    SDL_Surface     *surface;  /* ASSET_IMAGE: decoded, keyed, waiting for upload */
+    Mix_Music       *music;
+    Mix_Chunk       *chunk;
+    void            *data;
+    size_t           size;
+    struct AssetJob *next;
+} AssetJob;
+
+typedef struct {
+    AssetJob *head;
+    AssetJob *tail;
+} JobQueue;
+
+struct AssetLoader {
+    SDL_Thread *threads[LOADER_MAX_THREADS];
+    int         thread_count;
+    SDL_mutex  *lock;       /* guards pending, finished, quit, submitted */
+    SDL_cond   *wake;
+    JobQueue    pending;
+    JobQueue    finished;
+    int         quit;
+    int         submitted;
+    int         delivered;  /* render thread only */
+    AssetUploadFn upload_hook;
+    void         *upload_user;
+};
+
+static void queue_push(JobQueue *q, AssetJob *job)
+{
+    job->next = NULL;
+    if (q->tail)
+        q->tail->next = job;
+    else
+        q->head = job;
+    q->tail = job;
+}
+
+static AssetJob *queue_pop(JobQueue *q)
+{
+    AssetJob *job = q->head;
+    if (job) {
+        q->head = job->next;
+        if (!q->head)
+            q->tail = NULL;
+    }
+    return job;
+}
+
+/* Decodes to RGBA32 and bakes the chroma key into premultiplied alpha, so
+ * the render thread only has to upload. Unkeyed images are premultiplied
+ * already (the atlas tool writes them that way) unless the request says. */
+static SDL_Surface *decode_image(const AssetRequest *req)
+{
+    SDL_Surface *surf = IMG_Load(req->path);
+    if (!surf) {
+        fprintf(stderr, "Failed to load '%s': %s\n", req->path, IMG_GetError());
+        return NULL;
+    }
+    SDL_Surface *rgba = SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(surf);
+    if (!rgba) {
+        fprintf(stderr, "SDL_ConvertSurfaceFormat '%s': %s\n", req->path, SDL_GetError());
+        return NULL;
+    }
+    if (req->keyed)
+        chroma_key_apply(rgba->pixels, rgba->w, rgba->h, rgba->pitch, &req->key, 0);
+    else if (req->premultiply)
+        chroma_premultiply(rgba->pixels, rgba->w, rgba->h, rgba->pitch);
+    return rgba;
+}
+
+static void run_job(AssetJob *job)
+{
+    const AssetRequest *req = &job->req;
+    switch (req->kind) {
+    case ASSET_IMAGE:
+        job->surface = decode_image(req);
+        break;
+    case ASSET_MUSIC:
+        job->music = Mix_LoadMUS(req->path);
+        if (!job->music)
+            fprintf(stderr, "Mix_LoadMUS '%s': %s\n", req->path, Mix_GetError());
+        break;
+    case ASSET_CHUNK:
+        job->chunk = Mix_LoadWAV(req->path);
+        if (!job->chunk)
+            fprintf(stderr, "Mix_LoadWAV '%s': %s\n", req->path, Mix_GetError());
+        break;
+    case ASSET_FILE:
+        job->data = SDL_LoadFile(req->path, &job->size);
+        break;
+    }
+}
+
+static int worker_main(void *arg)
+{
+    AssetLoader *loader = arg;
+    SDL_LockMutex(loader->lock);
+    for (;;) {
+        while (!loader->quit && !loader->pending.head)
+            SDL_CondWait(loader->wake, loader->lock);
+        if (loader->quit)
+            break;
+        AssetJob *job = queue_pop(&loader->pending);
+        SDL_UnlockMutex(loader->lock);
+
+        run_job(job);
+
+        SDL_LockMutex(loader->lock);
+        queue_push(&loader->finished, job);
+    }
+    SDL_UnlockMutex(loader->lock);
+    return 0;
+}
+
+AssetLoader *asset_loader_create(int threads)
+{
+    if (threads <= 0)
+        threads = SDL_GetCPUCount() - 1;
+    if (threads < 1)
+        threads = 1;
+    if (threads > LOADER_MAX_THREADS)
+        threads = LOADER_MAX_THREADS;
+
+    AssetLoader *loader = calloc(1, sizeof(AssetLoader));
+    if (!loader)
+        return NULL;
+    loader->lock = SDL_CreateMutex();
+    loader->wake = SDL_CreateCond();
+    if (!loader->lock || !loader->wake) {
+        asset_loader_destroy(loader);
+        return NULL;
+    }
+    for (int i = 0; i < threads; i++) {
+        loader->threads[i] = SDL_CreateThread(worker_main, "asset-loader", loader);
+        if (!loader->threads[i]) {
+            fprintf(stderr, "SDL_CreateThread: %s\n", SDL_GetError());
+            break;
+        }
+        loader->thread_count++;
+    }
+    if (loader->thread_count == 0) {
+        asset_loader_destroy(loader);
+        return NULL;
+    }
+    return loader;
+}
+
+static void free_job(AssetJob *job)
+{
+    if (job->surface)
+        SDL_FreeSurface(job->surface);
+    if (job->music)
+        Mix_FreeMusic(job->music);
+    if (job->chunk)
+        Mix_FreeChunk(job->chunk);
+    SDL_free(job->data);
+    free(job);
+}
+
+void asset_loader_destroy(AssetLoader *loader)
+{
+    if (!loader)
+        return;
+    if (loader->lock) {
+        SDL_LockMutex(loader->lock);
+        loader->quit = 1;
+        SDL_CondBroadcast(loader->wake);
+        SDL_UnlockMutex(loader->lock);
+    }
+    for (int i = 0; i < loader->thread_count; i++)
+        SDL_WaitThread(loader->threads[i], NULL);
+
+    AssetJob *job;
+    while ((job = queue_pop(&loader->pending)) != NULL)
+        free_job(job);
+    while ((job = queue_pop(&loader->finished)) != NULL)
+        free_job(job);
+    if (loader->wake)
+        SDL_DestroyCond(loader->wake);
+    if (loader->lock)
+        SDL_DestroyMutex(loader->lock);
+    free(loader);
+}
+
+int asset_loader_submit(AssetLoader *loader, const AssetRequest *req)
+{
+    if (!loader || !req)
+        return -1;
+    AssetJob *job = calloc(1, sizeof(AssetJob));
+    if (!job)
+        return -1;
+    job->req = *req;
+    SDL_LockMutex(loader->lock);
+    queue_push(&loader->pending, job);
+    loader->submitted++;
+    SDL_CondSignal(loader->wake);
+    SDL_UnlockMutex(loader->lock);
+    return 0;
+}
+
+int asset_loader_pump(AssetLoader *loader, SDL_Renderer *renderer, int max_uploads)
+{
+    if (!loader)
+        return 0;
+
+    int uploads = 0;
+    for (;;) {
+        /* Leave images on the queue once this frame's upload budget is spent. */
+        SDL_LockMutex(loader->lock);
+        AssetJob *job = loader->finished.head;
+        if (job && job->surface && max_uploads > 0 && uploads >= max_uploads)
+            job = NULL;
+        else
+            job = queue_pop(&loader->finished);
+        SDL_UnlockMutex(loader->lock);
+        if (!job)
+            break;
+
+        AssetResult res = {
+            .kind = job->req.kind,
+            .path = job->req.path,
+            .tag  = job->req.tag,
+        };
+        if (job->surface) {
+            res.texture = SDL_CreateTextureFromSurface(renderer, job->surface);
+            if (res.texture) {
+                chroma_set_premultiplied_blend(res.texture);
+                if (loader->upload_hook)
+                    loader->upload_hook(loader->upload_user, res.texture, job->surface);
+            } else
+                fprintf(stderr, "SDL_CreateTextureFromSurface '%s': %s\n", job->req.path, SDL_GetError());
+            uploads++;
+        }
+        res.music = job->music;
+        res.chunk = job->chunk;
+        res.data  = job->data;
+        res.size  = job->size;
+        job->music = NULL;
+        job->chunk = NULL;
+        job->data  = NULL;
+
+        if (job->req.on_ready)
+            job->req.on_ready(job->req.user, &res);
+        else {
+            /* Nobody wants it: don't leak. */
+            if (res.texture) SDL_DestroyTexture(res.texture);
+            if (res.music) Mix_FreeMusic(res.music);
+            if (res.chunk) Mix_FreeChunk(res.chunk);
+            SDL_free(res.data);
+        }
+        loader->delivered++;
+        free_job(job);
+    }
+
+    SDL_LockMutex(loader->lock);
+    int in_flight = loader->submitted - loader->delivered;
+    SDL_UnlockMutex(loader->lock);
+    return in_flight;
+}
+
+void asset_loader_set_upload_hook(AssetLoader *loader, AssetUploadFn fn, void *user)
+{
+    if (!loader)
+        return;
+    loader->upload_hook = fn;
+    loader->upload_user = user;
+}
+
+void asset_loader_progress(const AssetLoader *loader, int *done, int *total)
+{
+    int d = 0, t = 0;
+    if (loader) {
+        SDL_LockMutex(loader->lock);
+        d = loader->delivered;
+        t = loader->submitted;
+        SDL_UnlockMutex(loader->lock);
+    }
+    if (done)
+        *done = d;
+    if (total)
+        *total = t;
+}
@@ -0,0 +1,71 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include "chroma.h"
+
+typedef enum {
+    ASSET_IMAGE,  /* PNG → texture; decode and keying on a worker, upload in pump */
+    ASSET_MUSIC,  /* Mix_Music opened on a worker */
+    ASSET_CHUNK,  /* sound decoded to PCM on a worker */
+    ASSET_FILE,   /* raw bytes (indexes, fonts) */
+} AssetKind;
+
+#define ASSET_PATH_MAX  256
+
+/* What a finished job hands back. Exactly the member matching kind is set,
+ * or none of them when loading failed. Ownership passes to the callback. */
+typedef struct AssetResult {
+    AssetKind    kind;
+    const char  *path;
+    int          tag;
+    SDL_Texture *texture;
+    Mix_Music   *music;
+    Mix_Chunk   *chunk;
+    void        *data;  /* ASSET_FILE: free with SDL_free */
+    size_t       size;
+} AssetResult;
+
+/* Runs on the thread calling asset_loader_pump. */
+typedef void (*AssetReadyFn)(void *user, const AssetResult *result);
+
+typedef struct AssetRequest {
+    AssetKind    kind;
+    char         path[ASSET_PATH_MAX];
+    int          tag;        /* caller's id, echoed back in the result */
+    int          keyed;      /* ASSET_IMAGE: apply key (output is premultiplied) */
+    ChromaKey    key;
+    int          premultiply;  /* ASSET_IMAGE, unkeyed: PNG has straight alpha */
+    AssetReadyFn on_ready;
+    void        *user;
+} AssetRequest;
+
+/* Sees each image's RGBA32 pixels right after upload, before they are freed
+ * (e.g. to keep a CPU copy). Runs in asset_loader_pump. */
+typedef void (*AssetUploadFn)(void *user, SDL_Texture *texture, const SDL_Surface *pixels);
+
+typedef struct AssetLoader AssetLoader;
+
+/* Starts `threads` decode workers (<= 0 picks from the CPU count).
+ * Returns NULL on failure. */
+AssetLoader *asset_loader_create(int threads);
+
+/* Stops the workers and frees any results that were never delivered.
+ * Destroy before whatever the callbacks write into. */
+void asset_loader_destroy(AssetLoader *loader);
+
+/* Queues a request; returns 0 on success. Safe from any thread. */
+int asset_loader_submit(AssetLoader *loader, const AssetRequest *req);
+
+/* Delivers finished jobs, creating at most max_uploads textures (<= 0 means
+ * no limit). Must run on the render thread. Returns jobs still in flight. */
+int asset_loader_pump(AssetLoader *loader, SDL_Renderer *renderer, int max_uploads);
+
+/* Installs (or with NULL removes) the upload hook. */
+void asset_loader_set_upload_hook(AssetLoader *loader, AssetUploadFn fn, void *user);
+
+/* Jobs submitted and jobs delivered so far (for progress bars). */
+void asset_loader_progress(const AssetLoader *loader, int *done, int *total);
+
+#endif /* LOADER_H */
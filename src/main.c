@@ -1,19 +1,72 @@
+#include "allocstats.h"
 #include "elevator.h"
+#include "framebuffer.h"
+#include "latency.h"
+#include "pacer.h"
+#include "profiler.h"
+#include "replay.h"
+#include "watch.h"
 #include <SDL.h>
 #include <SDL_image.h>
 #include <SDL_mixer.h>
 #include <SDL_ttf.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define WINDOW_TITLE   "WarioWare"
 #define WINDOW_WIDTH   240
 #define WINDOW_HEIGHT  160
 
+/* Mixer buffer in sample frames: default, and with --low-latency. */
+#define AUDIO_BUFFER_DEFAULT      1024
+#define AUDIO_BUFFER_LOW_LATENCY  256
+
+/* Fixed simulation step, and the most backlog replayed after a stall. */
+#define SIM_TICK_S         (1.0 / 60.0)
+#define SIM_MAX_CATCHUP_S  0.25
+
+/* Frames of phase timings kept for percentiles and export. */
+#define PROFILER_FRAMES  4096
+
+/* Input-to-present samples kept for percentiles. */
+#define LATENCY_SAMPLES  1024
+/* Late input sampling: slack left between the expected end of a frame's
+ * work and the vblank, and how fast the work estimate forgets a slow frame. */
+#define LATE_INPUT_MARGIN_S  0.002
+#define LATE_INPUT_DECAY     0.98
+
+/* --hot-reload: the tree watched, and the longest idle sleep between checks. */
+#define HOT_RELOAD_ROOT    "assets"
+#define HOT_RELOAD_POLL_S  0.02
+
+/* Debug builds: steady frames that allocate are reported, up to this many. */
+#define ALLOC_REPORTS  8
+
+typedef struct {
+    const char *profile_csv;    /* --profile-csv PATH: per-frame phase timings on exit */
+    const char *profile_trace;  /* --profile-trace PATH: Chrome trace JSON on exit */
+    int         audio_buffer;   /* --audio-buffer N / --low-latency: mixer buffer in sample frames */
+    UpscaleMode upscale;        /* --scale integer|nearest|sharp */
+    int         soft;           /* --soft: draw with the CPU rasterizer */
+    int         no_sim_thread;  /* --no-sim-thread: update on the main thread, between draws */
+    int         late_input;     /* --late-input: poll events as late before the next vblank as possible */
+    int         no_vsync;       /* --no-vsync: present immediately, paced by the frame limiter */
+    int         fps;            /* --fps N: frame limiter rate with --no-vsync; 0 follows the display */
+    int         gpu_sync;       /* --gpu-sync: let the driver queue no frames ahead */
+    const char *record;         /* --record PATH: save the session's input for replay */
+    const char *replay;         /* --replay PATH: play a recorded session instead of live input */
+    Uint32      seed;           /* --seed N: minigame picker seed; 0 keeps the scene's default */
+    int         hot_reload;     /* --hot-reload: reload assets as they change on disk */
+    int         texture_mb;     /* --texture-budget MB: minigame sheets on the GPU; -1 keeps the default */
+    int         music_mb;       /* --music-cache MB: decoded music in memory; -1 keeps the default */
+} Options;
+
 static SDL_Window   *g_window   = NULL;
 static SDL_Renderer *g_renderer = NULL;
+static Framebuffer  *g_framebuffer = NULL;  /* native 240×160 target; NULL uses logical size */
 
-static int init_sdl(void)
+static int init_sdl(int audio_buffer)
 {
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) != 0) {
         fprintf(stderr, "SDL_Init: %s\n", SDL_GetError());
@@ -38,7 +91,7 @@ static int init_sdl(void)
         SDL_Quit();
         return -1;
     }
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 1024) != 0) {
+    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, audio_buffer) != 0) {
         fprintf(stderr, "Mix_OpenAudio: %s\n", Mix_GetError());
         Mix_Quit();
         TTF_Quit();
@@ -58,7 +111,7 @@ static void quit_sdl(void)
     SDL_Quit();
 }
 
-static int create_window(void)
+static int create_window(int vsync)
 {
     g_window = SDL_CreateWindow(
         WINDOW_TITLE,
@@ -72,33 +125,153 @@ static int create_window(void)
         fprintf(stderr, "SDL_CreateWindow: %s\n", SDL_GetError());
         return -1;
     }
-    g_renderer = SDL_CreateRenderer(g_window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    g_renderer = SDL_CreateRenderer(g_window, -1, SDL_RENDERER_ACCELERATED | (vsync ? SDL_RENDERER_PRESENTVSYNC : 0));
     if (!g_renderer) {
         fprintf(stderr, "SDL_CreateRenderer: %s\n", SDL_GetError());
         SDL_DestroyWindow(g_window);
         g_window = NULL;
         return -1;
     }
-    /* 240×160 logical size so the game view is exact; content scales to window and isn't cut off. */
-    SDL_RenderSetLogicalSize(g_renderer, WINDOW_WIDTH, WINDOW_HEIGHT);
+    /* Draw at 240×160 and scale once to the window. Without render targets,
+     * fall back to a logical size, which scales every copy separately. */
+    g_framebuffer = framebuffer_create(g_renderer, WINDOW_WIDTH, WINDOW_HEIGHT);
+    if (!g_framebuffer)
+        SDL_RenderSetLogicalSize(g_renderer, WINDOW_WIDTH, WINDOW_HEIGHT);
+    return 0;
+}
+
+static int parse_args(int argc, char **argv, Options *opt)
+{
+    for (int i = 1; i < argc; i++) {
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(argv[i], "--profile-csv") == 0 && val)
+            opt->profile_csv = val;
+        else if (strcmp(argv[i], "--profile-trace") == 0 && val)
+            opt->profile_trace = val;
+        else if (strcmp(argv[i], "--audio-buffer") == 0 && val && atoi(val) > 0)
+            opt->audio_buffer = atoi(val);
+        else if (strcmp(argv[i], "--scale") == 0 && val) {
+            if (framebuffer_parse_mode(val, &opt->upscale) != 0) {
+                fprintf(stderr, "unknown --scale mode '%s' (integer, nearest or sharp)\n", val);
+                return -1;
+            }
+        } else if (strcmp(argv[i], "--fps") == 0 && val && atoi(val) > 0) {
+            opt->fps = atoi(val);
+        } else if (strcmp(argv[i], "--record") == 0 && val) {
+            opt->record = val;
+        } else if (strcmp(argv[i], "--replay") == 0 && val) {
+            opt->replay = val;
+        } else if (strcmp(argv[i], "--texture-budget") == 0 && val && atoi(val) >= 0) {
+            opt->texture_mb = atoi(val);
+        } else if (strcmp(argv[i], "--music-cache") == 0 && val && atoi(val) >= 0) {
+            opt->music_mb = atoi(val);
+        } else if (strcmp(argv[i], "--seed") == 0 && val) {
+            opt->seed = (Uint32)strtoul(val, NULL, 0);
+        } else if (strcmp(argv[i], "--low-latency") == 0) {
+            opt->audio_buffer = AUDIO_BUFFER_LOW_LATENCY;
+            opt->late_input = 1;
+            opt->gpu_sync = 1;
+            continue;
+        } else if (strcmp(argv[i], "--late-input") == 0) {
+            opt->late_input = 1;
+            continue;
+        } else if (strcmp(argv[i], "--no-vsync") == 0) {
+            opt->no_vsync = 1;
+            continue;
+        } else if (strcmp(argv[i], "--gpu-sync") == 0) {
+            opt->gpu_sync = 1;
+            continue;
+        } else if (strcmp(argv[i], "--soft") == 0) {
+            opt->soft = 1;
+            continue;
+        } else if (strcmp(argv[i], "--no-sim-thread") == 0) {
+            opt->no_sim_thread = 1;
+            continue;
+        } else if (strcmp(argv[i], "--hot-reload") == 0) {
+            opt->hot_reload = 1;
+            continue;
+        } else {
+            fprintf(stderr, "usage: %s [--profile-csv PATH] [--profile-trace PATH] [--audio-buffer N] [--low-latency]"
+                    " [--late-input] [--no-vsync] [--fps N] [--gpu-sync] [--record PATH | --replay PATH] [--seed N]"
+                    " [--scale integer|nearest|sharp] [--soft] [--no-sim-thread] [--hot-reload]"
+                    " [--texture-budget MB] [--music-cache MB]\n",
+                    argv[0]);
+            return -1;
+        }
+        i++;
+    }
+    if (opt->record && opt->replay) {
+        fprintf(stderr, "--record and --replay cannot be combined\n");
+        return -1;
+    }
     return 0;
 }
 
+/* Live key and mouse input is ignored while a replay plays; quitting still works. */
+static int replay_ignores(const SDL_Event *event)
+{
+    switch (event->type) {
+    case SDL_KEYDOWN:
+        return event->key.keysym.sym != SDLK_ESCAPE;
+    case SDL_KEYUP:
+    case SDL_MOUSEMOTION:
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/* One display refresh in performance-counter units; the sim tick if unknown. */
+static Uint64 frame_period(int fps)
+{
+    double hz = 1.0 / SIM_TICK_S;
+    SDL_DisplayMode mode;
+    if (fps > 0)
+        hz = fps;
+    else if (SDL_GetWindowDisplayMode(g_window, &mode) == 0 && mode.refresh_rate > 0)
+        hz = mode.refresh_rate;
+    return (Uint64)((double)SDL_GetPerformanceFrequency() / hz);
+}
+
 int main(int argc, char **argv)
 {
-    (void)argc;
-    (void)argv;
+    /* Time-to-first-frame is measured from here to the first present. */
+    Uint64 launch = SDL_GetPerformanceCounter();
 
-    if (init_sdl() != 0)
+    Options opt = { .audio_buffer = AUDIO_BUFFER_DEFAULT, .upscale = UPSCALE_INTEGER, .texture_mb = -1,
+                    .music_mb = -1 };
+    if (parse_args(argc, argv, &opt) != 0)
         return EXIT_FAILURE;
+    ReplayReader *replay = NULL;
+    if (opt.replay) {
+        if (!(replay = replay_reader_open(opt.replay)))
+            return EXIT_FAILURE;
+        opt.seed = replay_reader_seed(replay);
+    }
+    /* Replays step at the recorded tick. */
+    double tick_s = replay ? replay_reader_tick(replay) : SIM_TICK_S;
+
+    /* Debug builds count allocations per frame; hooks go in before SDL allocates. */
+    bool count_allocs = alloc_stats_install() == 0;
+    long steady_alloc_frames = 0;
 
-    if (create_window() != 0) {
+    if (init_sdl(opt.audio_buffer) != 0) {
+        replay_reader_close(replay);
+        return EXIT_FAILURE;
+    }
+
+    if (create_window(!opt.no_vsync) != 0) {
+        replay_reader_close(replay);
         quit_sdl();
         return EXIT_FAILURE;
     }
 
     ElevatorScene *elevator = elevator_scene_create(g_renderer);
     if (!elevator) {
+        replay_reader_close(replay);
+        framebuffer_destroy(g_framebuffer);
         SDL_DestroyRenderer(g_renderer);
         SDL_DestroyWindow(g_window);
         quit_sdl();
@@ -106,39 +279,333 @@ int main(int argc, char **argv)
     }
 
     elevator_scene_set_window_size(elevator, WINDOW_WIDTH, WINDOW_HEIGHT);
+    SoftRenderer *soft = NULL;
+    if (opt.soft) {
+        soft = soft_renderer_create(g_renderer, WINDOW_WIDTH, WINDOW_HEIGHT);
+        if (soft && elevator_scene_set_soft_renderer(elevator, soft) == 0) {
+            fprintf(stderr, "software rasterizer: %s kernels\n", soft_renderer_kernels(soft));
+        } else {
+            fprintf(stderr, "Failed to set up the software rasterizer; using the SDL renderer\n");
+            /* The scene may already hold it (set fails part-way). */
+            elevator_scene_set_soft_renderer(elevator, NULL);
+            soft_renderer_destroy(soft);
+            soft = NULL;
+        }
+    }
+    if (opt.seed)
+        elevator_scene_set_seed(elevator, opt.seed);
+    if (opt.texture_mb >= 0)
+        elevator_scene_set_texture_budget(elevator, (size_t)opt.texture_mb * 1024 * 1024);
+    if (opt.music_mb >= 0)
+        elevator_scene_set_music_cache(elevator, (size_t)opt.music_mb * 1024 * 1024);
+    /* Recorded sessions must replay tick for tick: minigames start on a
+     * fixed tick and time runs on ticks alone, not the music. */
+    ReplayWriter *recorder = NULL;
+    if (opt.record) {
+        recorder = replay_writer_open(opt.record, elevator_scene_get_seed(elevator), (float)tick_s);
+        if (!recorder)
+            fprintf(stderr, "Not recording\n");
+        elevator_scene_set_recorder(elevator, recorder);
+    }
+    AudioClock *audio_clock = audio_clock_create();
+    if (recorder || replay)
+        elevator_scene_set_blocking_prefetch(elevator, true);
+    else
+        elevator_scene_set_audio_clock(elevator, audio_clock);
+    AssetWatcher *watcher = opt.hot_reload ? asset_watcher_create(HOT_RELOAD_ROOT) : NULL;
+    Uint64 scene_ready = SDL_GetPerformanceCounter();
+    int first_frame = 1;
+    int assets_pending = 1;
+
+    Profiler *prof = profiler_create(PROFILER_FRAMES);
+    if (!prof)
+        fprintf(stderr, "Failed to create profiler\n");
+    int show_overlay = 0;
 
+    FramePacer *pacer = frame_pacer_create(tick_s, SIM_MAX_CATCHUP_S);
+    if (!pacer) {
+        fprintf(stderr, "Failed to create frame pacer\n");
+        profiler_destroy(prof);
+        asset_watcher_destroy(watcher);
+        elevator_scene_destroy(elevator);
+        replay_writer_close(recorder, 0);
+        replay_reader_close(replay);
+        soft_renderer_destroy(soft);
+        audio_clock_destroy(audio_clock);
+        framebuffer_destroy(g_framebuffer);
+        SDL_DestroyRenderer(g_renderer);
+        SDL_DestroyWindow(g_window);
+        quit_sdl();
+        return EXIT_FAILURE;
+    }
     int running = 1;
-    Uint64 last_ticks = SDL_GetPerformanceCounter();
+    int status = EXIT_SUCCESS;
+    int hidden = 0;
+    int unfocused = 0;  /* paused until focus returns; replays play on */
+    int sim_threaded = 0;
+
+    InputLatency *latency = input_latency_create(LATENCY_SAMPLES);
+    Uint64 period = frame_period(opt.fps);
+    Uint64 next_frame = SDL_GetPerformanceCounter();  /* frame limiter deadline */
+    Uint64 last_present = 0;
+    double work_s = 0.0;  /* decaying peak of poll-to-present time, for late input */
 
     while (running) {
+        /* Without vsync the limiter paces frames; polling right after it is
+         * already as late as input can be sampled. With vsync, late input
+         * sleeps until just enough time is left to make the next vblank. */
+        if (!hidden && opt.no_vsync) {
+            Uint64 now = SDL_GetPerformanceCounter();
+            if (now > next_frame + period)
+                next_frame = now;  /* fell behind: don't burst to catch up */
+            frame_pacer_sleep_until(pacer, next_frame);
+            next_frame += period;
+        } else if (!hidden && opt.late_input && last_present) {
+            Uint64 lead = (Uint64)((work_s + LATE_INPUT_MARGIN_S) * (double)SDL_GetPerformanceFrequency());
+            if (lead < period)
+                frame_pacer_sleep_until(pacer, last_present + period - lead);
+        }
+        Uint64 frame_start = SDL_GetPerformanceCounter();
+        profiler_begin_frame(prof);
+        AllocStats alloc_mark;
+        alloc_stats_get(&alloc_mark);
+
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
+            /* F3 toggles the frame-time overlay. */
+            if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F3 && !event.key.repeat) {
+                show_overlay = !show_overlay;
+                continue;
+            }
+            if (event.type == SDL_WINDOWEVENT) {
+                if (event.window.event == SDL_WINDOWEVENT_MINIMIZED || event.window.event == SDL_WINDOWEVENT_HIDDEN)
+                    hidden = 1;
+                else if (event.window.event == SDL_WINDOWEVENT_RESTORED || event.window.event == SDL_WINDOWEVENT_SHOWN)
+                    hidden = 0;
+                else if (event.window.event == SDL_WINDOWEVENT_FOCUS_LOST && !replay)
+                    unfocused = 1;
+                else if (event.window.event == SDL_WINDOWEVENT_FOCUS_GAINED)
+                    unfocused = 0;
+                elevator_scene_set_paused(elevator, unfocused);
+            }
+            if (replay && replay_ignores(&event))
+                continue;
             if (!elevator_scene_process_event(elevator, &event))
                 running = 0;
         }
+        /* Changed files are decoded on the loader's workers; the pump
+         * below or a later one swaps them in. */
+        char changed[256];
+        while (asset_watcher_poll(watcher, changed, sizeof changed))
+            if (elevator_scene_reload_asset(elevator, changed))
+                fprintf(stderr, "hot reload: %s\n", changed);
+        profiler_mark(prof, PROFILER_PHASE_EVENTS);
+
+        /* Fixed ticks: the same input always plays out the same way. With the
+         * sim thread running, it ticks on its own and only uploads land here. */
+        if (sim_threaded) {
+            elevator_scene_pump(elevator);
+        } else {
+            int ticks = frame_pacer_advance(pacer);
+            for (int i = 0; i < ticks && running; i++) {
+                /* Recorded input goes in before the update it was applied
+                 * to; the recording's ticks start once loading is done. */
+                if (replay && !elevator_scene_is_loading(elevator)) {
+                    Uint32 tick = elevator_scene_get_tick(elevator);
+                    SDL_Event recorded;
+                    int rc;
+                    while ((rc = replay_reader_next(replay, tick, &recorded)) == 1)
+                        elevator_scene_process_event(elevator, &recorded);
+                    if (rc < 0 || replay_reader_done(replay, tick)) {
+                        fprintf(stderr, "replay %s at tick %u\n", rc < 0 ? "damaged" : "finished", (unsigned)tick);
+                        running = 0;
+                        break;
+                    }
+                }
+                elevator_scene_update(elevator, frame_pacer_tick(pacer));
+            }
+        }
+        profiler_mark(prof, PROFILER_PHASE_UPDATE);
+        if (elevator_scene_load_failed(elevator)) {
+            fprintf(stderr, "Elevator sprites failed to load\n");
+            status = EXIT_FAILURE;
+            running = 0;
+        }
+
+        if (!hidden) {
+            /* The scene always sees 240×160: the framebuffer, or the logical size. */
+            int w = WINDOW_WIDTH, h = WINDOW_HEIGHT;
+            elevator_scene_set_window_size(elevator, w, h);
+
+            framebuffer_begin(g_framebuffer);
+            SDL_SetRenderDrawColor(g_renderer, 0x1a, 0x4d, 0x2e, 255); /* dark green background */
+            SDL_RenderClear(g_renderer);
+            elevator_scene_set_render_alpha(elevator, frame_pacer_alpha(pacer));
+            if (soft) {
+                soft_renderer_clear(soft, 0x1a, 0x4d, 0x2e);
+                elevator_scene_draw(elevator);
+                soft_renderer_present(soft, NULL);
+            } else {
+                elevator_scene_draw(elevator);
+            }
+            if (show_overlay)
+                profiler_draw_overlay(prof, g_renderer, w, h);
+            framebuffer_present(g_framebuffer, opt.upscale);
+            if (opt.gpu_sync) {
+                /* Reading a pixel back waits for the GPU to finish this
+                 * frame, so the driver cannot queue frames ahead of it. */
+                Uint32 pixel;
+                SDL_Rect one = { 0, 0, 1, 1 };
+                SDL_RenderReadPixels(g_renderer, &one, SDL_PIXELFORMAT_ARGB8888, &pixel, (int)sizeof pixel);
+            }
+            profiler_mark(prof, PROFILER_PHASE_DRAW);
+            double work = (double)(SDL_GetPerformanceCounter() - frame_start) / (double)SDL_GetPerformanceFrequency();
+            work_s = work > work_s ? work : work_s * LATE_INPUT_DECAY;
+
+            SDL_RenderPresent(g_renderer);
+            profiler_mark(prof, PROFILER_PHASE_PRESENT);
+            last_present = SDL_GetPerformanceCounter();
+            Uint64 shown = elevator_scene_take_shown_input(elevator);
+            if (shown)
+                input_latency_record(latency, shown, last_present);
+        }
+        if (first_frame) {
+            double freq = (double)SDL_GetPerformanceFrequency();
+            fprintf(stderr, "time to first frame: %.1f ms (scene ready at %.1f ms)\n",
+                    (double)(SDL_GetPerformanceCounter() - launch) * 1000.0 / freq,
+                    (double)(scene_ready - launch) * 1000.0 / freq);
+            first_frame = 0;
+        }
+        if (assets_pending && !elevator_scene_is_loading(elevator)) {
+            fprintf(stderr, "assets ready: %.1f ms\n",
+                    (double)(SDL_GetPerformanceCounter() - launch) * 1000.0 / (double)SDL_GetPerformanceFrequency());
+            assets_pending = 0;
+            /* From here on the scene steps at its own rate, off this thread.
+             * Replays stay here, where recorded input can go in per tick.
+             * So does late input: the sim thread's ticks aren't aligned to
+             * the present, so polling late would not apply input later. */
+            if (!opt.no_sim_thread && !opt.late_input && !replay) {
+                sim_threaded = elevator_scene_start_sim_thread(elevator, (float)SIM_TICK_S) == 0;
+                if (!sim_threaded)
+                    fprintf(stderr, "Failed to start the sim thread; updating between frames\n");
+            }
+        }
+        profiler_end_frame(prof);
+
+        AllocStats frame_allocs;
+        if (count_allocs && alloc_stats_since(&alloc_mark, &frame_allocs) && elevator_scene_is_steady(elevator) &&
+            steady_alloc_frames++ < ALLOC_REPORTS)
+            fprintf(stderr, "steady frame allocated: %llu mallocs, %llu reallocs, %llu frees, %llu textures\n",
+                    (unsigned long long)frame_allocs.mallocs, (unsigned long long)frame_allocs.reallocs,
+                    (unsigned long long)frame_allocs.frees, (unsigned long long)frame_allocs.textures);
+
+        /* Sleep instead of redrawing an unchanged picture. Outside the
+         * profiled frame, so idle time doesn't read as hitches. */
+        float next = elevator_scene_next_change(elevator);
+        /* File changes don't wake the event wait, so with hot reload the
+         * blocking waits below still poll the watcher. */
+        double block = watcher ? HOT_RELOAD_POLL_S : -1.0;
+        if (unfocused && !elevator_scene_is_loading(elevator)) {
+            /* Paused: the picture is drawn; nothing moves until input. */
+            frame_pacer_wait(pacer, block);
+            frame_pacer_reset(pacer);
+        } else if (hidden) {
+            if (next > 0.0f && !replay) {
+                /* Nothing visible and nothing running: block until input. */
+                frame_pacer_wait(pacer, block);
+                frame_pacer_reset(pacer);
+            } else {
+                frame_pacer_wait(pacer, SIM_TICK_S);
+            }
+        } else if (!show_overlay && next > SIM_TICK_S) {
+            double wait = next - SIM_TICK_S;
+            if (watcher && wait > HOT_RELOAD_POLL_S)
+                wait = HOT_RELOAD_POLL_S;
+            frame_pacer_wait(pacer, wait);
+        }
+    }
 
-        Uint64 now = SDL_GetPerformanceCounter();
-        float delta = (float)(now - last_ticks) / (float)SDL_GetPerformanceFrequency();
-        last_ticks = now;
+    /* The stats below read the simulation. */
+    elevator_scene_stop_sim_thread(elevator);
+    if (recorder) {
+        Uint32 ticks = elevator_scene_get_tick(elevator);
+        elevator_scene_set_recorder(elevator, NULL);
+        if (replay_writer_close(recorder, ticks) == 0)
+            fprintf(stderr, "recorded %u ticks to %s\n", (unsigned)ticks, opt.record);
+    }
+    replay_reader_close(replay);
 
-        elevator_scene_update(elevator, delta);
+    if (count_allocs) {
+        AllocStats allocs;
+        alloc_stats_get(&allocs);
+        fprintf(stderr, "allocations: %llu mallocs, %llu frees, %llu textures; %ld steady frames allocated\n",
+                (unsigned long long)allocs.mallocs, (unsigned long long)allocs.frees,
+                (unsigned long long)allocs.textures, steady_alloc_frames);
+    }
 
-        /* Logical size is always 240×160 so drawing isn't cut off at edges. */
-        int w, h;
-        SDL_RenderGetLogicalSize(g_renderer, &w, &h);
-        if (w <= 0) w = WINDOW_WIDTH;
-        if (h <= 0) h = WINDOW_HEIGHT;
-        elevator_scene_set_window_size(elevator, w, h);
+    FramePacerStats pacing;
+    frame_pacer_get_stats(pacer, &pacing);
+    fprintf(stderr, "pacing: %llu ticks, %llu idle waits (%.1f s), %llu stalls clamped (%.2f s dropped)\n",
+            (unsigned long long)pacing.ticks, (unsigned long long)pacing.waits, pacing.waited_s,
+            (unsigned long long)pacing.clamped, pacing.dropped_s);
+    if (pacing.limits > 0)
+        fprintf(stderr, "frame limiter: %llu sleeps (%.1f s)\n", (unsigned long long)pacing.limits, pacing.limited_s);
 
-        SDL_SetRenderDrawColor(g_renderer, 0x1a, 0x4d, 0x2e, 255); /* dark green background */
-        SDL_RenderClear(g_renderer);
-        elevator_scene_draw(elevator);
-        SDL_RenderPresent(g_renderer);
+    InputLatencyStats input;
+    input_latency_get_stats(latency, &input);
+    if (input.samples > 0)
+        fprintf(stderr, "input to present: %llu inputs, mean %.1f p50 %.1f p95 %.1f p99 %.1f max %.1f ms"
+                " (vsync %s, late input %s, gpu sync %s)\n",
+                (unsigned long long)input.total, input.mean_ms, input.p50_ms, input.p95_ms, input.p99_ms,
+                input.max_ms, opt.no_vsync ? "off" : "on", opt.late_input ? "on" : "off", opt.gpu_sync ? "on" : "off");
+    input_latency_destroy(latency);
+    frame_pacer_destroy(pacer);
+
+    if (prof) {
+        profiler_print_summary(prof);
+        if (opt.profile_csv)
+            profiler_write_csv(prof, opt.profile_csv);
+        if (opt.profile_trace)
+            profiler_write_trace(prof, opt.profile_trace);
+        profiler_destroy(prof);
     }
 
+    SoundLatencyStats lat;
+    elevator_scene_get_sound_latency(elevator, &lat);
+    if (lat.samples > 0)
+        fprintf(stderr, "sfx latency: %d cues, mean %.1f min %.1f max %.1f ms (buffer %d frames = %.1f ms)\n",
+                lat.samples, lat.mean_ms, lat.min_ms, lat.max_ms, opt.audio_buffer, lat.buffer_ms);
+    AudioDriftStats drift;
+    elevator_scene_get_audio_drift(elevator, &drift);
+    if (drift.samples > 0)
+        fprintf(stderr, "audio clock drift: mean %.2f max %.2f ms over %d updates, %d snaps\n",
+                drift.mean_abs_ms, drift.max_abs_ms, drift.samples, drift.snaps);
+
+    TextureCacheStats textures;
+    elevator_scene_get_texture_stats(elevator, &textures);
+    if (textures.defined > 0)
+        fprintf(stderr, "minigame textures: %llu hits, %llu misses (%llu reloads), %llu evictions;"
+                " %d resident, %.1f MB (peak %.1f, budget %.1f)\n",
+                (unsigned long long)textures.hits, (unsigned long long)textures.misses,
+                (unsigned long long)textures.reloads, (unsigned long long)textures.evictions, textures.resident,
+                textures.resident_bytes / 1048576.0, textures.peak_bytes / 1048576.0,
+                textures.budget_bytes / 1048576.0);
+    MusicStats music;
+    elevator_scene_get_music_stats(elevator, &music);
+    if (music.plays > 0)
+        fprintf(stderr, "music: %llu plays, %llu hits, %llu misses, %llu evictions; %d decoded, %.1f MB"
+                " (peak %.1f, cache %.1f)\n",
+                (unsigned long long)music.plays, (unsigned long long)music.hits, (unsigned long long)music.misses,
+                (unsigned long long)music.evictions, music.cached, music.cached_bytes / 1048576.0,
+                music.peak_bytes / 1048576.0, music.budget_bytes / 1048576.0);
+
+    asset_watcher_destroy(watcher);
     elevator_scene_destroy(elevator);
+    soft_renderer_destroy(soft);
+    audio_clock_destroy(audio_clock);
+    framebuffer_destroy(g_framebuffer);
     SDL_DestroyRenderer(g_renderer);
     SDL_DestroyWindow(g_window);
     quit_sdl();
-    return EXIT_SUCCESS;
+    return status;
 }
@@ -0,0 +1,177 @@
+#include "minigame.h"
+#include <stdio.h>
+#include <string.h>
+
+const MinigameDef *minigame_find(const char *name)
+{
+    for (int i = 0; name && i < MINIGAME_COUNT; i++) {
+        if (strcmp(MINIGAMES[i]->name, name) == 0)
+            return MINIGAMES[i];
+    }
+    return NULL;
+}
+
+Uint32 minigame_random(Uint32 *state)
+{
+    Uint32 x = *state ? *state : 0x9E3779B9u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+void minigame_draw_texture(const MinigameContext *ctx, SDL_Texture *texture, const SDL_Rect *src,
+                           const SDL_Rect *dst, int layer)
+{
+    static const SDL_Color opaque = { 255, 255, 255, 255 };
+    if (!ctx || !texture)
+        return;
+    if (ctx->soft)
+        soft_renderer_copy(ctx->soft, texture, src, dst, 255, 255, 255);
+    else if (!ctx->batch || sprite_batch_add(ctx->batch, texture, src, dst, SDL_FLIP_NONE, opaque, layer) != 0)
+        SDL_RenderCopy(ctx->renderer, texture, src, dst);
+}
+
+void minigame_draw_anims(const MinigameContext *ctx, int layer)
+{
+    static const SDL_Color opaque = { 255, 255, 255, 255 };
+    int n = anim_world_size(ctx->anims);
+    for (int id = 0; id < n; id++) {
+        const Sprite *sprite = anim_sprite(ctx->anims, id);
+        if (!sprite)
+            continue;
+        float x, y;
+        anim_position(ctx->anims, id, &x, &y);
+        SDL_Rect frame = { (int)x, (int)y, sprite->frame_w, sprite->frame_h }, d;
+        if (ctx->soft) {
+            if (sprite_dest_rect(sprite, &frame, &d) == 0)
+                soft_renderer_copy(ctx->soft, sprite->texture, &sprite->src, &d, 255, 255, 255);
+        } else if (!ctx->batch ||
+                   sprite_batch_add_sprite(ctx->batch, sprite, &frame, SDL_FLIP_NONE, opaque, layer) != 0) {
+            sprite_draw(ctx->renderer, sprite, &frame);
+        }
+    }
+}
+
+void minigame_free_texture(const MinigameContext *ctx, SDL_Texture *texture)
+{
+    if (!texture)
+        return;
+    soft_renderer_remove_image(ctx ? ctx->soft : NULL, texture);
+    SDL_DestroyTexture(texture);
+}
+
+/* ---- Wario Whirled: hang on until the fuse burns out ------------------- */
+
+#define WHIRLED_LOGO_NAME  "whirled_logo"
+#define WHIRLED_LOGO_PATH  "assets/graphics/wario whirled.png"
+#define WHIRLED_PULSE_S    0.5f   /* one grow-and-shrink of the logo */
+
+typedef struct {
+    TextureCache *textures;
+    int           logo;  /* id in textures; -1 plays without the logo */
+    float         t;
+} Whirled;
+
+static void *whirled_create(const MinigameContext *ctx)
+{
+    Whirled *game = arena_calloc(ctx->arena, 1, sizeof(Whirled));
+    if (!game)
+        return NULL;
+    TextureSource src = { .name = WHIRLED_LOGO_NAME, .path = WHIRLED_LOGO_PATH, .premultiply = 1 };
+    game->textures = ctx->textures;
+    game->logo = texture_cache_define(ctx->textures, &src);
+    texture_cache_prefetch(ctx->textures, game->logo);
+    return game;
+}
+
+static bool whirled_ready(void *game)
+{
+    Whirled *g = game;
+    return texture_cache_ready(g->textures, g->logo);
+}
+
+static MinigameResult whirled_update(void *game, float delta_s)
+{
+    ((Whirled *)game)->t += delta_s;
+    return MINIGAME_RUNNING;
+}
+
+static void whirled_draw(void *game, const MinigameContext *ctx)
+{
+    Whirled *g = game;
+    SDL_Texture *logo = texture_cache_get(ctx->textures, g->logo);
+    int tw, th;
+    if (!logo || SDL_QueryTexture(logo, NULL, NULL, &tw, &th) != 0 || tw <= 0 || th <= 0)
+        return;
+    /* Triangle-wave pulse between 70% and 90% of the playfield width. */
+    float phase = g->t / WHIRLED_PULSE_S;
+    phase -= (float)(int)phase;
+    float tri = phase < 0.5f ? phase * 2.0f : 2.0f - phase * 2.0f;
+    int w = (int)((float)ctx->w * (0.7f + 0.2f * tri));
+    int h = w * th / tw;
+    SDL_Rect dst = { (ctx->w - w) / 2, (ctx->h - h) / 2, w, h };
+    minigame_draw_texture(ctx, logo, NULL, &dst, 0);
+}
+
+static const MinigameDef MINIGAME_WHIRLED = {
+    .name           = "whirled",
+    .prompt         = "Hang on!",
+    .timeout_result = MINIGAME_WON,
+    .create         = whirled_create,
+    .ready          = whirled_ready,
+    .update         = whirled_update,
+    .draw           = whirled_draw,
+};
+
+/* ---- Press: hit SPACE before the fuse burns out ------------------------ */
+
+#define PRESS_BLINK_S  0.4f
+
+typedef struct {
+    bool  pressed;
+    float t;
+} Press;
+
+static void *press_create(const MinigameContext *ctx)
+{
+    return arena_calloc(ctx->arena, 1, sizeof(Press));
+}
+
+static MinigameResult press_update(void *game, float delta_s)
+{
+    Press *g = game;
+    g->t += delta_s;
+    return g->pressed ? MINIGAME_WON : MINIGAME_RUNNING;
+}
+
+static void press_draw(void *game, const MinigameContext *ctx)
+{
+    Press *g = game;
+    float phase = g->t / PRESS_BLINK_S;
+    if (phase - (float)(int)phase < 0.6f)
+        text_atlas_draw_centered(ctx->text, "PRESS!", ctx->w / 2, ctx->h / 2, 255, 220, 0);
+}
+
+static void press_event(void *game, const SDL_Event *event)
+{
+    if (event->type == SDL_KEYDOWN && !event->key.repeat && event->key.keysym.sym == SDLK_SPACE)
+        ((Press *)game)->pressed = true;
+}
+
+static const MinigameDef MINIGAME_PRESS = {
+    .name           = "press",
+    .prompt         = "Press!",
+    .timeout_result = MINIGAME_LOST,
+    .create         = press_create,
+    .update         = press_update,
+    .draw           = press_draw,
+    .event          = press_event,
+};
+
+const MinigameDef *const MINIGAMES[] = {
+    &MINIGAME_WHIRLED,
+    &MINIGAME_PRESS,
+};
+const int MINIGAME_COUNT = (int)(sizeof MINIGAMES / sizeof MINIGAMES[0]);
@@ -0,0 +1,87 @@
+#ifndef MINIGAME_H
+#define MINIGAME_H
+
+#include "anim.h"
+#include "arena.h"
+#include "batch.h"
+#include "loader.h"
+#include "softrender.h"
+#include "texcache.h"
+#include "text.h"
+#include <SDL.h>
+#include <stdbool.h>
+
+/* What a minigame reports each update. */
+typedef enum {
+    MINIGAME_RUNNING,
+    MINIGAME_WON,
+    MINIGAME_LOST,
+} MinigameResult;
+
+/* Everything the elevator lends a minigame; valid for the game's lifetime. */
+typedef struct MinigameContext {
+    SDL_Renderer *renderer;  /* draw only: never touch it from create */
+    AssetLoader  *loader;    /* submit loads from create; results arrive in update */
+    SpriteBatch  *batch;     /* NULL when sprites draw directly */
+    SoftRenderer *soft;      /* set when drawing on the CPU */
+    TextAtlas    *text;      /* may be NULL */
+    TextureCache *textures;  /* sheets shared between games within a GPU budget; may be NULL */
+    Arena        *arena;     /* game-lifetime memory, reset once the doors close */
+    Arena        *scratch;   /* update/draw temporaries; reset every update */
+    AnimWorld    *anims;     /* animated objects; advanced before each update, cleared with arena */
+    int           w;         /* playfield size */
+    int           h;
+    int           level;     /* floor the game is played on, for speed-ups */
+    Uint32        seed;      /* per-game randomness, so runs replay exactly */
+} MinigameContext;
+
+/* A minigame module. create runs on a background thread while the doors
+ * open, so it must not call the renderer: it builds state and submits its
+ * asset loads. ready, update and event run on the simulation thread (the
+ * sim thread when one is started, else the main thread), so they must not
+ * call the renderer either. draw and destroy always run on the main thread.
+ * All but create hold the elevator's game lock, so they never overlap; the
+ * game's state is only reached through them. The elevator owns the bomb
+ * timer; when it burns out the game ends with timeout_result (survival games
+ * win, "do it in time" games lose).
+ * State, entities and strings belong in ctx->arena, which is reset in one
+ * step after the doors close, so destroy only has to release what the arena
+ * cannot hold (music, textures loaded outside ctx->textures). Sheets in
+ * ctx->textures belong to the cache: define and prefetch them in create,
+ * wait for them in ready and get them again in every draw. */
+typedef struct MinigameDef {
+    const char     *name;
+    const char     *prompt;          /* shown as the doors open, e.g. "Press!" */
+    MinigameResult  timeout_result;
+    void          *(*create)(const MinigameContext *ctx);
+    bool           (*ready)(void *game);  /* assets in; NULL = always */
+    MinigameResult (*update)(void *game, float delta_s);
+    void           (*draw)(void *game, const MinigameContext *ctx);
+    void           (*event)(void *game, const SDL_Event *event);  /* may be NULL */
+    void           (*destroy)(void *game, const MinigameContext *ctx);  /* may be NULL */
+} MinigameDef;
+
+/* Registered minigames. */
+extern const MinigameDef *const MINIGAMES[];
+extern const int MINIGAME_COUNT;
+
+/* Looks a minigame up by name; NULL if unknown. */
+const MinigameDef *minigame_find(const char *name);
+
+/* Next value of a small deterministic generator (xorshift32, state != 0). */
+Uint32 minigame_random(Uint32 *state);
+
+/* Draws src of texture scaled to dst through whichever path the context
+ * uses (software rasterizer, sprite batch or a plain copy). */
+void minigame_draw_texture(const MinigameContext *ctx, SDL_Texture *texture, const SDL_Rect *src,
+                           const SDL_Rect *dst, int layer);
+
+/* Draws every live entity in ctx->anims, its frame's top-left at the
+ * entity position, in id order. */
+void minigame_draw_anims(const MinigameContext *ctx, int layer);
+
+/* Frees a texture a minigame loaded, including the rasterizer's copy.
+ * Main thread: from draw or destroy. */
+void minigame_free_texture(const MinigameContext *ctx, SDL_Texture *texture);
+
+#endif /* MINIGAME_H */
@@ -0,0 +1,481 @@
+#include "music.h"
+#include <SDL_mixer.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MUSIC_TRACKS  16
+/* The track playing, and the one fading out under it. */
+#define MUSIC_VOICES  2
+/* Reloads are tagged with the track id plus this. */
+#define MUSIC_RELOAD_TAG  MUSIC_TRACKS
+/* tools/pack_assets writes a plain 44-byte WAVE header before the PCM. */
+#define MUSIC_WAV_HEADER  44
+/* Play positions are frames in fixed point, so tempo can be fractional. */
+#define MUSIC_FRAC_BITS  16
+#define MUSIC_TEMPO_MIN  0.25f
+#define MUSIC_TEMPO_MAX  4.0f
+
+typedef enum {
+    TRACK_EVICTED,  /* defined, not in memory */
+    TRACK_LOADING,  /* on a loader worker */
+    TRACK_CACHED,
+    TRACK_FAILED,   /* not retried */
+} TrackState;
+
+typedef struct {
+    char          name[PACK_NAME_MAX];
+    char          path[ASSET_PATH_MAX];
+    TrackState    state;
+    const Sint16 *pcm;     /* interleaved device-format frames */
+    Uint32        frames;
+    Mix_Chunk    *chunk;   /* owns pcm once decoded; NULL while pcm is the pack's */
+    bool          wanted;  /* prefetched and not played yet: kept through evictions */
+    Uint64        last_used;
+} Track;
+
+typedef struct {
+    int    track;      /* -1 = silent */
+    Uint64 pos;        /* frames, MUSIC_FRAC_BITS fixed point */
+    Uint32 step;       /* pos advance per output frame: the tempo */
+    bool   loop;
+    float  gain;
+    float  target;     /* gain at the end of the fade; 0 silences the voice */
+    float  gain_step;  /* per frame */
+    Uint32 fade_left;  /* frames */
+} Voice;
+
+struct MusicPlayer {
+    AssetPack   *pack;
+    AssetLoader *loader;
+    int          rate;
+    int          channels;
+    SDL_mutex   *lock;     /* tracks and voices: the audio thread vs everyone else */
+    Track        tracks[MUSIC_TRACKS];
+    int          count;
+    Voice        voices[MUSIC_VOICES];
+    int          current;  /* voice of the latest play */
+    bool         paused;   /* voices hold their place and mix silence */
+    Uint64       clock;
+    MusicStats   stats;
+};
+
+static void mix_voice(Voice *v, const Track *t, int channels, Sint16 *out, int frames)
+{
+    if (t->state != TRACK_CACHED || t->frames == 0) {
+        v->track = -1;
+        return;
+    }
+    Uint64 end = (Uint64)t->frames << MUSIC_FRAC_BITS;
+    for (int i = 0; i < frames; i++, out += channels) {
+        if (v->pos >= end) {
+            if (!v->loop) {
+                v->track = -1;
+                return;
+            }
+            v->pos %= end;
+        }
+        /* Linear interpolation; across the seam a loop reads its first frame. */
+        Uint32 idx = (Uint32)(v->pos >> MUSIC_FRAC_BITS);
+        Sint64 frac = (Sint64)(v->pos & ((1u << MUSIC_FRAC_BITS) - 1));
+        Uint32 next = idx + 1 < t->frames ? idx + 1 : (v->loop ? 0 : idx);
+        const Sint16 *a = t->pcm + (size_t)idx * (size_t)channels;
+        const Sint16 *b = t->pcm + (size_t)next * (size_t)channels;
+        for (int c = 0; c < channels; c++) {
+            Sint32 s = a[c] + (Sint32)(((Sint64)(b[c] - a[c]) * frac) >> MUSIC_FRAC_BITS);
+            Sint32 mixed = out[c] + (Sint32)((float)s * v->gain);
+            out[c] = (Sint16)(mixed > 32767 ? 32767 : mixed < -32768 ? -32768 : mixed);
+        }
+        v->pos += v->step;
+        if (v->fade_left > 0) {
+            v->gain += v->gain_step;
+            if (--v->fade_left == 0) {
+                v->gain = v->target;
+                if (v->gain <= 0.0f) {
+                    v->track = -1;
+                    return;
+                }
+            }
+        }
+    }
+}
+
+/* Mixer music hook, on the audio thread. SDL_mixer mixes the channels
+ * (sound cues) on top afterwards. */
+static void mix_music(void *udata, Uint8 *stream, int len)
+{
+    MusicPlayer *player = udata;
+    SDL_memset(stream, 0, (size_t)len);
+    int frames = len / (player->channels * (int)sizeof(Sint16));
+    SDL_LockMutex(player->lock);
+    for (int i = 0; i < MUSIC_VOICES && !player->paused; i++) {
+        Voice *v = &player->voices[i];
+        if (v->track >= 0)
+            mix_voice(v, &player->tracks[v->track], player->channels, (Sint16 *)stream, frames);
+    }
+    SDL_UnlockMutex(player->lock);
+}
+
+static void start_fade(Voice *v, float target, Uint32 frames)
+{
+    v->target = target;
+    v->fade_left = frames;
+    v->gain_step = (target - v->gain) / (float)frames;
+}
+
+static bool in_use(const MusicPlayer *player, int id)
+{
+    for (int i = 0; i < MUSIC_VOICES; i++)
+        if (player->voices[i].track == id)
+            return true;
+    return false;
+}
+
+/* Drops a decoded track's PCM; the chunk goes in freed[] to be freed once
+ * the lock is released (Mix_FreeChunk takes the mixer's lock, which the
+ * audio thread holds while it waits on ours). */
+static void evict(MusicPlayer *player, Track *t, Mix_Chunk **freed, int *nfreed)
+{
+    freed[(*nfreed)++] = t->chunk;
+    player->stats.cached_bytes -= t->chunk->alen;
+    player->stats.cached--;
+    player->stats.evictions++;
+    t->chunk = NULL;
+    t->pcm = NULL;
+    t->frames = 0;
+    t->state = TRACK_EVICTED;
+}
+
+/* Evicts the least recently played decoded tracks until the rest fit. A
+ * playing track stays even if that means going over, and so does one
+ * prefetched for the next play: something may be waiting on its ready. */
+static void trim(MusicPlayer *player, Mix_Chunk **freed, int *nfreed)
+{
+    size_t budget = player->stats.budget_bytes;
+    while (budget > 0 && player->stats.cached_bytes > budget) {
+        Track *victim = NULL;
+        for (int i = 0; i < player->count; i++) {
+            Track *t = &player->tracks[i];
+            if (!t->chunk || t->wanted || in_use(player, i))
+                continue;
+            if (!victim || t->last_used < victim->last_used)
+                victim = t;
+        }
+        if (!victim)
+            return;
+        evict(player, victim, freed, nfreed);
+    }
+}
+
+static void free_chunks(Mix_Chunk **chunks, int count)
+{
+    for (int i = 0; i < count; i++)
+        Mix_FreeChunk(chunks[i]);
+}
+
+/* Main thread, from asset_loader_pump. */
+static void on_track_ready(void *user, const AssetResult *res)
+{
+    MusicPlayer *player = user;
+    bool reload = res->tag >= MUSIC_RELOAD_TAG;
+    int id = reload ? res->tag - MUSIC_RELOAD_TAG : res->tag;
+    Mix_Chunk *freed[MUSIC_TRACKS + 1];
+    int nfreed = 0;
+
+    SDL_LockMutex(player->lock);
+    Track *t = &player->tracks[id];
+    if (!res->chunk) {
+        if (reload) {
+            fprintf(stderr, "hot reload: cannot decode '%s'; keeping the old one\n", res->path);
+        } else {
+            fprintf(stderr, "music: cannot decode '%s'\n", res->path);
+            t->state = TRACK_FAILED;
+        }
+    } else if (!reload && t->state != TRACK_LOADING) {
+        freed[nfreed++] = res->chunk;  /* a reload got there first */
+    } else {
+        /* A reload swaps under a playing voice, which carries on from its
+         * position (or ends, if the new file is shorter). */
+        if (t->chunk) {
+            freed[nfreed++] = t->chunk;
+            player->stats.cached_bytes -= t->chunk->alen;
+            player->stats.cached--;
+        }
+        t->chunk = res->chunk;
+        t->pcm = (const Sint16 *)res->chunk->abuf;
+        t->frames = res->chunk->alen / (Uint32)(player->channels * (int)sizeof(Sint16));
+        t->state = TRACK_CACHED;
+        t->last_used = ++player->clock;
+        player->stats.cached_bytes += res->chunk->alen;
+        player->stats.cached++;
+        if (player->stats.cached_bytes > player->stats.peak_bytes)
+            player->stats.peak_bytes = player->stats.cached_bytes;
+        trim(player, freed, &nfreed);
+    }
+    SDL_UnlockMutex(player->lock);
+    free_chunks(freed, nfreed);
+}
+
+/* Counts the hit or miss. When id has to be decoded, marks it loading and
+ * fills req for the caller to submit once it has released the lock. Call
+ * with the lock held. */
+static bool request(MusicPlayer *player, int id, AssetRequest *req)
+{
+    Track *t = &player->tracks[id];
+    t->last_used = ++player->clock;
+    if (t->state == TRACK_CACHED) {
+        player->stats.hits++;
+        return false;
+    }
+    if (t->state != TRACK_EVICTED)
+        return false;
+    player->stats.misses++;
+    t->state = TRACK_LOADING;
+    *req = (AssetRequest){ .kind = ASSET_CHUNK, .tag = id, .on_ready = on_track_ready, .user = player };
+    (void)snprintf(req->path, sizeof req->path, "%s", t->path);
+    return true;
+}
+
+/* Queues a decode request() asked for. Without the lock: the loader has its
+ * own, and the audio thread shouldn't wait on a queue push. */
+static void submit(MusicPlayer *player, const AssetRequest *req)
+{
+    if (asset_loader_submit(player->loader, req) == 0)
+        return;
+    fprintf(stderr, "music: cannot queue '%s'\n", req->path);
+    SDL_LockMutex(player->lock);
+    Track *t = &player->tracks[req->tag];
+    if (t->state == TRACK_LOADING)
+        t->state = TRACK_FAILED;
+    SDL_UnlockMutex(player->lock);
+}
+
+/* Packed tracks in the device's rate and channel count play from the
+ * mapping itself. Returns false if the pack's copy can't be used. */
+static bool bind_packed(MusicPlayer *player, Track *t)
+{
+    const PackEntry *e = asset_pack_find(player->pack, t->name, PACK_ENTRY_WAV);
+    if (!e || e->size <= MUSIC_WAV_HEADER || (int)e->a != player->rate || (int)e->b != player->channels)
+        return false;
+    const Uint8 *wav = asset_pack_data(player->pack, e);
+    Uint16 format, bits;
+    memcpy(&format, wav + 20, sizeof format);
+    memcpy(&bits, wav + 34, sizeof bits);
+    if (SDL_SwapLE16(format) != 1 || SDL_SwapLE16(bits) != 16 || memcmp(wav + 36, "data", 4) != 0)
+        return false;
+    t->pcm = (const Sint16 *)(wav + MUSIC_WAV_HEADER);
+    t->frames = (e->size - MUSIC_WAV_HEADER) / (Uint32)(player->channels * (int)sizeof(Sint16));
+    t->state = TRACK_CACHED;
+    return true;
+}
+
+MusicPlayer *music_player_create(AssetPack *pack, AssetLoader *loader, size_t cache_bytes)
+{
+    int freq = 0, chans = 0;
+    Uint16 fmt = 0;
+    if (Mix_QuerySpec(&freq, &fmt, &chans) == 0 || freq <= 0 || chans <= 0) {
+        fprintf(stderr, "music: audio not open\n");
+        return NULL;
+    }
+    if (fmt != AUDIO_S16SYS) {
+        fprintf(stderr, "music: device format 0x%04x is not 16-bit\n", fmt);
+        return NULL;
+    }
+    MusicPlayer *player = calloc(1, sizeof(MusicPlayer));
+    if (!player)
+        return NULL;
+    player->pack = pack;
+    player->loader = loader;
+    player->rate = freq;
+    player->channels = chans;
+    player->stats.budget_bytes = cache_bytes;
+    for (int i = 0; i < MUSIC_VOICES; i++)
+        player->voices[i].track = -1;
+    player->lock = SDL_CreateMutex();
+    if (!player->lock) {
+        fprintf(stderr, "SDL_CreateMutex: %s\n", SDL_GetError());
+        free(player);
+        return NULL;
+    }
+    Mix_HookMusic(mix_music, player);
+    return player;
+}
+
+void music_player_destroy(MusicPlayer *player)
+{
+    if (!player)
+        return;
+    /* Mix_HookMusic takes the audio lock, so no callback is running after this. */
+    Mix_HookMusic(NULL, NULL);
+    for (int i = 0; i < player->count; i++)
+        if (player->tracks[i].chunk)
+            Mix_FreeChunk(player->tracks[i].chunk);
+    SDL_DestroyMutex(player->lock);
+    free(player);
+}
+
+int music_player_define(MusicPlayer *player, const char *name, const char *path)
+{
+    if (!player || !name || !name[0])
+        return -1;
+    SDL_LockMutex(player->lock);
+    int id = -1;
+    for (int i = 0; i < player->count && id < 0; i++)
+        if (strncmp(player->tracks[i].name, name, sizeof player->tracks[i].name) == 0)
+            id = i;
+    if (id < 0 && player->count < MUSIC_TRACKS) {
+        id = player->count++;
+        Track *t = &player->tracks[id];
+        *t = (Track){ .state = TRACK_EVICTED };
+        (void)snprintf(t->name, sizeof t->name, "%s", name);
+        if (path)
+            (void)snprintf(t->path, sizeof t->path, "%s", path);
+        if (!bind_packed(player, t) && !path) {
+            fprintf(stderr, "music: '%s' is not packed and has no file\n", name);
+            t->state = TRACK_FAILED;
+        }
+    } else if (id < 0) {
+        fprintf(stderr, "music: more than %d tracks; not playing '%s'\n", MUSIC_TRACKS, name);
+    }
+    SDL_UnlockMutex(player->lock);
+    return id;
+}
+
+void music_player_prefetch(MusicPlayer *player, int id)
+{
+    if (!player)
+        return;
+    AssetRequest req;
+    SDL_LockMutex(player->lock);
+    bool load = false;
+    if (id >= 0 && id < player->count) {
+        load = request(player, id, &req);
+        player->tracks[id].wanted = player->tracks[id].state != TRACK_FAILED;
+    }
+    SDL_UnlockMutex(player->lock);
+    if (load)
+        submit(player, &req);
+}
+
+bool music_player_ready(MusicPlayer *player, int id)
+{
+    if (!player)
+        return true;
+    SDL_LockMutex(player->lock);
+    bool ready = id < 0 || id >= player->count || player->tracks[id].state == TRACK_CACHED ||
+                 player->tracks[id].state == TRACK_FAILED;
+    SDL_UnlockMutex(player->lock);
+    return ready;
+}
+
+int music_player_play(MusicPlayer *player, int id, const MusicPlayParams *params)
+{
+    if (!player || !params)
+        return -1;
+    SDL_LockMutex(player->lock);
+    if (id < 0 || id >= player->count) {
+        SDL_UnlockMutex(player->lock);
+        return -1;
+    }
+    player->stats.plays++;
+    AssetRequest req;
+    bool load = request(player, id, &req);
+    player->tracks[id].wanted = false;
+    if (player->tracks[id].state != TRACK_CACHED) {
+        SDL_UnlockMutex(player->lock);
+        if (load)
+            submit(player, &req);
+        return -1;
+    }
+    float tempo = params->tempo;
+    if (!(tempo >= MUSIC_TEMPO_MIN))
+        tempo = tempo > 0.0f ? MUSIC_TEMPO_MIN : 1.0f;
+    if (tempo > MUSIC_TEMPO_MAX)
+        tempo = MUSIC_TEMPO_MAX;
+    Uint32 fade = params->fade_s > 0.0f ? (Uint32)(params->fade_s * (float)player->rate) : 0;
+
+    /* With a fade, the old track keeps its voice and fades out under the
+     * new one; otherwise it is cut. */
+    Voice *old = &player->voices[player->current];
+    if (old->track >= 0 && fade > 0) {
+        start_fade(old, 0.0f, fade);
+        player->current = (player->current + 1) % MUSIC_VOICES;
+    }
+    Voice *v = &player->voices[player->current];
+    *v = (Voice){
+        .track  = id,
+        .step   = (Uint32)(tempo * (float)(1u << MUSIC_FRAC_BITS) + 0.5f),
+        .loop   = params->loop,
+        .gain   = fade > 0 ? 0.0f : 1.0f,
+        .target = 1.0f,
+    };
+    if (fade > 0)
+        start_fade(v, 1.0f, fade);
+    SDL_UnlockMutex(player->lock);
+    return 0;
+}
+
+void music_player_stop(MusicPlayer *player, float fade_s)
+{
+    if (!player)
+        return;
+    SDL_LockMutex(player->lock);
+    Voice *v = &player->voices[player->current];
+    Uint32 fade = fade_s > 0.0f ? (Uint32)(fade_s * (float)player->rate) : 0;
+    if (v->track >= 0 && fade > 0)
+        start_fade(v, 0.0f, fade);
+    else
+        v->track = -1;
+    SDL_UnlockMutex(player->lock);
+}
+
+void music_player_pause(MusicPlayer *player, bool paused)
+{
+    if (!player)
+        return;
+    SDL_LockMutex(player->lock);
+    player->paused = paused;
+    SDL_UnlockMutex(player->lock);
+}
+
+int music_player_reload(MusicPlayer *player, const char *path)
+{
+    if (!player || !path)
+        return -1;
+    SDL_LockMutex(player->lock);
+    int id = -1;
+    for (int i = 0; i < player->count && id < 0; i++)
+        if (player->tracks[i].path[0] && strcmp(player->tracks[i].path, path) == 0)
+            id = i;
+    SDL_UnlockMutex(player->lock);
+    if (id < 0)
+        return -1;
+    AssetRequest req = { .kind = ASSET_CHUNK, .tag = MUSIC_RELOAD_TAG + id, .on_ready = on_track_ready, .user = player };
+    (void)snprintf(req.path, sizeof req.path, "%s", path);
+    return asset_loader_submit(player->loader, &req);
+}
+
+void music_player_set_cache_size(MusicPlayer *player, size_t cache_bytes)
+{
+    if (!player)
+        return;
+    Mix_Chunk *freed[MUSIC_TRACKS];
+    int nfreed = 0;
+    SDL_LockMutex(player->lock);
+    player->stats.budget_bytes = cache_bytes;
+    trim(player, freed, &nfreed);
+    SDL_UnlockMutex(player->lock);
+    free_chunks(freed, nfreed);
+}
+
+void music_player_get_stats(MusicPlayer *player, MusicStats *out)
+{
+    if (!out)
+        return;
+    *out = (MusicStats){ 0 };
+    if (!player)
+        return;
+    SDL_LockMutex(player->lock);
+    *out = player->stats;
+    SDL_UnlockMutex(player->lock);
+}
@@ -0,0 +1,80 @@
+#ifndef MUSIC_H
+#define MUSIC_H
+
+#include "loader.h"
+#include "pack.h"
+#include <SDL.h>
+#include <stdbool.h>
+
+/* Music played from PCM in memory through the mixer's music hook, so
+ * starting a track costs nothing on the audio thread. Each track is decoded
+ * once on the loader's workers and kept while the cache has room; packed
+ * tracks are already PCM in the device format and play straight from the
+ * mapping. Loops are sample-exact, a track can play faster (resampled, so
+ * pitch rises with it), and a new track can crossfade over the old one.
+ * Decoded tracks the cache has no room for are freed least recently played
+ * first, and decoded again when next wanted.
+ * Needs a signed 16-bit device (MIX_DEFAULT_FORMAT). Owns Mix_HookMusic:
+ * Mix_PlayMusic must not be used alongside it. */
+typedef struct MusicPlayer MusicPlayer;
+
+/* How play starts a track. */
+typedef struct MusicPlayParams {
+    float tempo;   /* 1 = as recorded; 1.25 = 25% faster (and higher) */
+    bool  loop;    /* wrap to the start with no gap, until stopped */
+    float fade_s;  /* crossfade from whatever plays now; 0 cuts */
+} MusicPlayParams;
+
+typedef struct MusicStats {
+    Uint64 plays;
+    Uint64 hits;          /* plays and prefetches that found the track decoded */
+    Uint64 misses;        /* ones that had to decode it */
+    Uint64 evictions;
+    size_t cached_bytes;  /* decoded PCM held now; packed tracks don't count */
+    size_t peak_bytes;
+    size_t budget_bytes;  /* 0 = no limit */
+    int    cached;        /* decoded tracks held now */
+} MusicStats;
+
+/* Installs the music hook. cache_bytes bounds decoded PCM (0 = no limit).
+ * Call after Mix_OpenAudio. Returns NULL if audio is not open or is not
+ * 16-bit. */
+MusicPlayer *music_player_create(AssetPack *pack, AssetLoader *loader, size_t cache_bytes);
+
+/* Removes the hook and frees every track. Destroy the loader first, so no
+ * decode lands later. */
+void music_player_destroy(MusicPlayer *player);
+
+/* Returns the id of the track packed as name (or loaded from path when the
+ * pack lacks it), defining it the first time; -1 on failure. */
+int music_player_define(MusicPlayer *player, const char *name, const char *path);
+
+/* Starts decoding id in the background if it isn't in memory, and keeps it
+ * through evictions until it is next played. */
+void music_player_prefetch(MusicPlayer *player, int id);
+
+/* True once id can start at once, or its decode failed. */
+bool music_player_ready(MusicPlayer *player, int id);
+
+/* Starts id on the next mixer callback. Returns -1 if it isn't decoded yet
+ * (the decode is started; nothing plays). Any thread. */
+int music_player_play(MusicPlayer *player, int id, const MusicPlayParams *params);
+
+/* Fades the current track out over fade_s (0 = at once). Any thread. */
+void music_player_stop(MusicPlayer *player, float fade_s);
+
+/* Holds every voice where it is (fades included) and mixes silence until
+ * unpaused. Any thread. */
+void music_player_pause(MusicPlayer *player, bool paused);
+
+/* Hot reload: if path is a track's file, decodes it again; the new PCM
+ * replaces the old on delivery, even mid-play. Returns 0 if queued, -1 if
+ * path is not a track. */
+int music_player_reload(MusicPlayer *player, const char *path);
+
+/* Lowers or raises the cache bound; anything over it goes at once. */
+void music_player_set_cache_size(MusicPlayer *player, size_t cache_bytes);
+
+void music_player_get_stats(MusicPlayer *player, MusicStats *out);
+
+#endif /* MUSIC_H */
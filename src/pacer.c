@@ -0,0 +1,109 @@
+#include "pacer.h"
+#include <stdlib.h>
+
+/* SDL_Delay can overshoot by a scheduler quantum; the last stretch spins. */
+#define PACER_SPIN_S  0.002
+
+struct FramePacer {
+    double tick_s;
+    double max_catchup_s;
+    double accumulator;
+    Uint64 last;
+    FramePacerStats stats;
+};
+
+FramePacer *frame_pacer_create(double tick_s, double max_catchup_s)
+{
+    if (tick_s <= 0.0)
+        return NULL;
+    FramePacer *pacer = calloc(1, sizeof(FramePacer));
+    if (!pacer)
+        return NULL;
+    pacer->tick_s = tick_s;
+    pacer->max_catchup_s = max_catchup_s < tick_s ? tick_s : max_catchup_s;
+    pacer->last = SDL_GetPerformanceCounter();
+    return pacer;
+}
+
+void frame_pacer_destroy(FramePacer *pacer)
+{
+    free(pacer);
+}
+
+int frame_pacer_advance(FramePacer *pacer)
+{
+    if (!pacer)
+        return 0;
+    Uint64 now = SDL_GetPerformanceCounter();
+    pacer->accumulator += (double)(now - pacer->last) / (double)SDL_GetPerformanceFrequency();
+    pacer->last = now;
+
+    if (pacer->accumulator > pacer->max_catchup_s) {
+        pacer->stats.clamped++;
+        pacer->stats.dropped_s += pacer->accumulator - pacer->max_catchup_s;
+        pacer->accumulator = pacer->max_catchup_s;
+    }
+    int ticks = (int)(pacer->accumulator / pacer->tick_s);
+    pacer->accumulator -= ticks * pacer->tick_s;
+    pacer->stats.ticks += (Uint64)ticks;
+    return ticks;
+}
+
+float frame_pacer_tick(const FramePacer *pacer)
+{
+    return pacer ? (float)pacer->tick_s : 0.0f;
+}
+
+float frame_pacer_alpha(const FramePacer *pacer)
+{
+    if (!pacer)
+        return 1.0f;
+    float a = (float)(pacer->accumulator / pacer->tick_s);
+    return a < 0.0f ? 0.0f : a > 1.0f ? 1.0f : a;
+}
+
+int frame_pacer_wait(FramePacer *pacer, double timeout_s)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+    int ms = timeout_s < 0.0 ? -1 : (int)(timeout_s * 1000.0);
+    int ready = ms < 0 ? SDL_WaitEvent(NULL) : SDL_WaitEventTimeout(NULL, ms);
+    if (pacer) {
+        pacer->stats.waits++;
+        pacer->stats.waited_s += (double)(SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+    }
+    return ready;
+}
+
+void frame_pacer_sleep_until(FramePacer *pacer, Uint64 deadline)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+    if (deadline <= start)
+        return;
+    double freq = (double)SDL_GetPerformanceFrequency();
+    double left = (double)(deadline - start) / freq;
+    if (left > PACER_SPIN_S)
+        SDL_Delay((Uint32)((left - PACER_SPIN_S) * 1000.0));
+    Uint64 now;
+    do {
+        now = SDL_GetPerformanceCounter();
+    } while (now < deadline);
+    if (pacer) {
+        pacer->stats.limits++;
+        pacer->stats.limited_s += (double)(now - start) / freq;
+    }
+}
+
+void frame_pacer_reset(FramePacer *pacer)
+{
+    if (!pacer)
+        return;
+    pacer->accumulator = 0.0;
+    pacer->last = SDL_GetPerformanceCounter();
+}
+
+void frame_pacer_get_stats(const FramePacer *pacer, FramePacerStats *out)
+{
+    if (!out)
+        return;
+    *out = pacer ? pacer->stats : (FramePacerStats){ 0 };
+}
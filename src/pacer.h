@@ -0,0 +1,51 @@
+#ifndef PACER_H
+#define PACER_H
+
+#include <SDL.h>
+
+/* Fixed-timestep frame pacing: wall time goes into an accumulator, the
+ * simulation consumes it in whole ticks, and what is left over becomes the
+ * interpolation fraction for drawing. */
+typedef struct FramePacer FramePacer;
+
+typedef struct FramePacerStats {
+    Uint64 ticks;      /* simulation ticks handed out */
+    Uint64 clamped;    /* frames whose backlog exceeded the catch-up limit */
+    double dropped_s;  /* wall time discarded by those clamps */
+    Uint64 waits;      /* idle waits instead of rendering */
+    double waited_s;
+    Uint64 limits;     /* frame-limiter and late-input sleeps */
+    double limited_s;
+} FramePacerStats;
+
+/* tick_s: simulation step. max_catchup_s: backlog beyond this is dropped
+ * after a stall instead of being replayed in a burst. Returns NULL on failure. */
+FramePacer *frame_pacer_create(double tick_s, double max_catchup_s);
+
+void frame_pacer_destroy(FramePacer *pacer);
+
+/* Adds the wall time since the last call and returns how many ticks to run. */
+int frame_pacer_advance(FramePacer *pacer);
+
+/* The fixed step, in seconds. */
+float frame_pacer_tick(const FramePacer *pacer);
+
+/* How far between the last two ticks the present moment is, 0..1. */
+float frame_pacer_alpha(const FramePacer *pacer);
+
+/* Sleeps until an event arrives or timeout_s passes (< 0: until an event).
+ * Returns 1 if an event is waiting. */
+int frame_pacer_wait(FramePacer *pacer, double timeout_s);
+
+/* Sleeps until the performance counter reaches deadline, to well under a
+ * millisecond: coarse SDL_Delay first, then a short spin. Events arriving
+ * meanwhile wait for the next poll. */
+void frame_pacer_sleep_until(FramePacer *pacer, Uint64 deadline);
+
+/* Drops the accumulated time, so a long wait that needed no simulation
+ * is not replayed as ticks. */
+void frame_pacer_reset(FramePacer *pacer);
+
+void frame_pacer_get_stats(const FramePacer *pacer, FramePacerStats *out);
+
+#endif /* PACER_H */
@@ -0,0 +1,179 @@
+#define _POSIX_C_SOURCE 200809L
+#include "pack.h"
+#include "chroma.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef WARIOWARE_EMBED_PACK
+/* Generated by `tools/pack_assets --embed` (make EMBED_PACK=1). */
+extern const unsigned char warioware_pack_data[];
+extern const size_t        warioware_pack_size;
+#endif
+
+struct AssetPack {
+    const Uint8     *base;
+    size_t           size;
+    const PackEntry *entries;
+    Uint32           count;
+    int              mapped;  /* 1 = munmap on close, 2 = SDL_free on close, 0 = borrowed */
+};
+
+static int validate(AssetPack *pack)
+{
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    return -1;  /* the little-endian table is read in place */
+#endif
+    if (pack->size < sizeof(PackHeader))
+        return -1;
+    const PackHeader *hdr = (const PackHeader *)pack->base;
+    if (hdr->magic != PACK_MAGIC || hdr->version != PACK_VERSION)
+        return -1;
+    size_t table_end = sizeof(PackHeader) + (size_t)hdr->entry_count * sizeof(PackEntry);
+    if (table_end > pack->size)
+        return -1;
+    pack->entries = (const PackEntry *)(pack->base + sizeof(PackHeader));
+    pack->count   = hdr->entry_count;
+    for (Uint32 i = 0; i < pack->count; i++) {
+        const PackEntry *e = &pack->entries[i];
+        if ((size_t)e->offset + e->size > pack->size || e->name[PACK_NAME_MAX - 1] != '\0')
+            return -1;
+    }
+    return 0;
+}
+
+AssetPack *asset_pack_open_mem(const void *data, size_t size)
+{
+    if (!data)
+        return NULL;
+    AssetPack *pack = calloc(1, sizeof(AssetPack));
+    if (!pack)
+        return NULL;
+    pack->base = data;
+    pack->size = size;
+    if (validate(pack) != 0) {
+        fprintf(stderr, "asset pack: bad header or entry table\n");
+        free(pack);
+        return NULL;
+    }
+    return pack;
+}
+
+AssetPack *asset_pack_open(const char *path)
+{
+    if (!path)
+        return NULL;
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return NULL;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "asset pack: cannot map '%s'\n", path);
+        return NULL;
+    }
+    AssetPack *pack = asset_pack_open_mem(map, (size_t)st.st_size);
+    if (!pack) {
+        munmap(map, (size_t)st.st_size);
+        return NULL;
+    }
+    pack->mapped = 1;
+    return pack;
+#else
+    /* No mmap: read the whole file once. */
+    size_t size = 0;
+    void *data = SDL_LoadFile(path, &size);
+    if (!data)
+        return NULL;
+    AssetPack *pack = asset_pack_open_mem(data, size);
+    if (!pack) {
+        SDL_free(data);
+        return NULL;
+    }
+    pack->mapped = 2;
+    return pack;
+#endif
+}
+
+AssetPack *asset_pack_open_default(const char *path)
+{
+#ifdef WARIOWARE_EMBED_PACK
+    AssetPack *pack = asset_pack_open_mem(warioware_pack_data, warioware_pack_size);
+    if (pack)
+        return pack;
+#endif
+    return asset_pack_open(path);
+}
+
+void asset_pack_close(AssetPack *pack)
+{
+    if (!pack)
+        return;
+#ifndef _WIN32
+    if (pack->mapped == 1)
+        munmap((void *)pack->base, pack->size);
+#endif
+    if (pack->mapped == 2)
+        SDL_free((void *)pack->base);
+    free(pack);
+}
+
+const PackEntry *asset_pack_find(const AssetPack *pack, const char *name, PackEntryType type)
+{
+    if (!pack || !name)
+        return NULL;
+    for (Uint32 i = 0; i < pack->count; i++) {
+        const PackEntry *e = &pack->entries[i];
+        if (e->type == (Uint32)type && strcmp(e->name, name) == 0)
+            return e;
+    }
+    return NULL;
+}
+
+const void *asset_pack_data(const AssetPack *pack, const PackEntry *entry)
+{
+    if (!pack || !entry)
+        return NULL;
+    return pack->base + entry->offset;
+}
+
+SDL_Texture *asset_pack_create_texture(const AssetPack *pack, SDL_Renderer *renderer, const char *name)
+{
+    const PackEntry *e = asset_pack_find(pack, name, PACK_ENTRY_RGBA);
+    if (!e || (size_t)e->a * e->b * 4 != e->size)
+        return NULL;
+    SDL_Texture *tex = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, (int)e->a, (int)e->b);
+    if (!tex) {
+        fprintf(stderr, "SDL_CreateTexture: %s\n", SDL_GetError());
+        return NULL;
+    }
+    /* Pixels go to the GPU straight from the mapping: no decode, no keying. */
+    if (SDL_UpdateTexture(tex, NULL, asset_pack_data(pack, e), (int)e->a * 4) != 0) {
+        fprintf(stderr, "SDL_UpdateTexture: %s\n", SDL_GetError());
+        SDL_DestroyTexture(tex);
+        return NULL;
+    }
+    chroma_set_premultiplied_blend(tex);
+    return tex;
+}
+
+SDL_RWops *asset_pack_open_rw(const AssetPack *pack, const char *name, PackEntryType type)
+{
+    const PackEntry *e = asset_pack_find(pack, name, type);
+    if (!e)
+        return NULL;
+    return SDL_RWFromConstMem(asset_pack_data(pack, e), (int)e->size);
+}
@@ -0,0 +1,75 @@
+#ifndef PACK_H
+#define PACK_H
+
+#include <SDL.h>
+
+/* On-disk layout of assets/warioware.pak (written by tools/pack_assets).
+ * All integers little-endian; every blob starts on a PACK_ALIGN boundary
+ * so pixel data can be handed to the GPU (or SIMD code) straight from the
+ * mapping. The header and table are read in place as the structs below,
+ * so a big-endian host refuses the pack and loads the loose files.
+ *
+ *   PackHeader
+ *   PackEntry[entry_count]
+ *   blobs...
+ */
+#define PACK_MAGIC     0x4B505757u  /* "WWPK" */
+#define PACK_VERSION   2
+#define PACK_ALIGN     16
+#define PACK_NAME_MAX  48
+
+typedef enum {
+    PACK_ENTRY_RGBA = 1,  /* premultiplied RGBA32, chroma key already in alpha; a = w, b = h */
+    PACK_ENTRY_WAV  = 2,  /* PCM in a RIFF/WAVE wrapper, device format; a = freq, b = channels */
+    PACK_ENTRY_BLOB = 3,  /* raw file bytes (fonts, indexes) */
+} PackEntryType;
+
+typedef struct PackHeader {
+    Uint32 magic;
+    Uint32 version;
+    Uint32 entry_count;
+    Uint32 reserved;
+} PackHeader;
+
+typedef struct PackEntry {
+    char   name[PACK_NAME_MAX];
+    Uint32 type;
+    Uint32 offset;  /* from start of file */
+    Uint32 size;    /* bytes */
+    Uint32 a;
+    Uint32 b;
+    Uint32 reserved[3];
+} PackEntry;
+
+_Static_assert(sizeof(PackHeader) == 16 && sizeof(PackEntry) == PACK_NAME_MAX + 32,
+               "pack structs must match the file layout");
+
+typedef struct AssetPack AssetPack;
+
+/* Opens the built-in pack when compiled with WARIOWARE_EMBED_PACK, else
+ * maps path. Returns NULL when neither is available. */
+AssetPack *asset_pack_open_default(const char *path);
+
+/* Maps a pack file read-only. Returns NULL if missing or invalid. */
+AssetPack *asset_pack_open(const char *path);
+
+/* Wraps pack bytes already in memory (not copied; must outlive the pack). */
+AssetPack *asset_pack_open_mem(const void *data, size_t size);
+
+/* Unmaps the pack. Textures created from it stay valid; fonts and music
+ * opened from it must be closed first. */
+void asset_pack_close(AssetPack *pack);
+
+/* Entry by name and type, or NULL. */
+const PackEntry *asset_pack_find(const AssetPack *pack, const char *name, PackEntryType type);
+
+/* Pointer to an entry's bytes inside the mapping. */
+const void *asset_pack_data(const AssetPack *pack, const PackEntry *entry);
+
+/* Uploads an RGBA entry into a new static texture (premultiplied blend). */
+SDL_Texture *asset_pack_create_texture(const AssetPack *pack, SDL_Renderer *renderer, const char *name);
+
+/* Read-only RWops over an entry's bytes (for TTF_OpenFontRW, Mix_LoadMUS_RW). */
+SDL_RWops *asset_pack_open_rw(const AssetPack *pack, const char *name, PackEntryType type);
+
+#endif /* PACK_H */
@@ -0,0 +1,195 @@
+#include "pool.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Keeps each worker's range counter on its own cache line, so claiming a
+ * task doesn't invalidate the line the neighbours are claiming from. */
+#define POOL_LINE  64
+
+typedef struct WorkRange {
+    SDL_atomic_t next;   /* next unclaimed task; may run past end */
+    int          end;
+    int          steals; /* written by its worker, read after the job */
+    char         pad[POOL_LINE - sizeof(SDL_atomic_t) - 2 * sizeof(int)];
+} WorkRange;
+
+typedef struct Worker {
+    WorkPool *pool;
+    int       index;
+} Worker;
+
+struct WorkPool {
+    int          workers;
+    SDL_Thread **threads;  /* workers - 1; worker 0 is the caller */
+    Worker      *args;
+    WorkRange   *ranges;
+    SDL_sem     *start;
+    SDL_sem     *done;
+    bool         quit;     /* set before the last start, read after it */
+
+    WorkFn       fn;
+    void        *user;
+
+    Uint64       jobs;
+    Uint64       tasks;
+    Uint64       steals;
+};
+
+/* Claims one task from range r: returns it, or -1 once r is used up. */
+static int claim(WorkRange *r)
+{
+    if (SDL_AtomicGet(&r->next) >= r->end)
+        return -1;
+    int t = SDL_AtomicAdd(&r->next, 1);
+    return t < r->end ? t : -1;
+}
+
+static void work(WorkPool *pool, int index)
+{
+    WorkRange *own = &pool->ranges[index];
+    int t;
+    while ((t = claim(own)) >= 0)
+        pool->fn(pool->user, t);
+    /* Own range done: help the others, starting with the next worker so the
+     * thieves spread out instead of all draining worker 0. */
+    for (int k = 1; k < pool->workers; k++) {
+        WorkRange *victim = &pool->ranges[(index + k) % pool->workers];
+        while ((t = claim(victim)) >= 0) {
+            pool->fn(pool->user, t);
+            own->steals++;
+        }
+    }
+}
+
+static int worker_main(void *data)
+{
+    Worker *w = data;
+    WorkPool *pool = w->pool;
+    for (;;) {
+        SDL_SemWait(pool->start);
+        if (pool->quit)
+            break;
+        work(pool, w->index);
+        SDL_SemPost(pool->done);
+    }
+    return 0;
+}
+
+WorkPool *work_pool_create(int workers)
+{
+    if (workers <= 0)
+        workers = SDL_GetCPUCount();
+    if (workers <= 0)
+        workers = 1;
+    WorkPool *pool = calloc(1, sizeof(WorkPool));
+    if (!pool)
+        return NULL;
+    pool->workers = workers;
+    pool->threads = calloc((size_t)workers, sizeof(SDL_Thread *));
+    pool->args = calloc((size_t)workers, sizeof(Worker));
+    pool->ranges = aligned_alloc(POOL_LINE, (size_t)workers * sizeof(WorkRange));
+    pool->start = SDL_CreateSemaphore(0);
+    pool->done = SDL_CreateSemaphore(0);
+    if (!pool->threads || !pool->args || !pool->ranges || !pool->start || !pool->done) {
+        fprintf(stderr, "Failed to create work pool: %s\n", SDL_GetError());
+        work_pool_destroy(pool);
+        return NULL;
+    }
+    for (int i = 0; i < workers; i++) {
+        pool->ranges[i] = (WorkRange){ .end = 0 };
+        pool->args[i] = (Worker){ pool, i };
+    }
+    for (int i = 1; i < workers; i++) {
+        pool->threads[i] = SDL_CreateThread(worker_main, "work", &pool->args[i]);
+        if (!pool->threads[i]) {
+            fprintf(stderr, "Failed to start worker thread: %s\n", SDL_GetError());
+            work_pool_destroy(pool);
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+void work_pool_destroy(WorkPool *pool)
+{
+    if (!pool)
+        return;
+    if (pool->threads) {
+        int running = 0;
+        for (int i = 1; i < pool->workers; i++)
+            running += pool->threads[i] != NULL;
+        pool->quit = true;
+        for (int i = 0; i < running; i++)
+            SDL_SemPost(pool->start);
+        for (int i = 1; i < pool->workers; i++)
+            if (pool->threads[i])
+                SDL_WaitThread(pool->threads[i], NULL);
+    }
+    if (pool->start)
+        SDL_DestroySemaphore(pool->start);
+    if (pool->done)
+        SDL_DestroySemaphore(pool->done);
+    free(pool->ranges);
+    free(pool->args);
+    free(pool->threads);
+    free(pool);
+}
+
+int work_pool_workers(const WorkPool *pool)
+{
+    return pool ? pool->workers : 1;
+}
+
+void work_pool_run(WorkPool *pool, int tasks, WorkFn fn, void *user)
+{
+    if (tasks <= 0 || !fn)
+        return;
+    if (!pool || pool->workers == 1 || tasks == 1) {
+        for (int t = 0; t < tasks; t++)
+            fn(user, t);
+        if (pool) {
+            pool->jobs++;
+            pool->tasks += (Uint64)tasks;
+        }
+        return;
+    }
+
+    /* Deal the tasks out evenly; the first tasks % workers get one extra. */
+    int n = pool->workers;
+    int base = tasks / n, extra = tasks % n, first = 0;
+    for (int i = 0; i < n; i++) {
+        int count = base + (i < extra);
+        pool->ranges[i].end = first + count;
+        pool->ranges[i].steals = 0;
+        SDL_AtomicSet(&pool->ranges[i].next, first);
+        first += count;
+    }
+    pool->fn = fn;
+    pool->user = user;
+
+    /* The semaphores order the setup above before the workers' reads, and
+     * their work before our reads below. */
+    for (int i = 1; i < n; i++)
+        SDL_SemPost(pool->start);
+    work(pool, 0);
+    for (int i = 1; i < n; i++)
+        SDL_SemWait(pool->done);
+
+    pool->jobs++;
+    pool->tasks += (Uint64)tasks;
+    for (int i = 0; i < n; i++)
+        pool->steals += (Uint64)pool->ranges[i].steals;
+}
+
+void work_pool_get_stats(const WorkPool *pool, WorkPoolStats *out)
+{
+    if (!out)
+        return;
+    *out = (WorkPoolStats){ 0 };
+    if (!pool)
+        return;
+    out->jobs   = pool->jobs;
+    out->tasks  = pool->tasks;
+    out->steals = pool->steals;
+}
@@ -0,0 +1,34 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <SDL.h>
+
+/* Fixed set of worker threads running parallel-for jobs. Each job's tasks
+ * are dealt out as one contiguous range per worker; a worker that finishes
+ * its range steals tasks from the others', so uneven tasks still keep every
+ * core busy. The calling thread works as worker 0. */
+typedef struct WorkPool WorkPool;
+
+typedef void (*WorkFn)(void *user, int task);
+
+typedef struct WorkPoolStats {
+    Uint64 jobs;
+    Uint64 tasks;
+    Uint64 steals;  /* tasks run by a worker other than the one dealt them */
+} WorkPoolStats;
+
+/* workers: threads including the caller; 0 uses one per CPU core. Returns
+ * NULL on failure. */
+WorkPool *work_pool_create(int workers);
+
+void work_pool_destroy(WorkPool *pool);
+
+int work_pool_workers(const WorkPool *pool);
+
+/* Runs fn(user, t) for every t in 0..tasks-1 and returns when all are done.
+ * Tasks may run in any order and on any worker. NULL pool runs them here. */
+void work_pool_run(WorkPool *pool, int tasks, WorkFn fn, void *user);
+
+void work_pool_get_stats(const WorkPool *pool, WorkPoolStats *out);
+
+#endif /* POOL_H */
@@ -0,0 +1,314 @@
+#include "profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* A frame is a hitch when it takes this many times the recent average... */
+#define PROFILER_HITCH_FACTOR   2.0
+/* ...and at least this long, so jitter on fast frames isn't reported. */
+#define PROFILER_HITCH_MIN_MS   8.0
+/* Frames ignored at startup before the average is trusted. */
+#define PROFILER_WARMUP_FRAMES  30
+/* Weight of the newest frame in the running average. */
+#define PROFILER_AVG_WEIGHT     0.05
+
+/* Overlay vertical scale: full height is this many milliseconds. */
+#define PROFILER_OVERLAY_MS     50.0
+#define PROFILER_TARGET_MS      (1000.0 / 60.0)
+
+static const char *const PHASE_NAMES[PROFILER_PHASE_COUNT] = { "events", "update", "draw", "present" };
+
+static const SDL_Color PHASE_COLORS[PROFILER_PHASE_COUNT] = {
+    {  80, 160, 255, 255 },  /* events */
+    {  80, 220,  80, 255 },  /* update */
+    { 255, 200,  40, 255 },  /* draw */
+    { 200,  80, 220, 255 },  /* present */
+};
+
+typedef struct {
+    Uint64 start;
+    Uint64 end[PROFILER_PHASE_COUNT];  /* phase i runs from end[i-1] (or start) to end[i] */
+    int    hitch;
+} ProfilerFrame;
+
+struct Profiler {
+    ProfilerFrame *ring;
+    int            capacity;   /* power of two */
+    SDL_atomic_t   published;  /* frames ever published; slot = n & (capacity - 1) */
+    ProfilerFrame  current;    /* frame being recorded; owned by the main thread */
+    double        *scratch;    /* sort buffer for percentiles, capacity entries */
+    Uint64         freq;
+    Uint64         origin;     /* counter at create; trace timestamps are relative to it */
+    double         avg_ms;
+    int            hitches;
+};
+
+static double counts_to_ms(const Profiler *prof, Uint64 counts)
+{
+    return (double)counts * 1000.0 / (double)prof->freq;
+}
+
+static Uint64 phase_start(const ProfilerFrame *f, int phase)
+{
+    return phase == 0 ? f->start : f->end[phase - 1];
+}
+
+static double frame_ms(const Profiler *prof, const ProfilerFrame *f, int phase)
+{
+    if (phase == PROFILER_FRAME)
+        return counts_to_ms(prof, f->end[PROFILER_PHASE_COUNT - 1] - f->start);
+    return counts_to_ms(prof, f->end[phase] - phase_start(f, phase));
+}
+
+/* Oldest-first range of readable frames. The writer only touches the slot
+ * after the newest published one, so a reader on another thread sees whole
+ * frames as long as it finishes before the ring wraps. */
+static int readable_range(const Profiler *prof, int *first)
+{
+    int published = SDL_AtomicGet((SDL_atomic_t *)&prof->published);
+    SDL_MemoryBarrierAcquire();
+    int count = published < prof->capacity - 1 ? published : prof->capacity - 1;
+    *first = published - count;
+    return count;
+}
+
+static const ProfilerFrame *ring_at(const Profiler *prof, int n)
+{
+    return &prof->ring[n & (prof->capacity - 1)];
+}
+
+Profiler *profiler_create(int capacity)
+{
+    int cap = 2;
+    while (cap < capacity)
+        cap <<= 1;
+
+    Profiler *prof = calloc(1, sizeof(Profiler));
+    if (!prof)
+        return NULL;
+    prof->ring    = calloc((size_t)cap, sizeof(ProfilerFrame));
+    prof->scratch = calloc((size_t)cap, sizeof(double));
+    if (!prof->ring || !prof->scratch) {
+        profiler_destroy(prof);
+        return NULL;
+    }
+    prof->capacity = cap;
+    prof->freq     = SDL_GetPerformanceFrequency();
+    prof->origin   = SDL_GetPerformanceCounter();
+    return prof;
+}
+
+void profiler_destroy(Profiler *prof)
+{
+    if (!prof)
+        return;
+    free(prof->scratch);
+    free(prof->ring);
+    free(prof);
+}
+
+void profiler_begin_frame(Profiler *prof)
+{
+    if (!prof)
+        return;
+    Uint64 now = SDL_GetPerformanceCounter();
+    prof->current.start = now;
+    for (int i = 0; i < PROFILER_PHASE_COUNT; i++)
+        prof->current.end[i] = now;
+    prof->current.hitch = 0;
+}
+
+void profiler_mark(Profiler *prof, ProfilerPhase phase)
+{
+    if (!prof || phase < 0 || phase >= PROFILER_PHASE_COUNT)
+        return;
+    Uint64 now = SDL_GetPerformanceCounter();
+    /* Later phases default to zero length if they are never marked. */
+    for (int i = phase; i < PROFILER_PHASE_COUNT; i++)
+        prof->current.end[i] = now;
+}
+
+static void detect_hitch(Profiler *prof, ProfilerFrame *f, int index)
+{
+    double ms = frame_ms(prof, f, PROFILER_FRAME);
+    if (index < PROFILER_WARMUP_FRAMES) {
+        prof->avg_ms = index == 0 ? ms : prof->avg_ms + (ms - prof->avg_ms) / (double)(index + 1);
+        return;
+    }
+    if (ms > PROFILER_HITCH_MIN_MS && ms > prof->avg_ms * PROFILER_HITCH_FACTOR) {
+        int worst = 0;
+        for (int i = 1; i < PROFILER_PHASE_COUNT; i++) {
+            if (frame_ms(prof, f, i) > frame_ms(prof, f, worst))
+                worst = i;
+        }
+        f->hitch = 1;
+        prof->hitches++;
+        fprintf(stderr, "hitch: frame %d took %.2f ms (avg %.2f ms), %s %.2f ms\n",
+                index, ms, prof->avg_ms, PHASE_NAMES[worst], frame_ms(prof, f, worst));
+        return;  /* keep spikes out of the baseline */
+    }
+    prof->avg_ms += (ms - prof->avg_ms) * PROFILER_AVG_WEIGHT;
+}
+
+void profiler_end_frame(Profiler *prof)
+{
+    if (!prof)
+        return;
+    int index = SDL_AtomicGet(&prof->published);
+    detect_hitch(prof, &prof->current, index);
+    prof->ring[index & (prof->capacity - 1)] = prof->current;
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&prof->published, index + 1);
+}
+
+static int compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted, int n, double p)
+{
+    int idx = (int)(p * (double)(n - 1) + 0.5);
+    return sorted[idx];
+}
+
+void profiler_summarize(Profiler *prof, int phase, ProfilerSummary *out)
+{
+    if (!out)
+        return;
+    *out = (ProfilerSummary){ 0 };
+    if (!prof || phase < PROFILER_FRAME || phase >= PROFILER_PHASE_COUNT)
+        return;
+
+    int first;
+    int n = readable_range(prof, &first);
+    out->hitches = prof->hitches;
+    if (n == 0)
+        return;
+
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) {
+        prof->scratch[i] = frame_ms(prof, ring_at(prof, first + i), phase);
+        sum += prof->scratch[i];
+    }
+    qsort(prof->scratch, (size_t)n, sizeof(double), compare_double);
+    out->frames  = n;
+    out->mean_ms = sum / (double)n;
+    out->p50_ms  = percentile(prof->scratch, n, 0.50);
+    out->p95_ms  = percentile(prof->scratch, n, 0.95);
+    out->p99_ms  = percentile(prof->scratch, n, 0.99);
+    out->max_ms  = prof->scratch[n - 1];
+}
+
+int profiler_write_csv(const Profiler *prof, const char *path)
+{
+    if (!prof || !path)
+        return -1;
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "profiler: cannot write '%s'\n", path);
+        return -1;
+    }
+    int first;
+    int n = readable_range(prof, &first);
+    fprintf(f, "frame,start_ms");
+    for (int p = 0; p < PROFILER_PHASE_COUNT; p++)
+        fprintf(f, ",%s_ms", PHASE_NAMES[p]);
+    fprintf(f, ",total_ms,hitch\n");
+    for (int i = 0; i < n; i++) {
+        const ProfilerFrame *fr = ring_at(prof, first + i);
+        fprintf(f, "%d,%.3f", first + i, counts_to_ms(prof, fr->start - prof->origin));
+        for (int p = 0; p < PROFILER_PHASE_COUNT; p++)
+            fprintf(f, ",%.3f", frame_ms(prof, fr, p));
+        fprintf(f, ",%.3f,%d\n", frame_ms(prof, fr, PROFILER_FRAME), fr->hitch);
+    }
+    fclose(f);
+    return 0;
+}
+
+int profiler_write_trace(const Profiler *prof, const char *path)
+{
+    if (!prof || !path)
+        return -1;
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "profiler: cannot write '%s'\n", path);
+        return -1;
+    }
+    int first;
+    int n = readable_range(prof, &first);
+    const char *sep = "";
+    fprintf(f, "{\"traceEvents\":[\n");
+    for (int i = 0; i < n; i++) {
+        const ProfilerFrame *fr = ring_at(prof, first + i);
+        double ts = counts_to_ms(prof, fr->start - prof->origin) * 1000.0;
+        fprintf(f, "%s{\"name\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.1f,\"dur\":%.1f,\"args\":{\"frame\":%d}}",
+                sep, ts, frame_ms(prof, fr, PROFILER_FRAME) * 1000.0, first + i);
+        sep = ",\n";
+        for (int p = 0; p < PROFILER_PHASE_COUNT; p++) {
+            double pts = counts_to_ms(prof, phase_start(fr, p) - prof->origin) * 1000.0;
+            fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.1f,\"dur\":%.1f}",
+                    sep, PHASE_NAMES[p], pts, frame_ms(prof, fr, p) * 1000.0);
+        }
+        if (fr->hitch)
+            fprintf(f, "%s{\"name\":\"hitch\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":1,\"ts\":%.1f}", sep, ts);
+    }
+    fprintf(f, "\n]}\n");
+    fclose(f);
+    return 0;
+}
+
+void profiler_print_summary(Profiler *prof)
+{
+    if (!prof)
+        return;
+    ProfilerSummary s;
+    profiler_summarize(prof, PROFILER_FRAME, &s);
+    fprintf(stderr, "frame:   %d frames, %d hitches, mean %.2f p50 %.2f p95 %.2f p99 %.2f max %.2f ms\n",
+            s.frames, s.hitches, s.mean_ms, s.p50_ms, s.p95_ms, s.p99_ms, s.max_ms);
+    for (int p = 0; p < PROFILER_PHASE_COUNT; p++) {
+        profiler_summarize(prof, p, &s);
+        fprintf(stderr, "%-8s mean %.2f p50 %.2f p95 %.2f p99 %.2f max %.2f ms\n",
+                PHASE_NAMES[p], s.mean_ms, s.p50_ms, s.p95_ms, s.p99_ms, s.max_ms);
+    }
+}
+
+void profiler_draw_overlay(const Profiler *prof, SDL_Renderer *renderer, int w, int h)
+{
+    if (!prof || !renderer || w <= 0 || h <= 0)
+        return;
+
+    int graph_h = h / 3;
+    double px_per_ms = (double)graph_h / PROFILER_OVERLAY_MS;
+    int base_y = h;
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 160);
+    SDL_Rect bg = { 0, base_y - graph_h, w, graph_h };
+    SDL_RenderFillRect(renderer, &bg);
+
+    /* One pixel column per frame, newest on the right. */
+    int first;
+    int n = readable_range(prof, &first);
+    int shown = n < w ? n : w;
+    for (int i = 0; i < shown; i++) {
+        const ProfilerFrame *fr = ring_at(prof, first + n - shown + i);
+        int x = w - shown + i;
+        int y = base_y;
+        for (int p = 0; p < PROFILER_PHASE_COUNT; p++) {
+            int bar = (int)(frame_ms(prof, fr, p) * px_per_ms + 0.5);
+            if (bar <= 0)
+                continue;
+            SDL_Color c = fr->hitch ? (SDL_Color){ 255, 40, 40, 255 } : PHASE_COLORS[p];
+            SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, 220);
+            SDL_RenderDrawLine(renderer, x, y - 1, x, y - bar);
+            y -= bar;
+        }
+    }
+
+    /* 60 Hz budget line. */
+    int target_y = base_y - (int)(PROFILER_TARGET_MS * px_per_ms + 0.5);
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 128);
+    SDL_RenderDrawLine(renderer, 0, target_y, w - 1, target_y);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+}
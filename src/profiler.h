@@ -0,0 +1,61 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <SDL.h>
+
+/* Main-loop phases, in the order they run each frame. */
+typedef enum {
+    PROFILER_PHASE_EVENTS,
+    PROFILER_PHASE_UPDATE,
+    PROFILER_PHASE_DRAW,
+    PROFILER_PHASE_PRESENT,
+    PROFILER_PHASE_COUNT
+} ProfilerPhase;
+
+/* Pass as phase to summarize whole frames instead of one phase. */
+#define PROFILER_FRAME  (-1)
+
+typedef struct Profiler Profiler;
+
+typedef struct ProfilerSummary {
+    int    frames;   /* frames currently held in the ring */
+    int    hitches;  /* hitches detected since create */
+    double mean_ms;
+    double p50_ms;
+    double p95_ms;
+    double p99_ms;
+    double max_ms;
+} ProfilerSummary;
+
+/* Creates a profiler keeping the last `capacity` frames (rounded up to a
+ * power of two). Returns NULL on failure. */
+Profiler *profiler_create(int capacity);
+
+/* Frees the profiler. */
+void profiler_destroy(Profiler *prof);
+
+/* Starts a new frame; the events phase begins now. */
+void profiler_begin_frame(Profiler *prof);
+
+/* Ends `phase` now; the next phase starts at the same timestamp. */
+void profiler_mark(Profiler *prof, ProfilerPhase phase);
+
+/* Publishes the frame to the ring and runs hitch detection. */
+void profiler_end_frame(Profiler *prof);
+
+/* Percentiles over the frames in the ring, for one phase or PROFILER_FRAME. */
+void profiler_summarize(Profiler *prof, int phase, ProfilerSummary *out);
+
+/* Writes one row per frame (phase durations in ms). Returns 0 on success. */
+int profiler_write_csv(const Profiler *prof, const char *path);
+
+/* Writes Chrome trace JSON (chrome://tracing, Perfetto). Returns 0 on success. */
+int profiler_write_trace(const Profiler *prof, const char *path);
+
+/* Prints frame and per-phase percentiles to stderr. */
+void profiler_print_summary(Profiler *prof);
+
+/* Draws a stacked per-phase bar graph of recent frames in the given area. */
+void profiler_draw_overlay(const Profiler *prof, SDL_Renderer *renderer, int w, int h);
+
+#endif /* PROFILER_H */
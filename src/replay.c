@@ -0,0 +1,399 @@
+#include "replay.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REPLAY_MAGIC    "WWRP"
+#define REPLAY_VERSION  1
+
+/* Encoded bytes waiting for the writer thread; power of two. Around 16k
+ * keypresses, far more than a stalled disk needs to cover. */
+#define REPLAY_RING_BYTES  (64 * 1024)
+/* Longest record: two 5-byte varints, kind, button, two 5-byte zigzags. */
+#define REPLAY_RECORD_MAX  24
+/* How long the writer sleeps when nobody posts. */
+#define REPLAY_WRITER_POLL_MS  100
+
+enum {
+    REPLAY_KEY_DOWN,
+    REPLAY_KEY_UP,
+    REPLAY_MOUSE_MOTION,
+    REPLAY_MOUSE_DOWN,
+    REPLAY_MOUSE_UP,
+    REPLAY_END,
+    REPLAY_KIND_MASK = 0x0f,
+    REPLAY_REPEAT    = 0x10,
+};
+
+static int put_varint(Uint8 *p, Uint32 v)
+{
+    int n = 0;
+    while (v >= 0x80) {
+        p[n++] = (Uint8)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (Uint8)v;
+    return n;
+}
+
+static Uint32 zigzag(Sint32 v)
+{
+    return ((Uint32)v << 1) ^ (Uint32)(v >> 31);
+}
+
+static Sint32 unzigzag(Uint32 v)
+{
+    return (Sint32)(v >> 1) ^ -(Sint32)(v & 1);
+}
+
+static void put_u32(Uint8 *p, Uint32 v)
+{
+    p[0] = (Uint8)v;
+    p[1] = (Uint8)(v >> 8);
+    p[2] = (Uint8)(v >> 16);
+    p[3] = (Uint8)(v >> 24);
+}
+
+static Uint32 get_u32(const Uint8 *p)
+{
+    return (Uint32)p[0] | (Uint32)p[1] << 8 | (Uint32)p[2] << 16 | (Uint32)p[3] << 24;
+}
+
+struct ReplayWriter {
+    FILE         *file;
+    SDL_Thread   *thread;
+    SDL_sem      *wake;
+    SDL_atomic_t  quit;
+    Uint8         ring[REPLAY_RING_BYTES];
+    SDL_atomic_t  head;      /* bytes ever produced (wraps) */
+    SDL_atomic_t  tail;      /* bytes ever written out */
+    /* Producer side only. */
+    Uint32        last_tick;
+    Sint32        mouse_x;
+    Sint32        mouse_y;
+    int           dropped;
+    /* Writer thread only, read after it is joined. */
+    bool          io_error;
+};
+
+static int writer_main(void *data)
+{
+    ReplayWriter *w = data;
+    for (;;) {
+        bool quitting = SDL_AtomicGet(&w->quit) != 0;
+        Uint32 head = (Uint32)SDL_AtomicGet(&w->head);
+        Uint32 tail = (Uint32)SDL_AtomicGet(&w->tail);
+        SDL_MemoryBarrierAcquire();  /* see the bytes produce stored */
+        if (head != tail) {
+            Uint32 start = tail & (REPLAY_RING_BYTES - 1);
+            Uint32 len = head - tail;
+            Uint32 first = len < REPLAY_RING_BYTES - start ? len : REPLAY_RING_BYTES - start;
+            if (fwrite(w->ring + start, 1, first, w->file) != first ||
+                fwrite(w->ring, 1, len - first, w->file) != len - first)
+                w->io_error = true;
+            SDL_MemoryBarrierRelease();  /* written out before the space is reused */
+            SDL_AtomicSet(&w->tail, (int)head);
+            if (fflush(w->file) != 0)
+                w->io_error = true;
+            continue;
+        }
+        if (quitting)
+            break;
+        SDL_SemWaitTimeout(w->wake, REPLAY_WRITER_POLL_MS);
+    }
+    return 0;
+}
+
+ReplayWriter *replay_writer_open(const char *path, Uint32 seed, float tick_s)
+{
+    ReplayWriter *w = calloc(1, sizeof(ReplayWriter));
+    if (!w)
+        return NULL;
+    w->file = fopen(path, "wb");
+    if (!w->file) {
+        fprintf(stderr, "replay: cannot create '%s'\n", path);
+        free(w);
+        return NULL;
+    }
+    Uint8 header[13];
+    memcpy(header, REPLAY_MAGIC, 4);
+    header[4] = REPLAY_VERSION;
+    put_u32(header + 5, seed);
+    /* The float's bits, so a replay steps by exactly the recorded delta. */
+    Uint32 tick_bits;
+    memcpy(&tick_bits, &tick_s, sizeof tick_bits);
+    put_u32(header + 9, tick_bits);
+    w->wake = SDL_CreateSemaphore(0);
+    if (fwrite(header, 1, sizeof header, w->file) != sizeof header || !w->wake ||
+        !(w->thread = SDL_CreateThread(writer_main, "replay writer", w))) {
+        fprintf(stderr, "replay: cannot start writing '%s'\n", path);
+        if (w->wake)
+            SDL_DestroySemaphore(w->wake);
+        fclose(w->file);
+        free(w);
+        return NULL;
+    }
+    return w;
+}
+
+/* Copies one record into the ring, or drops it if the writer is behind.
+ * Returns 0 if queued, -1 if dropped. */
+static int produce(ReplayWriter *w, Uint32 tick, const Uint8 *rec, int len)
+{
+    Uint8 buf[REPLAY_RECORD_MAX + 5];
+    int n = put_varint(buf, tick - w->last_tick);
+    memcpy(buf + n, rec, (size_t)len);
+    n += len;
+
+    Uint32 head = (Uint32)SDL_AtomicGet(&w->head);
+    Uint32 tail = (Uint32)SDL_AtomicGet(&w->tail);
+    SDL_MemoryBarrierAcquire();  /* the writer is done with the freed space */
+    if (REPLAY_RING_BYTES - (head - tail) < (Uint32)n) {
+        w->dropped++;
+        return -1;
+    }
+    for (int i = 0; i < n; i++)
+        w->ring[(head + (Uint32)i) & (REPLAY_RING_BYTES - 1)] = buf[i];
+    SDL_MemoryBarrierRelease();  /* the record is visible before head moves */
+    SDL_AtomicSet(&w->head, (int)(head + (Uint32)n));
+    SDL_SemPost(w->wake);
+    w->last_tick = tick;
+    return 0;
+}
+
+/* Encodes x, y against the last position written; the caller moves that
+ * position only once the record is queued, so a dropped one doesn't skew
+ * the deltas after it. */
+static int put_mouse_delta(const ReplayWriter *w, Uint8 *p, Sint32 x, Sint32 y)
+{
+    int n = put_varint(p, zigzag(x - w->mouse_x));
+    n += put_varint(p + n, zigzag(y - w->mouse_y));
+    return n;
+}
+
+void replay_writer_event(ReplayWriter *w, Uint32 tick, const SDL_Event *event)
+{
+    if (!w || tick < w->last_tick)
+        return;
+    Uint8 rec[REPLAY_RECORD_MAX];
+    int n = 0;
+    bool mouse = false;
+    Sint32 x = 0, y = 0;
+    switch (event->type) {
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+        rec[n++] = (Uint8)((event->type == SDL_KEYDOWN ? REPLAY_KEY_DOWN : REPLAY_KEY_UP) |
+                           (event->key.repeat ? REPLAY_REPEAT : 0));
+        n += put_varint(rec + n, (Uint32)event->key.keysym.sym);
+        n += put_varint(rec + n, event->key.keysym.mod);
+        break;
+    case SDL_MOUSEMOTION:
+        rec[n++] = REPLAY_MOUSE_MOTION;
+        mouse = true;
+        x = event->motion.x;
+        y = event->motion.y;
+        n += put_mouse_delta(w, rec + n, x, y);
+        break;
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        rec[n++] = event->type == SDL_MOUSEBUTTONDOWN ? REPLAY_MOUSE_DOWN : REPLAY_MOUSE_UP;
+        rec[n++] = event->button.button;
+        mouse = true;
+        x = event->button.x;
+        y = event->button.y;
+        n += put_mouse_delta(w, rec + n, x, y);
+        break;
+    default:
+        return;
+    }
+    if (produce(w, tick, rec, n) == 0 && mouse) {
+        w->mouse_x = x;
+        w->mouse_y = y;
+    }
+}
+
+int replay_writer_close(ReplayWriter *w, Uint32 tick)
+{
+    if (!w)
+        return -1;
+    Uint8 end = REPLAY_END;
+    (void)produce(w, tick < w->last_tick ? w->last_tick : tick, &end, 1);
+    SDL_AtomicSet(&w->quit, 1);
+    SDL_SemPost(w->wake);
+    SDL_WaitThread(w->thread, NULL);
+    int status = 0;
+    if (fclose(w->file) != 0 || w->io_error) {
+        fprintf(stderr, "replay: write failed\n");
+        status = -1;
+    }
+    if (w->dropped > 0) {
+        fprintf(stderr, "replay: %d records dropped; the session will not replay exactly\n", w->dropped);
+        status = -1;
+    }
+    SDL_DestroySemaphore(w->wake);
+    free(w);
+    return status;
+}
+
+struct ReplayReader {
+    FILE     *file;   /* stdio reads it a block at a time */
+    Uint32    seed;
+    float     tick_s;
+    Uint32    tick;   /* of the pending record, or the end */
+    SDL_Event pending;
+    bool      has_pending;
+    bool      ended;
+    bool      damaged;
+    Sint32    mouse_x;
+    Sint32    mouse_y;
+};
+
+ReplayReader *replay_reader_open(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "replay: cannot open '%s'\n", path);
+        return NULL;
+    }
+    Uint8 header[13];
+    if (fread(header, 1, sizeof header, f) != sizeof header || memcmp(header, REPLAY_MAGIC, 4) != 0 ||
+        header[4] != REPLAY_VERSION) {
+        fprintf(stderr, "replay: '%s' is not a version %d replay\n", path, REPLAY_VERSION);
+        fclose(f);
+        return NULL;
+    }
+    ReplayReader *r = calloc(1, sizeof(ReplayReader));
+    if (!r) {
+        fclose(f);
+        return NULL;
+    }
+    r->file = f;
+    r->seed = get_u32(header + 5);
+    Uint32 tick_bits = get_u32(header + 9);
+    memcpy(&r->tick_s, &tick_bits, sizeof r->tick_s);
+    return r;
+}
+
+void replay_reader_close(ReplayReader *r)
+{
+    if (!r)
+        return;
+    fclose(r->file);
+    free(r);
+}
+
+Uint32 replay_reader_seed(const ReplayReader *r)
+{
+    return r ? r->seed : 0;
+}
+
+float replay_reader_tick(const ReplayReader *r)
+{
+    return r ? r->tick_s : 0.0f;
+}
+
+/* Returns -1 at the end of the file or on an overlong varint. */
+static int get_varint(ReplayReader *r, Uint32 *out)
+{
+    Uint32 v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        int c = fgetc(r->file);
+        if (c == EOF)
+            return -1;
+        v |= (Uint32)(c & 0x7f) << shift;
+        if (!(c & 0x80)) {
+            *out = v;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int get_mouse(ReplayReader *r, Sint32 *x, Sint32 *y)
+{
+    Uint32 dx, dy;
+    if (get_varint(r, &dx) != 0 || get_varint(r, &dy) != 0)
+        return -1;
+    r->mouse_x += unzigzag(dx);
+    r->mouse_y += unzigzag(dy);
+    *x = r->mouse_x;
+    *y = r->mouse_y;
+    return 0;
+}
+
+/* Decodes the next record into pending. A file cut short (a crash while
+ * recording) ends the session at its last whole record. */
+static void read_record(ReplayReader *r)
+{
+    Uint32 delta, a = 0, b = 0;
+    int kind = EOF;
+    if (get_varint(r, &delta) != 0 || (kind = fgetc(r->file)) == EOF) {
+        r->ended = true;
+        return;
+    }
+    r->tick += delta;
+    SDL_Event *ev = &r->pending;
+    memset(ev, 0, sizeof *ev);
+    int ok = 0;
+    switch (kind & REPLAY_KIND_MASK) {
+    case REPLAY_KEY_DOWN:
+    case REPLAY_KEY_UP:
+        ok = get_varint(r, &a) == 0 && get_varint(r, &b) == 0;
+        ev->type = (kind & REPLAY_KIND_MASK) == REPLAY_KEY_DOWN ? SDL_KEYDOWN : SDL_KEYUP;
+        ev->key.state = ev->type == SDL_KEYDOWN ? SDL_PRESSED : SDL_RELEASED;
+        ev->key.repeat = (kind & REPLAY_REPEAT) ? 1 : 0;
+        ev->key.keysym.sym = (SDL_Keycode)a;
+        ev->key.keysym.mod = (Uint16)b;
+        break;
+    case REPLAY_MOUSE_MOTION: {
+        Sint32 x0 = r->mouse_x, y0 = r->mouse_y;
+        ev->type = SDL_MOUSEMOTION;
+        ok = get_mouse(r, &ev->motion.x, &ev->motion.y) == 0;
+        ev->motion.xrel = ev->motion.x - x0;
+        ev->motion.yrel = ev->motion.y - y0;
+        break;
+    }
+    case REPLAY_MOUSE_DOWN:
+    case REPLAY_MOUSE_UP: {
+        int button = fgetc(r->file);
+        ev->type = (kind & REPLAY_KIND_MASK) == REPLAY_MOUSE_DOWN ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+        ev->button.state = ev->type == SDL_MOUSEBUTTONDOWN ? SDL_PRESSED : SDL_RELEASED;
+        ev->button.button = (Uint8)button;
+        ev->button.clicks = 1;
+        ok = button != EOF && get_mouse(r, &ev->button.x, &ev->button.y) == 0;
+        break;
+    }
+    case REPLAY_END:
+        r->ended = true;
+        return;
+    default:
+        r->damaged = true;
+        r->ended = true;
+        return;
+    }
+    if (!ok) {
+        r->tick -= delta;
+        r->ended = true;
+        return;
+    }
+    r->has_pending = true;
+}
+
+int replay_reader_next(ReplayReader *r, Uint32 tick, SDL_Event *out)
+{
+    if (!r->has_pending && !r->ended)
+        read_record(r);
+    if (r->damaged)
+        return -1;
+    if (!r->has_pending || r->tick > tick)
+        return 0;
+    *out = r->pending;
+    out->common.timestamp = SDL_GetTicks();
+    r->has_pending = false;
+    return 1;
+}
+
+bool replay_reader_done(const ReplayReader *r, Uint32 tick)
+{
+    return r->ended && !r->has_pending && tick >= r->tick;
+}
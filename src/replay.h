@@ -0,0 +1,56 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <SDL.h>
+#include <stdbool.h>
+
+/* Recorded sessions: the minigame seed, the tick length, and every key and
+ * mouse event the scene received, indexed by simulation tick. Replaying them into a scene
+ * created with the same seed and stepped by the same ticks reproduces the
+ * session exactly.
+ *
+ * File: "WWRP", version byte, seed (u32 LE), tick in seconds (float32 LE),
+ * then records. Each record is a varint tick delta from the previous record
+ * and a kind byte (0x10 set for key repeats), then:
+ *   key down/up:    varint keycode, varint modifiers
+ *   mouse motion:   zigzag varint dx, dy from the last mouse position
+ *   mouse down/up:  button byte, zigzag varint dx, dy
+ *   end:            nothing; its tick is the session length
+ * A keypress a second apart costs about four bytes. */
+
+/* Writes a session from the simulation's thread. Records are encoded into a
+ * ring and written out by a background thread, so recording never waits on
+ * the disk; if the ring fills, records are dropped and counted. */
+typedef struct ReplayWriter ReplayWriter;
+
+/* Returns NULL if the file cannot be created. */
+ReplayWriter *replay_writer_open(const char *path, Uint32 seed, float tick_s);
+
+/* Records event as applied before update number tick (ticks never go back).
+ * Ignores events that are not key or mouse input. */
+void replay_writer_event(ReplayWriter *writer, Uint32 tick, const SDL_Event *event);
+
+/* Writes the end record at tick, flushes, and frees the writer. Returns 0 if
+ * every record reached the file. */
+int replay_writer_close(ReplayWriter *writer, Uint32 tick);
+
+/* Streams a session back, reading the file a block at a time. */
+typedef struct ReplayReader ReplayReader;
+
+/* Returns NULL if the file is missing or not a replay. */
+ReplayReader *replay_reader_open(const char *path);
+
+void replay_reader_close(ReplayReader *reader);
+
+Uint32 replay_reader_seed(const ReplayReader *reader);
+float replay_reader_tick(const ReplayReader *reader);
+
+/* The next event due before update number tick: returns 1 and fills out,
+ * 0 when nothing more is due this tick, -1 on a damaged file. */
+int replay_reader_next(ReplayReader *reader, Uint32 tick, SDL_Event *out);
+
+/* True once the end record (or the end of the file) has been reached and
+ * tick has passed it: the session is over. */
+bool replay_reader_done(const ReplayReader *reader, Uint32 tick);
+
+#endif /* REPLAY_H */
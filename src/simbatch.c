@@ -0,0 +1,445 @@
+#include "simbatch.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIM_X86 1
+#include <emmintrin.h>
+#endif
+
+/* Sessions per pool task. About 40 bytes each, so a chunk's arrays stay in
+ * L2 across all the ticks of a run. Multiple of 4. */
+#define SIM_CHUNK        4096
+/* Ticks between checks for a chunk whose sessions have all ended. */
+#define SIM_ALIVE_CHECK  64
+/* Top 24 bits of the generator as a float in [0, 1). */
+#define SIM_RNG_SCALE    (1.0f / 16777216.0f)
+
+/* Ordered so most transitions are state + 1. */
+enum { SIM_IDLE, SIM_OPENING, SIM_GAME, SIM_CLOSING, SIM_OVER };
+
+typedef void (*SimStepFn)(SimBatch *batch, int begin, int end, float dt, float now);
+
+struct SimBatch {
+    /* Hot: one entry per session, padded to a multiple of 4. */
+    Sint32 *state;
+    float  *timer;   /* seconds left in the current state */
+    float  *dur;     /* timer of the next game */
+    float  *speed;
+    Sint32 *floor;
+    Sint32 *lives;
+    Sint32 *won;     /* all bits set if the game in progress is won */
+    Uint32 *rng;     /* xorshift32 */
+    float  *over_s;  /* session time when the last life went */
+    /* Cold */
+    int        sessions;
+    int        lanes;
+    int        chunks;
+    Uint64    *chunk_steps;
+    SimRules   rules;
+    SimConfig *configs;
+    int        config_count;
+    double     time_s;
+    int        run_ticks;
+    float      run_dt;
+    SimStepFn  step;
+    const char *kernel;
+};
+
+void sim_rules_default(SimRules *rules)
+{
+    *rules = (SimRules){
+        .door_s      = 10 * 0.08f,
+        .idle_s      = 0.5f,
+        .react_min_s = 0.3f,
+        .react_max_s = 1.2f,
+        .input_share = 0.5f,
+        .min_timer_s = 1.0f,
+        .lives       = 4,
+    };
+}
+
+static Uint32 xorshift32(Uint32 x)
+{
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+/* The scalar and SSE2 steps do the same float operations in the same order,
+ * so a batch gives identical results on either. One transition per session
+ * per tick; the overshoot carries into the next state's timer. */
+static void step_scalar(SimBatch *b, int begin, int end, float dt, float now)
+{
+    const SimRules *r = &b->rules;
+    const float span = r->react_max_s - r->react_min_s;
+    for (int i = begin; i < end; i++) {
+        Sint32 state = b->state[i];
+        float timer = b->timer[i] - dt;
+        if (timer > 0.0f || state == SIM_OVER) {
+            b->timer[i] = timer;
+            continue;
+        }
+        switch (state) {
+        case SIM_IDLE:
+            state = SIM_OPENING;
+            timer = timer + r->door_s;
+            break;
+        case SIM_OPENING: {
+            /* Which game comes up, and how fast the player answers it. */
+            Uint32 x1 = xorshift32(b->rng[i]);
+            Uint32 x2 = xorshift32(x1);
+            float u = (float)(Sint32)(x1 >> 8) * SIM_RNG_SCALE;
+            float v = (float)(Sint32)(x2 >> 8) * SIM_RNG_SCALE;
+            float dur = b->dur[i];
+            float react = r->react_min_s + v * span;
+            bool need = u < r->input_share;
+            b->won[i] = (!need || react < dur) ? -1 : 0;
+            b->rng[i] = x2;
+            state = SIM_GAME;
+            timer = timer + (need ? (react < dur ? react : dur) : dur);
+            break;
+        }
+        case SIM_GAME:
+            if (b->won[i]) {
+                b->floor[i]++;
+                float dur = b->dur[i] * b->speed[i];
+                b->dur[i] = dur > r->min_timer_s ? dur : r->min_timer_s;
+            } else {
+                b->lives[i]--;
+            }
+            state = SIM_CLOSING;
+            if (b->lives[i] < 1) {
+                state = SIM_OVER;
+                b->over_s[i] = now;
+            }
+            timer = timer + r->door_s;
+            break;
+        case SIM_CLOSING:
+            state = SIM_IDLE;
+            timer = timer + r->idle_s;
+            break;
+        }
+        b->state[i] = state;
+        b->timer[i] = timer;
+    }
+}
+
+#ifdef SIM_X86
+__attribute__((target("sse2")))
+static __m128i xorshift32_sse2(__m128i x)
+{
+    x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+    x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+    return _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+}
+
+__attribute__((target("sse2")))
+static __m128 select_ps(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+__attribute__((target("sse2")))
+static __m128i select_epi32(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/* Every transition is computed for all four sessions and masked in. */
+__attribute__((target("sse2")))
+static void step_sse2(SimBatch *b, int begin, int end, float dt, float now)
+{
+    const SimRules *r = &b->rules;
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 vnow = _mm_set1_ps(now);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 door = _mm_set1_ps(r->door_s);
+    const __m128 idle_s = _mm_set1_ps(r->idle_s);
+    const __m128 react_min = _mm_set1_ps(r->react_min_s);
+    const __m128 span = _mm_set1_ps(r->react_max_s - r->react_min_s);
+    const __m128 share = _mm_set1_ps(r->input_share);
+    const __m128 min_timer = _mm_set1_ps(r->min_timer_s);
+    const __m128 scale = _mm_set1_ps(SIM_RNG_SCALE);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i s_idle = _mm_set1_epi32(SIM_IDLE);
+    const __m128i s_opening = _mm_set1_epi32(SIM_OPENING);
+    const __m128i s_game = _mm_set1_epi32(SIM_GAME);
+    const __m128i s_closing = _mm_set1_epi32(SIM_CLOSING);
+    const __m128i s_over = _mm_set1_epi32(SIM_OVER);
+    for (int i = begin; i < end; i += 4) {
+        __m128i state = _mm_loadu_si128((const __m128i *)(b->state + i));
+        __m128 timer = _mm_sub_ps(_mm_loadu_ps(b->timer + i), vdt);
+        __m128i fire = _mm_andnot_si128(_mm_cmpeq_epi32(state, s_over), _mm_castps_si128(_mm_cmple_ps(timer, zero)));
+        if (_mm_movemask_epi8(fire) == 0) {
+            _mm_storeu_ps(b->timer + i, timer);
+            continue;
+        }
+        __m128i idle = _mm_and_si128(fire, _mm_cmpeq_epi32(state, s_idle));
+        __m128i open = _mm_and_si128(fire, _mm_cmpeq_epi32(state, s_opening));
+        __m128i game = _mm_and_si128(fire, _mm_cmpeq_epi32(state, s_game));
+        __m128i closing = _mm_and_si128(fire, _mm_cmpeq_epi32(state, s_closing));
+
+        /* Doors open: draw the game and the player's answer. */
+        __m128i rng = _mm_loadu_si128((const __m128i *)(b->rng + i));
+        __m128i x1 = xorshift32_sse2(rng);
+        __m128i x2 = xorshift32_sse2(x1);
+        __m128 u = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(x1, 8)), scale);
+        __m128 v = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(x2, 8)), scale);
+        __m128 dur = _mm_loadu_ps(b->dur + i);
+        __m128 react = _mm_add_ps(react_min, _mm_mul_ps(v, span));
+        __m128 need = _mm_cmplt_ps(u, share);
+        __m128 in_time = _mm_cmplt_ps(react, dur);
+        __m128 game_s = select_ps(need, _mm_min_ps(react, dur), dur);
+        __m128i won_new = _mm_castps_si128(_mm_or_ps(_mm_cmpnlt_ps(u, share), in_time));
+        _mm_storeu_si128((__m128i *)(b->rng + i), select_epi32(open, x2, rng));
+
+        /* Game ends: a floor up and a faster timer, or a life down. */
+        __m128i won = _mm_loadu_si128((const __m128i *)(b->won + i));
+        __m128i game_won = _mm_and_si128(game, won);
+        __m128i game_lost = _mm_andnot_si128(won, game);
+        _mm_storeu_si128((__m128i *)(b->won + i), select_epi32(open, won_new, won));
+        __m128i floor = _mm_sub_epi32(_mm_loadu_si128((const __m128i *)(b->floor + i)), game_won);
+        __m128i lives = _mm_add_epi32(_mm_loadu_si128((const __m128i *)(b->lives + i)), game_lost);
+        _mm_storeu_si128((__m128i *)(b->floor + i), floor);
+        _mm_storeu_si128((__m128i *)(b->lives + i), lives);
+        __m128 faster = _mm_max_ps(_mm_mul_ps(dur, _mm_loadu_ps(b->speed + i)), min_timer);
+        _mm_storeu_ps(b->dur + i, select_ps(_mm_castsi128_ps(game_won), faster, dur));
+        __m128i dead = _mm_and_si128(game, _mm_cmplt_epi32(lives, one));
+        _mm_storeu_ps(b->over_s + i, select_ps(_mm_castsi128_ps(dead), vnow, _mm_loadu_ps(b->over_s + i)));
+
+        /* Next state: +1, except closing → idle and a lost last life → over. */
+        state = _mm_sub_epi32(state, fire);
+        state = _mm_andnot_si128(closing, state);
+        state = _mm_sub_epi32(state, dead);
+        _mm_storeu_si128((__m128i *)(b->state + i), state);
+
+        __m128 add = _mm_or_ps(_mm_and_ps(_mm_castsi128_ps(_mm_or_si128(idle, game)), door),
+                               _mm_or_ps(_mm_and_ps(_mm_castsi128_ps(open), game_s),
+                                         _mm_and_ps(_mm_castsi128_ps(closing), idle_s)));
+        timer = select_ps(_mm_castsi128_ps(fire), _mm_add_ps(timer, add), timer);
+        _mm_storeu_ps(b->timer + i, timer);
+    }
+}
+#endif
+
+#define ALLOC(field)                                                        \
+    do {                                                                    \
+        batch->field = calloc((size_t)batch->lanes, sizeof *batch->field);  \
+        if (!batch->field)                                                  \
+            goto fail;                                                      \
+    } while (0)
+
+SimBatch *sim_batch_create(int sessions, const SimRules *rules, const SimConfig *configs, int config_count,
+                           Uint32 seed)
+{
+    if (sessions <= 0 || !rules || !configs || config_count <= 0 || rules->lives <= 0)
+        return NULL;
+    SimBatch *batch = calloc(1, sizeof(SimBatch));
+    if (!batch)
+        return NULL;
+    batch->sessions = sessions;
+    batch->lanes = (sessions + 3) & ~3;
+    batch->chunks = (batch->lanes + SIM_CHUNK - 1) / SIM_CHUNK;
+    batch->rules = *rules;
+    batch->config_count = config_count;
+    ALLOC(state);
+    ALLOC(timer);
+    ALLOC(dur);
+    ALLOC(speed);
+    ALLOC(floor);
+    ALLOC(lives);
+    ALLOC(won);
+    ALLOC(rng);
+    ALLOC(over_s);
+    batch->chunk_steps = calloc((size_t)batch->chunks, sizeof(Uint64));
+    batch->configs = malloc((size_t)config_count * sizeof(SimConfig));
+    if (!batch->chunk_steps || !batch->configs)
+        goto fail;
+    memcpy(batch->configs, configs, (size_t)config_count * sizeof(SimConfig));
+
+    batch->step = step_scalar;
+    batch->kernel = "scalar";
+#ifdef SIM_X86
+    if (SDL_HasSSE2()) {
+        batch->step = step_sse2;
+        batch->kernel = "sse2";
+    }
+#endif
+    sim_batch_reset(batch, seed);
+    return batch;
+
+fail:
+    fprintf(stderr, "Out of memory for %d simulated sessions\n", sessions);
+    sim_batch_destroy(batch);
+    return NULL;
+}
+
+#undef ALLOC
+
+void sim_batch_destroy(SimBatch *batch)
+{
+    if (!batch)
+        return;
+    free(batch->state);
+    free(batch->timer);
+    free(batch->dur);
+    free(batch->speed);
+    free(batch->floor);
+    free(batch->lives);
+    free(batch->won);
+    free(batch->rng);
+    free(batch->over_s);
+    free(batch->chunk_steps);
+    free(batch->configs);
+    free(batch);
+}
+
+void sim_batch_reset(SimBatch *batch, Uint32 seed)
+{
+    if (!batch)
+        return;
+    batch->time_s = 0.0;
+    for (int i = 0; i < batch->lanes; i++) {
+        const SimConfig *c = &batch->configs[i % batch->config_count];
+        /* Padding lanes start out over and are never counted. */
+        batch->state[i]  = i < batch->sessions ? SIM_IDLE : SIM_OVER;
+        batch->timer[i]  = batch->rules.idle_s;
+        batch->dur[i]    = c->timer_s;
+        batch->speed[i]  = c->speedup;
+        batch->floor[i]  = 1;
+        batch->lives[i]  = batch->rules.lives;
+        batch->won[i]    = 0;
+        batch->over_s[i] = 0.0f;
+        /* Spread the seed over the sessions; xorshift must not start at 0. */
+        Uint32 x = seed ^ ((Uint32)i * 0x9E3779B9u);
+        x = xorshift32(x ? x : 1u);
+        batch->rng[i] = xorshift32(x);
+    }
+}
+
+static bool any_alive(const SimBatch *b, int begin, int end)
+{
+    for (int i = begin; i < end; i++)
+        if (b->state[i] != SIM_OVER)
+            return true;
+    return false;
+}
+
+static void run_chunk(void *user, int chunk)
+{
+    SimBatch *b = user;
+    int begin = chunk * SIM_CHUNK;
+    int end = begin + SIM_CHUNK < b->lanes ? begin + SIM_CHUNK : b->lanes;
+    int counted = (end < b->sessions ? end : b->sessions) - begin;
+    Uint64 steps = 0;
+    for (int k = 0; k < b->run_ticks; k++) {
+        if (k % SIM_ALIVE_CHECK == 0 && !any_alive(b, begin, end))
+            break;
+        float now = (float)(b->time_s + (double)(k + 1) * (double)b->run_dt);
+        b->step(b, begin, end, b->run_dt, now);
+        steps += (Uint64)counted;
+    }
+    b->chunk_steps[chunk] = steps;
+}
+
+Uint64 sim_batch_run(SimBatch *batch, WorkPool *pool, int ticks, float dt)
+{
+    if (!batch || ticks <= 0 || dt <= 0.0f)
+        return 0;
+    batch->run_ticks = ticks;
+    batch->run_dt = dt;
+    work_pool_run(pool, batch->chunks, run_chunk, batch);
+    batch->time_s += (double)ticks * (double)dt;
+    Uint64 steps = 0;
+    for (int c = 0; c < batch->chunks; c++)
+        steps += batch->chunk_steps[c];
+    return steps;
+}
+
+int sim_batch_alive(const SimBatch *batch)
+{
+    int alive = 0;
+    for (int i = 0; batch && i < batch->sessions; i++)
+        alive += batch->state[i] != SIM_OVER;
+    return alive;
+}
+
+void sim_batch_get_stats(const SimBatch *batch, int config, SimStats *out)
+{
+    if (!out)
+        return;
+    *out = (SimStats){ 0 };
+    if (!batch || config >= batch->config_count)
+        return;
+
+    int first = config < 0 ? 0 : config;
+    int stride = config < 0 ? 1 : batch->config_count;
+    double floor_sum = 0.0, over_sum = 0.0;
+    for (int i = first; i < batch->sessions; i += stride) {
+        int floor = batch->floor[i];
+        out->sessions++;
+        floor_sum += floor;
+        out->wins += (Uint64)(floor - 1);
+        out->lives_lost += (Uint64)(batch->rules.lives - batch->lives[i]);
+        if (floor > out->max_floor)
+            out->max_floor = floor;
+        if (batch->state[i] == SIM_OVER) {
+            out->game_overs++;
+            over_sum += batch->over_s[i];
+        }
+    }
+    if (out->sessions == 0)
+        return;
+    out->mean_floor = floor_sum / (double)out->sessions;
+    if (out->game_overs > 0)
+        out->mean_over_s = over_sum / (double)out->game_overs;
+
+    /* Floors reached, counted per floor: the median and the survival curve. */
+    int *reached = calloc((size_t)out->max_floor + 1, sizeof(int));
+    if (!reached) {
+        fprintf(stderr, "Out of memory for simulation stats\n");
+        return;
+    }
+    for (int i = first; i < batch->sessions; i += stride)
+        reached[batch->floor[i]]++;
+    int median = (int)(0.5 * (double)(out->sessions - 1) + 0.5);
+    int at_least = out->sessions, below = 0;
+    out->p50_floor = out->max_floor;
+    for (int f = 1; f <= out->max_floor; f++) {
+        if (f - 1 < SIM_SURVIVAL_FLOORS)
+            out->survival[f - 1] = (double)at_least / (double)out->sessions;
+        if (below <= median && median < below + reached[f])
+            out->p50_floor = f;
+        below += reached[f];
+        at_least -= reached[f];
+    }
+    free(reached);
+}
+
+const char *sim_batch_kernel(const SimBatch *batch)
+{
+    return batch ? batch->kernel : "scalar";
+}
+
+int sim_batch_set_kernel(SimBatch *batch, const char *name)
+{
+    if (!batch || !name)
+        return -1;
+    if (strcmp(name, "scalar") == 0) {
+        batch->step = step_scalar;
+        batch->kernel = "scalar";
+        return 0;
+    }
+#ifdef SIM_X86
+    if (strcmp(name, "sse2") == 0 && SDL_HasSSE2()) {
+        batch->step = step_sse2;
+        batch->kernel = "sse2";
+        return 0;
+    }
+#endif
+    return -1;
+}
@@ -0,0 +1,84 @@
+#ifndef SIMBATCH_H
+#define SIMBATCH_H
+
+#include "pool.h"
+#include <SDL.h>
+
+/* Render-free elevator runs for balancing: many independent sessions held in
+ * parallel arrays and stepped together, four per SSE2 instruction, with the
+ * sessions split into chunks that a work pool spreads over the cores.
+ *
+ * A session follows the scene's rules without its assets or renderer:
+ * idle → doors opening → minigame → doors closing → idle. A won game climbs
+ * a floor and, unlike the scene, shortens the next game's timer by the
+ * session's speed-up; a lost one costs a life, and the last life ends the
+ * session (the scene would start over). Players are scripted or random: they
+ * press SPACE idle_s after the doors close, and answer a game that needs
+ * input after a reaction time drawn from [react_min_s, react_max_s]. */
+typedef struct SimBatch SimBatch;
+
+typedef struct SimRules {
+    float door_s;       /* doors opening, and again closing */
+    float idle_s;       /* player's wait before pressing SPACE */
+    float react_min_s;  /* reaction to a game that needs input; equal = scripted */
+    float react_max_s;
+    float input_share;  /* games that need input to win; the rest are won by waiting */
+    float min_timer_s;  /* speed-up stops here */
+    int   lives;
+} SimRules;
+
+/* Defaults matching the scene: 10 door frames of 0.08s, 4 lives, and one of
+ * the two built-in games needing a press. */
+void sim_rules_default(SimRules *rules);
+
+/* One difficulty setting under test. Session i plays configs[i % count]. */
+typedef struct SimConfig {
+    float timer_s;  /* first game's timer (the scene's is 3s) */
+    float speedup;  /* timer multiplier per floor climbed; 1 = constant */
+} SimConfig;
+
+/* Floors tracked by the survival curve; higher floors count as the last. */
+#define SIM_SURVIVAL_FLOORS  64
+
+typedef struct SimStats {
+    int    sessions;
+    int    game_overs;      /* sessions out of lives */
+    double mean_floor;      /* floors start at 1, as in the scene */
+    int    p50_floor;
+    int    max_floor;
+    Uint64 wins;
+    Uint64 lives_lost;
+    double mean_over_s;     /* session length, over those that ended */
+    /* survival[f]: share of sessions that reached floor f + 1 */
+    double survival[SIM_SURVIVAL_FLOORS];
+} SimStats;
+
+/* Returns NULL on bad arguments or allocation failure. configs is copied. */
+SimBatch *sim_batch_create(int sessions, const SimRules *rules, const SimConfig *configs, int config_count,
+                           Uint32 seed);
+
+void sim_batch_destroy(SimBatch *batch);
+
+/* Every session back to floor 1 with full lives, players reseeded. */
+void sim_batch_reset(SimBatch *batch, Uint32 seed);
+
+/* Steps every session `ticks` times by dt, on the pool's workers (NULL runs
+ * on this thread). Chunks whose sessions have all ended stop early. Returns
+ * the session steps actually taken. */
+Uint64 sim_batch_run(SimBatch *batch, WorkPool *pool, int ticks, float dt);
+
+/* Sessions still playing. */
+int sim_batch_alive(const SimBatch *batch);
+
+/* Statistics over the sessions playing configs[config], or all of them for
+ * config < 0. */
+void sim_batch_get_stats(const SimBatch *batch, int config, SimStats *out);
+
+/* "sse2" or "scalar". */
+const char *sim_batch_kernel(const SimBatch *batch);
+
+/* Forces a kernel by name; both give identical results. Returns -1 if it is
+ * not available here. */
+int sim_batch_set_kernel(SimBatch *batch, const char *name);
+
+#endif /* SIMBATCH_H */
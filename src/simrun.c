@@ -0,0 +1,255 @@
+/*
+ * Batch simulator: plays many elevator sessions at once with scripted or
+ * random players, no renderer or assets, to tune the game's difficulty.
+ * Every combination of --timer and --speedup is one configuration; the
+ * sessions are shared out between them and each configuration's results
+ * (floors reached, lives lost, survival curve) print as one line.
+ * With --scaling the same batch is rerun on 1, 2, 4 ... worker threads up
+ * to the core count, printing session steps per second for each.
+ * Build and run: make sim   (make bench-sim for the scaling run)
+ */
+#include "pool.h"
+#include "simbatch.h"
+#include <SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Timer and speed-up values per list option. */
+#define SIM_MAX_VALUES  16
+
+typedef struct {
+    int         sessions;
+    int         ticks;
+    float       dt;
+    float       timers[SIM_MAX_VALUES];
+    int         timer_count;
+    float       speedups[SIM_MAX_VALUES];
+    int         speedup_count;
+    SimRules    rules;
+    int         threads;   /* 0 = one per core */
+    int         scaling;   /* rerun on 1, 2, 4 ... threads */
+    const char *kernel;    /* force sse2 or scalar */
+    Uint32      seed;
+    int         json;      /* 1 = JSON lines, 0 = key=value lines */
+} SimOptions;
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [--sessions N] [--ticks N] [--dt SECONDS] [--timer S,S,...] [--speedup X,X,...]\n"
+            "       [--react-min S] [--react-max S] [--idle S] [--input-share F] [--min-timer S] [--lives N]\n"
+            "       [--threads N] [--scaling] [--kernel sse2|scalar] [--seed N] [--format json|kv]\n",
+            prog);
+}
+
+/* "3,2.5,2": returns the count, or -1 if malformed or too long. */
+static int parse_list(const char *val, float *out)
+{
+    int count = 0;
+    const char *p = val;
+    for (;;) {
+        char *end;
+        float v = strtof(p, &end);
+        if (end == p || v <= 0.0f || count == SIM_MAX_VALUES)
+            return -1;
+        out[count++] = v;
+        if (*end == '\0')
+            return count;
+        if (*end != ',')
+            return -1;
+        p = end + 1;
+    }
+}
+
+static int parse_args(int argc, char **argv, SimOptions *opt)
+{
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--scaling") == 0) {
+            opt->scaling = 1;
+            continue;
+        }
+        if (!val) {
+            usage(argv[0]);
+            return -1;
+        }
+        if (strcmp(arg, "--sessions") == 0)
+            opt->sessions = (int)strtol(val, NULL, 10);
+        else if (strcmp(arg, "--ticks") == 0)
+            opt->ticks = (int)strtol(val, NULL, 10);
+        else if (strcmp(arg, "--dt") == 0)
+            opt->dt = strtof(val, NULL);
+        else if (strcmp(arg, "--timer") == 0)
+            opt->timer_count = parse_list(val, opt->timers);
+        else if (strcmp(arg, "--speedup") == 0)
+            opt->speedup_count = parse_list(val, opt->speedups);
+        else if (strcmp(arg, "--react-min") == 0)
+            opt->rules.react_min_s = strtof(val, NULL);
+        else if (strcmp(arg, "--react-max") == 0)
+            opt->rules.react_max_s = strtof(val, NULL);
+        else if (strcmp(arg, "--idle") == 0)
+            opt->rules.idle_s = strtof(val, NULL);
+        else if (strcmp(arg, "--input-share") == 0)
+            opt->rules.input_share = strtof(val, NULL);
+        else if (strcmp(arg, "--min-timer") == 0)
+            opt->rules.min_timer_s = strtof(val, NULL);
+        else if (strcmp(arg, "--lives") == 0)
+            opt->rules.lives = (int)strtol(val, NULL, 10);
+        else if (strcmp(arg, "--threads") == 0)
+            opt->threads = (int)strtol(val, NULL, 10);
+        else if (strcmp(arg, "--kernel") == 0)
+            opt->kernel = val;
+        else if (strcmp(arg, "--seed") == 0)
+            opt->seed = (Uint32)strtoul(val, NULL, 0);
+        else if (strcmp(arg, "--format") == 0)
+            opt->json = strcmp(val, "json") == 0;
+        else {
+            usage(argv[0]);
+            return -1;
+        }
+        i++;
+    }
+    const SimRules *r = &opt->rules;
+    if (opt->sessions <= 0 || opt->ticks <= 0 || opt->dt <= 0.0f || opt->timer_count <= 0 ||
+        opt->speedup_count <= 0 || opt->threads < 0 || r->react_min_s < 0.0f || r->react_max_s < r->react_min_s ||
+        r->idle_s < 0.0f || r->input_share < 0.0f || r->input_share > 1.0f || r->lives <= 0) {
+        usage(argv[0]);
+        return -1;
+    }
+    return 0;
+}
+
+/* Runs the batch from the start on a pool of `threads`. Returns -1 if the
+ * pool cannot be created. */
+static int run_batch(SimBatch *batch, const SimOptions *opt, int threads, Uint64 *steps, double *elapsed,
+                     WorkPoolStats *pool_stats)
+{
+    WorkPool *pool = work_pool_create(threads);
+    if (!pool)
+        return -1;
+    sim_batch_reset(batch, opt->seed);
+    Uint64 start = SDL_GetPerformanceCounter();
+    *steps = sim_batch_run(batch, pool, opt->ticks, opt->dt);
+    *elapsed = (double)(SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+    work_pool_get_stats(pool, pool_stats);
+    work_pool_destroy(pool);
+    return 0;
+}
+
+static void print_config(const SimOptions *opt, const SimConfig *config, const SimStats *s)
+{
+    /* The curve stops at the highest floor anyone reached. */
+    int floors = s->max_floor < SIM_SURVIVAL_FLOORS ? s->max_floor : SIM_SURVIVAL_FLOORS;
+    if (opt->json) {
+        printf("{\"timer_s\":%.3f,\"speedup\":%.3f,\"sessions\":%d,\"game_overs\":%d,"
+               "\"mean_floor\":%.3f,\"p50_floor\":%d,\"max_floor\":%d,\"wins\":%llu,\"lives_lost\":%llu,"
+               "\"mean_game_over_s\":%.3f,\"survival\":[",
+               config->timer_s, config->speedup, s->sessions, s->game_overs,
+               s->mean_floor, s->p50_floor, s->max_floor, (unsigned long long)s->wins,
+               (unsigned long long)s->lives_lost, s->mean_over_s);
+        for (int f = 0; f < floors; f++)
+            printf("%s%.4f", f ? "," : "", s->survival[f]);
+        printf("]}\n");
+    } else {
+        printf("timer_s=%.3f\nspeedup=%.3f\nsessions=%d\ngame_overs=%d\n",
+               config->timer_s, config->speedup, s->sessions, s->game_overs);
+        printf("mean_floor=%.3f\np50_floor=%d\nmax_floor=%d\nwins=%llu\nlives_lost=%llu\nmean_game_over_s=%.3f\n",
+               s->mean_floor, s->p50_floor, s->max_floor, (unsigned long long)s->wins,
+               (unsigned long long)s->lives_lost, s->mean_over_s);
+        printf("survival=");
+        for (int f = 0; f < floors; f++)
+            printf("%s%.4f", f ? "," : "", s->survival[f]);
+        printf("\n\n");
+    }
+}
+
+static void print_run(const SimOptions *opt, const SimBatch *batch, int threads, Uint64 steps, double elapsed,
+                      double base_rate, const WorkPoolStats *pool_stats)
+{
+    double rate = elapsed > 0.0 ? (double)steps / elapsed : 0.0;
+    double speedup = base_rate > 0.0 ? rate / base_rate : 1.0;
+    if (opt->json) {
+        printf("{\"sessions\":%d,\"ticks\":%d,\"dt\":%.6f,\"threads\":%d,\"kernel\":\"%s\",\"elapsed_s\":%.6f,"
+               "\"session_ticks\":%llu,\"session_ticks_per_s\":%.1f,\"scaling\":%.2f,\"tasks\":%llu,\"steals\":%llu}\n",
+               opt->sessions, opt->ticks, opt->dt, threads, sim_batch_kernel(batch), elapsed,
+               (unsigned long long)steps, rate, speedup,
+               (unsigned long long)pool_stats->tasks, (unsigned long long)pool_stats->steals);
+    } else {
+        printf("sessions=%d\nticks=%d\ndt=%.6f\nthreads=%d\nkernel=%s\nelapsed_s=%.6f\n",
+               opt->sessions, opt->ticks, opt->dt, threads, sim_batch_kernel(batch), elapsed);
+        printf("session_ticks=%llu\nsession_ticks_per_s=%.1f\nscaling=%.2f\ntasks=%llu\nsteals=%llu\n\n",
+               (unsigned long long)steps, rate, speedup,
+               (unsigned long long)pool_stats->tasks, (unsigned long long)pool_stats->steals);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    SimOptions opt = {
+        .sessions      = 100000,
+        .ticks         = 36000,  /* ten minutes at 60Hz */
+        .dt            = 1.0f / 60.0f,
+        .timers        = { 3.0f },
+        .timer_count   = 1,
+        .speedups      = { 0.95f },
+        .speedup_count = 1,
+        .seed          = 0x5741u,
+        .json          = 1,
+    };
+    sim_rules_default(&opt.rules);
+    if (parse_args(argc, argv, &opt) != 0)
+        return EXIT_FAILURE;
+
+    if (SDL_Init(0) != 0) {
+        fprintf(stderr, "SDL_Init: %s\n", SDL_GetError());
+        return EXIT_FAILURE;
+    }
+    int config_count = opt.timer_count * opt.speedup_count;
+    SimConfig configs[SIM_MAX_VALUES * SIM_MAX_VALUES];
+    for (int t = 0; t < opt.timer_count; t++)
+        for (int s = 0; s < opt.speedup_count; s++)
+            configs[t * opt.speedup_count + s] = (SimConfig){ opt.timers[t], opt.speedups[s] };
+    SimBatch *batch = sim_batch_create(opt.sessions, &opt.rules, configs, config_count, opt.seed);
+    if (!batch) {
+        fprintf(stderr, "Failed to set up %d sessions\n", opt.sessions);
+        SDL_Quit();
+        return EXIT_FAILURE;
+    }
+    if (opt.kernel && sim_batch_set_kernel(batch, opt.kernel) != 0)
+        fprintf(stderr, "Kernel '%s' unavailable; using %s\n", opt.kernel, sim_batch_kernel(batch));
+
+    int cores = SDL_GetCPUCount();
+    int max_threads = opt.threads > 0 ? opt.threads : cores;
+    int status = EXIT_SUCCESS;
+    double base_rate = 0.0;
+    /* Scaling: 1, 2, 4 ... then the top count itself. Every run starts from
+     * the same seed, so they all end with the same statistics. */
+    for (int threads = opt.scaling ? 1 : max_threads; threads <= max_threads;) {
+        Uint64 steps;
+        double elapsed;
+        WorkPoolStats pool_stats;
+        if (run_batch(batch, &opt, threads, &steps, &elapsed, &pool_stats) != 0) {
+            status = EXIT_FAILURE;
+            break;
+        }
+        if (base_rate == 0.0 && elapsed > 0.0)
+            base_rate = (double)steps / elapsed;
+        print_run(&opt, batch, threads, steps, elapsed, opt.scaling ? base_rate : 0.0, &pool_stats);
+        if (threads == max_threads)
+            break;
+        threads = threads * 2 < max_threads ? threads * 2 : max_threads;
+    }
+
+    if (status == EXIT_SUCCESS)
+        for (int c = 0; c < config_count; c++) {
+            SimStats stats;
+            sim_batch_get_stats(batch, c, &stats);
+            print_config(&opt, &configs[c], &stats);
+        }
+
+    sim_batch_destroy(batch);
+    SDL_Quit();
+    return status;
+}
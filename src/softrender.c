@@ -0,0 +1,414 @@
+#include "softrender.h"
+#include "chroma.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SOFT_X86 1
+#include <immintrin.h>
+#endif
+
+/* Spans work on RGBA32 pixels read as Uint32; alpha is the top byte on
+ * little-endian hosts, which is all the SIMD kernels are built for. */
+typedef void (*SpanFn)(Uint32 *dst, const Uint32 *src, int n);
+
+typedef struct {
+    SDL_Texture *key;
+    Uint32      *pixels;
+    int          w;
+    int          h;
+    int          binary_alpha;  /* every alpha is 0 or 255: a masked copy is enough */
+} SoftImage;
+
+struct SoftRenderer {
+    SDL_Renderer *renderer;
+    SDL_Texture  *texture;   /* streaming, w×h */
+    Uint32       *pixels;
+    int           w;
+    int           h;
+    Uint32       *scratch;   /* one row of gathered source pixels */
+    int          *xmap;      /* source column for each destination column */
+    SoftImage    *images;
+    int           image_count;
+    int           image_cap;
+    const char   *kernel_name;
+    SpanFn        span_key;
+    SpanFn        span_blend;
+};
+
+/* round(x / 255) for x in 0..65025, exact; the SIMD kernels use the same steps. */
+static inline Uint32 div255(Uint32 x)
+{
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+static void span_key_scalar(Uint32 *dst, const Uint32 *src, int n)
+{
+    for (int i = 0; i < n; i++) {
+        const Uint8 *s = (const Uint8 *)&src[i];
+        if (s[3])
+            dst[i] = src[i];
+    }
+}
+
+static inline Uint8 over(Uint32 s, Uint32 d, Uint32 ia)
+{
+    Uint32 x = s + div255(d * ia);
+    return (Uint8)(x > 255 ? 255 : x);
+}
+
+/* Premultiplied "over": out = s + d*(255-a) on every channel, saturating. */
+static void span_blend_scalar(Uint32 *dst, const Uint32 *src, int n)
+{
+    for (int i = 0; i < n; i++) {
+        const Uint8 *s = (const Uint8 *)&src[i];
+        Uint8 *d = (Uint8 *)&dst[i];
+        Uint32 ia = 255 - (Uint32)s[3];
+        if (s[3] == 0)
+            continue;
+        d[0] = over(s[0], d[0], ia);
+        d[1] = over(s[1], d[1], ia);
+        d[2] = over(s[2], d[2], ia);
+        d[3] = over(s[3], d[3], ia);
+    }
+}
+
+#ifdef SOFT_X86
+__attribute__((target("sse2")))
+static void span_key_sse2(Uint32 *dst, const Uint32 *src, int n)
+{
+    const __m128i amask = _mm_set1_epi32((int)0xFF000000u);
+    const __m128i zero = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        __m128i clear = _mm_cmpeq_epi32(_mm_and_si128(s, amask), zero);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_or_si128(_mm_and_si128(clear, d), _mm_andnot_si128(clear, s)));
+    }
+    span_key_scalar(dst + i, src + i, n - i);
+}
+
+/* Two pixels' worth of 16-bit channels: div255(d * ia). */
+__attribute__((target("sse2")))
+static inline __m128i scale_half_sse2(__m128i d, __m128i ia)
+{
+    const __m128i c128 = _mm_set1_epi16(128);
+    __m128i x = _mm_add_epi16(_mm_mullo_epi16(d, ia), c128);
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+/* The source needs no multiply, so only the destination is widened; the add
+ * back onto the source saturates in 8 bits like the scalar clamp. Pixels
+ * with a = 0 come out unchanged (ia = 255, s = 0). */
+__attribute__((target("sse2")))
+static void span_blend_sse2(Uint32 *dst, const Uint32 *src, int n)
+{
+    const __m128i c255 = _mm_set1_epi16(255);
+    const __m128i zero = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        /* Alpha in both 16-bit halves of each pixel, then spread to four lanes. */
+        __m128i a = _mm_srli_epi32(s, 24);
+        a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+        __m128i lo = scale_half_sse2(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(c255, _mm_unpacklo_epi32(a, a)));
+        __m128i hi = scale_half_sse2(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(c255, _mm_unpackhi_epi32(a, a)));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_adds_epu8(s, _mm_packus_epi16(lo, hi)));
+    }
+    span_blend_scalar(dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void span_key_avx2(Uint32 *dst, const Uint32 *src, int n)
+{
+    const __m256i amask = _mm256_set1_epi32((int)0xFF000000u);
+    const __m256i zero = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+        __m256i clear = _mm256_cmpeq_epi32(_mm256_and_si256(s, amask), zero);
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_blendv_epi8(s, d, clear));
+    }
+    span_key_sse2(dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i scale_half_avx2(__m256i d, __m256i ia)
+{
+    const __m256i c128 = _mm256_set1_epi16(128);
+    __m256i x = _mm256_add_epi16(_mm256_mullo_epi16(d, ia), c128);
+    return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+/* Same steps as the SSE2 kernel; unpack and pack both work per 128-bit lane,
+ * so pixels come back out in order. */
+__attribute__((target("avx2")))
+static void span_blend_avx2(Uint32 *dst, const Uint32 *src, int n)
+{
+    const __m256i c255 = _mm256_set1_epi16(255);
+    const __m256i zero = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+        __m256i a = _mm256_srli_epi32(s, 24);
+        a = _mm256_or_si256(a, _mm256_slli_epi32(a, 16));
+        __m256i lo = scale_half_avx2(_mm256_unpacklo_epi8(d, zero), _mm256_sub_epi16(c255, _mm256_unpacklo_epi32(a, a)));
+        __m256i hi = scale_half_avx2(_mm256_unpackhi_epi8(d, zero), _mm256_sub_epi16(c255, _mm256_unpackhi_epi32(a, a)));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_adds_epu8(s, _mm256_packus_epi16(lo, hi)));
+    }
+    span_blend_sse2(dst + i, src + i, n - i);
+}
+#endif
+
+int soft_renderer_set_kernels(SoftRenderer *soft, const char *name)
+{
+    if (!soft || !name)
+        return -1;
+    if (strcmp(name, "scalar") == 0) {
+        soft->span_key   = span_key_scalar;
+        soft->span_blend = span_blend_scalar;
+        soft->kernel_name = "scalar";
+        return 0;
+    }
+#ifdef SOFT_X86
+    if (strcmp(name, "sse2") == 0 && SDL_HasSSE2()) {
+        soft->span_key   = span_key_sse2;
+        soft->span_blend = span_blend_sse2;
+        soft->kernel_name = "sse2";
+        return 0;
+    }
+    if (strcmp(name, "avx2") == 0 && SDL_HasAVX2()) {
+        soft->span_key   = span_key_avx2;
+        soft->span_blend = span_blend_avx2;
+        soft->kernel_name = "avx2";
+        return 0;
+    }
+#endif
+    return -1;
+}
+
+const char *soft_renderer_kernels(const SoftRenderer *soft)
+{
+    return soft ? soft->kernel_name : "none";
+}
+
+SoftRenderer *soft_renderer_create(SDL_Renderer *renderer, int w, int h)
+{
+    if (!renderer || w <= 0 || h <= 0)
+        return NULL;
+    SoftRenderer *soft = calloc(1, sizeof(SoftRenderer));
+    if (!soft)
+        return NULL;
+    soft->renderer = renderer;
+    soft->w = w;
+    soft->h = h;
+    soft->pixels  = calloc((size_t)w * (size_t)h, sizeof(Uint32));
+    soft->scratch = calloc((size_t)w, sizeof(Uint32));
+    soft->xmap    = calloc((size_t)w, sizeof(int));
+    soft->texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, w, h);
+    if (!soft->pixels || !soft->scratch || !soft->xmap || !soft->texture) {
+        if (!soft->texture)
+            fprintf(stderr, "SDL_CreateTexture (soft %dx%d): %s\n", w, h, SDL_GetError());
+        soft_renderer_destroy(soft);
+        return NULL;
+    }
+    if (soft_renderer_set_kernels(soft, "avx2") != 0 && soft_renderer_set_kernels(soft, "sse2") != 0)
+        soft_renderer_set_kernels(soft, "scalar");
+    return soft;
+}
+
+void soft_renderer_destroy(SoftRenderer *soft)
+{
+    if (!soft)
+        return;
+    for (int i = 0; i < soft->image_count; i++)
+        free(soft->images[i].pixels);
+    free(soft->images);
+    if (soft->texture)
+        SDL_DestroyTexture(soft->texture);
+    free(soft->xmap);
+    free(soft->scratch);
+    free(soft->pixels);
+    free(soft);
+}
+
+static SoftImage *find_image(SoftRenderer *soft, SDL_Texture *key)
+{
+    for (int i = 0; i < soft->image_count; i++) {
+        if (soft->images[i].key == key)
+            return &soft->images[i];
+    }
+    return NULL;
+}
+
+int soft_renderer_add_image(SoftRenderer *soft, SDL_Texture *key, const void *rgba, int w, int h, int pitch,
+                            int premultiplied)
+{
+    if (!soft || !key || !rgba || w <= 0 || h <= 0)
+        return -1;
+    Uint32 *pixels = malloc((size_t)w * (size_t)h * sizeof(Uint32));
+    if (!pixels)
+        return -1;
+    int binary = 1;
+    for (int y = 0; y < h; y++) {
+        const Uint8 *row = (const Uint8 *)rgba + (size_t)y * (size_t)pitch;
+        memcpy(pixels + (size_t)y * (size_t)w, row, (size_t)w * sizeof(Uint32));
+        for (int x = 0; x < w && binary; x++) {
+            Uint8 a = row[x * 4 + 3];
+            binary = a == 0 || a == 255;
+        }
+    }
+    if (!premultiplied)
+        chroma_premultiply(pixels, w, h, w * (int)sizeof(Uint32));
+
+    SoftImage *img = find_image(soft, key);
+    if (!img) {
+        if (soft->image_count == soft->image_cap) {
+            int cap = soft->image_cap ? soft->image_cap * 2 : 8;
+            SoftImage *grown = realloc(soft->images, (size_t)cap * sizeof(SoftImage));
+            if (!grown) {
+                free(pixels);
+                return -1;
+            }
+            soft->images = grown;
+            soft->image_cap = cap;
+        }
+        img = &soft->images[soft->image_count++];
+    } else {
+        free(img->pixels);
+    }
+    *img = (SoftImage){ key, pixels, w, h, binary };
+    return 0;
+}
+
+void soft_renderer_remove_image(SoftRenderer *soft, SDL_Texture *key)
+{
+    SoftImage *img = soft ? find_image(soft, key) : NULL;
+    if (!img)
+        return;
+    free(img->pixels);
+    *img = soft->images[--soft->image_count];
+}
+
+static Uint32 pack_rgba(Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    Uint32 px;
+    Uint8 *c = (Uint8 *)&px;
+    c[0] = r; c[1] = g; c[2] = b; c[3] = a;
+    return px;
+}
+
+void soft_renderer_clear(SoftRenderer *soft, Uint8 r, Uint8 g, Uint8 b)
+{
+    soft_renderer_fill_rect(soft, NULL, r, g, b, 255);
+}
+
+void soft_renderer_fill_rect(SoftRenderer *soft, const SDL_Rect *rect, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    if (!soft || a == 0)
+        return;
+    SDL_Rect full = { 0, 0, soft->w, soft->h }, clip;
+    if (!rect)
+        clip = full;
+    else if (!SDL_IntersectRect(rect, &full, &clip))
+        return;
+
+    Uint32 color = pack_rgba((Uint8)div255(r * a), (Uint8)div255(g * a), (Uint8)div255(b * a), a);
+    if (a < 255) {
+        for (int x = 0; x < clip.w; x++)
+            soft->scratch[x] = color;
+    }
+    for (int y = clip.y; y < clip.y + clip.h; y++) {
+        Uint32 *row = soft->pixels + (size_t)y * (size_t)soft->w + clip.x;
+        if (a == 255) {
+            for (int x = 0; x < clip.w; x++)
+                row[x] = color;
+        } else {
+            soft->span_blend(row, soft->scratch, clip.w);
+        }
+    }
+}
+
+void soft_renderer_copy(SoftRenderer *soft, SDL_Texture *key, const SDL_Rect *src, const SDL_Rect *dst,
+                        Uint8 r, Uint8 g, Uint8 b)
+{
+    SoftImage *img = soft ? find_image(soft, key) : NULL;
+    if (!img)
+        return;
+    SDL_Rect s = src ? *src : (SDL_Rect){ 0, 0, img->w, img->h };
+    SDL_Rect d = dst ? *dst : (SDL_Rect){ 0, 0, soft->w, soft->h };
+    SDL_Rect fb_rect = { 0, 0, soft->w, soft->h }, clip;
+    if (s.w <= 0 || s.h <= 0 || d.w <= 0 || d.h <= 0)
+        return;
+    if (s.x < 0 || s.y < 0 || s.x + s.w > img->w || s.y + s.h > img->h)
+        return;  /* source outside the image: nothing sensible to draw */
+    if (!SDL_IntersectRect(&d, &fb_rect, &clip))
+        return;
+
+    int modulate = r != 255 || g != 255 || b != 255;
+    int unscaled = s.w == d.w && !modulate;
+    SpanFn span = img->binary_alpha && !modulate ? soft->span_key : soft->span_blend;
+
+    /* Nearest sampling: the same column mapping serves every row. */
+    for (int x = 0; x < clip.w; x++)
+        soft->xmap[x] = s.x + (clip.x - d.x + x) * s.w / d.w;
+
+    for (int y = clip.y; y < clip.y + clip.h; y++) {
+        int sy = s.y + (y - d.y) * s.h / d.h;
+        const Uint32 *src_row = img->pixels + (size_t)sy * (size_t)img->w;
+        Uint32 *dst_row = soft->pixels + (size_t)y * (size_t)soft->w + clip.x;
+        if (unscaled) {
+            span(dst_row, src_row + soft->xmap[0], clip.w);
+            continue;
+        }
+        /* Gather (and tint) into a contiguous row so the kernels stay unit-stride. */
+        for (int x = 0; x < clip.w; x++) {
+            Uint32 px = src_row[soft->xmap[x]];
+            if (modulate) {
+                Uint8 *c = (Uint8 *)&px;
+                c[0] = (Uint8)div255(c[0] * r);
+                c[1] = (Uint8)div255(c[1] * g);
+                c[2] = (Uint8)div255(c[2] * b);
+            }
+            soft->scratch[x] = px;
+        }
+        span(dst_row, soft->scratch, clip.w);
+    }
+}
+
+void soft_renderer_present(SoftRenderer *soft, const SDL_Rect *dst)
+{
+    if (!soft)
+        return;
+    if (SDL_UpdateTexture(soft->texture, NULL, soft->pixels, soft->w * (int)sizeof(Uint32)) != 0) {
+        fprintf(stderr, "SDL_UpdateTexture (soft): %s\n", SDL_GetError());
+        return;
+    }
+    SDL_RenderCopy(soft->renderer, soft->texture, NULL, dst);
+}
+
+Uint64 soft_checksum_pixels(const void *pixels, int w, int h, int pitch)
+{
+    Uint64 hash = 0xcbf29ce484222325ull;
+    for (int y = 0; y < h; y++) {
+        const Uint8 *row = (const Uint8 *)pixels + (size_t)y * (size_t)pitch;
+        for (int i = 0; i < w * 4; i++) {
+            hash ^= row[i];
+            hash *= 0x100000001b3ull;
+        }
+    }
+    return hash;
+}
+
+Uint64 soft_renderer_checksum(const SoftRenderer *soft)
+{
+    if (!soft)
+        return 0;
+    return soft_checksum_pixels(soft->pixels, soft->w, soft->h, soft->w * (int)sizeof(Uint32));
+}
@@ -0,0 +1,57 @@
+#ifndef SOFTRENDER_H
+#define SOFTRENDER_H
+
+#include <SDL.h>
+
+/* CPU rasterizer for machines without a GPU: keeps its own RGBA framebuffer,
+ * blits sprites with SIMD span kernels (picked at runtime, scalar fallback)
+ * and uploads the finished frame once through a streaming texture.
+ * Images are registered under the SDL_Texture they were uploaded as, so
+ * sprites and text keep naming textures and can be drawn either way.
+ * All kernels produce bit-identical output, so frame checksums don't depend
+ * on the CPU. */
+typedef struct SoftRenderer SoftRenderer;
+
+/* renderer is only used for presenting. Returns NULL on failure. */
+SoftRenderer *soft_renderer_create(SDL_Renderer *renderer, int w, int h);
+
+void soft_renderer_destroy(SoftRenderer *soft);
+
+/* Forces a kernel set: "avx2", "sse2" or "scalar". Returns -1 if this CPU
+ * or build doesn't have it. The default is the best available. */
+int soft_renderer_set_kernels(SoftRenderer *soft, const char *name);
+
+/* Name of the kernel set in use. */
+const char *soft_renderer_kernels(const SoftRenderer *soft);
+
+/* Copies RGBA32 pixels (alpha already keyed) and files them under key.
+ * Images are kept premultiplied; pass premultiplied = 0 for straight alpha
+ * and the copy is converted. Returns 0 on success. Registering a key again
+ * replaces its pixels. */
+int soft_renderer_add_image(SoftRenderer *soft, SDL_Texture *key, const void *rgba, int w, int h, int pitch,
+                            int premultiplied);
+
+/* Forgets key; call before destroying a texture that was registered. */
+void soft_renderer_remove_image(SoftRenderer *soft, SDL_Texture *key);
+
+void soft_renderer_clear(SoftRenderer *soft, Uint8 r, Uint8 g, Uint8 b);
+
+/* Fills rect (NULL = everything), alpha-blended unless a is 255. */
+void soft_renderer_fill_rect(SoftRenderer *soft, const SDL_Rect *rect, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+/* Draws src of the image registered as key scaled (nearest) to dst, colour
+ * modulated by r, g, b. Unknown keys are ignored. */
+void soft_renderer_copy(SoftRenderer *soft, SDL_Texture *key, const SDL_Rect *src, const SDL_Rect *dst,
+                        Uint8 r, Uint8 g, Uint8 b);
+
+/* Uploads the frame and copies it to dst of the current render target
+ * (NULL = all of it). */
+void soft_renderer_present(SoftRenderer *soft, const SDL_Rect *dst);
+
+/* Checksum of the current framebuffer contents. */
+Uint64 soft_renderer_checksum(const SoftRenderer *soft);
+
+/* FNV-1a over w×h RGBA pixels, ignoring row padding. */
+Uint64 soft_checksum_pixels(const void *pixels, int w, int h, int pitch);
+
+#endif /* SOFTRENDER_H */
@@ -0,0 +1,209 @@
+#include "sound.h"
+#include <SDL_mixer.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Mixer channels 0..SOUND_CHANNELS-1 are reserved for cues, so nothing that
+ * plays on "any free channel" (-1) can take them. */
+#define SOUND_CHANNELS        4
+#define SOUND_LATENCY_SAMPLES 64
+
+typedef struct {
+    const char *pack_name;
+    const char *path;
+    int         priority;  /* higher steals channels from lower */
+} SoundCue;
+
+static const SoundCue SOUND_CUES[SOUND_COUNT] = {
+    [SOUND_NEXT]      = { "sfx_next",      "assets/sounds/next1.mp3",     1 },
+    [SOUND_WIN]       = { "sfx_win",       "assets/sounds/win1.mp3",      3 },
+    [SOUND_LOSS]      = { "sfx_loss",      "assets/sounds/loss1.mp3",     3 },
+    [SOUND_SPEED_UP]  = { "sfx_speed_up",  "assets/sounds/speed up.mp3",  2 },
+    [SOUND_GAME_OVER] = { "sfx_game_over", "assets/sounds/game over.mp3", 4 },
+};
+
+typedef struct {
+    int          priority;  /* of the cue last started here (main thread) */
+    Uint64       trigger;   /* counter at sound_bank_play, published by armed */
+    SDL_atomic_t armed;     /* 1 until the mixer first mixes the new cue */
+} SoundChannel;
+
+struct SoundBank {
+    Mix_Chunk   *chunks[SOUND_COUNT];
+    SoundChannel channels[SOUND_CHANNELS];
+    /* Written by the audio thread, read by the main thread. */
+    Uint32       latency_us[SOUND_LATENCY_SAMPLES];
+    SDL_atomic_t latency_count;
+    SDL_atomic_t buffer_us;
+    int          bytes_per_sec;
+};
+
+/* Reloads are tagged with the cue id plus this. */
+#define SOUND_RELOAD_TAG  SOUND_COUNT
+
+static void on_chunk_ready(void *user, const AssetResult *res)
+{
+    SoundBank *bank = user;
+    bool reload = res->tag >= SOUND_RELOAD_TAG;
+    int id = reload ? res->tag - SOUND_RELOAD_TAG : res->tag;
+    if (id < 0 || id >= SOUND_COUNT || !res->chunk || (!reload && bank->chunks[id])) {
+        if (res->chunk)
+            Mix_FreeChunk(res->chunk);
+        return;
+    }
+    /* Freeing the old chunk halts any channel still playing it. */
+    if (bank->chunks[id])
+        Mix_FreeChunk(bank->chunks[id]);
+    bank->chunks[id] = res->chunk;
+}
+
+SoundBank *sound_bank_create(AssetPack *pack, AssetLoader *loader)
+{
+    SoundBank *bank = calloc(1, sizeof(SoundBank));
+    if (!bank)
+        return NULL;
+
+    int freq = 0, chans = 0;
+    Uint16 fmt = 0;
+    if (Mix_QuerySpec(&freq, &fmt, &chans) == 0) {
+        fprintf(stderr, "sound bank: audio not open\n");
+        free(bank);
+        return NULL;
+    }
+    bank->bytes_per_sec = freq * chans * (SDL_AUDIO_BITSIZE(fmt) / 8);
+
+    if (Mix_AllocateChannels(-1) < SOUND_CHANNELS)
+        Mix_AllocateChannels(SOUND_CHANNELS);
+    Mix_ReserveChannels(SOUND_CHANNELS);
+
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        /* Packed cues are PCM in the device format: no decode at all. */
+        SDL_RWops *rw = asset_pack_open_rw(pack, SOUND_CUES[i].pack_name, PACK_ENTRY_WAV);
+        if (rw)
+            bank->chunks[i] = Mix_LoadWAV_RW(rw, 1);
+        if (bank->chunks[i])
+            continue;
+        AssetRequest req = { .kind = ASSET_CHUNK, .tag = i, .on_ready = on_chunk_ready, .user = bank };
+        (void)snprintf(req.path, sizeof req.path, "%s", SOUND_CUES[i].path);
+        if (asset_loader_submit(loader, &req) != 0)
+            fprintf(stderr, "sound bank: cannot queue '%s'\n", SOUND_CUES[i].path);
+    }
+    return bank;
+}
+
+int sound_bank_reload(SoundBank *bank, AssetLoader *loader, const char *path)
+{
+    if (!bank || !path)
+        return -1;
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        if (strcmp(SOUND_CUES[i].path, path) != 0)
+            continue;
+        AssetRequest req = { .kind = ASSET_CHUNK, .tag = SOUND_RELOAD_TAG + i, .on_ready = on_chunk_ready, .user = bank };
+        (void)snprintf(req.path, sizeof req.path, "%s", path);
+        return asset_loader_submit(loader, &req);
+    }
+    return -1;
+}
+
+void sound_bank_destroy(SoundBank *bank)
+{
+    if (!bank)
+        return;
+    for (int ch = 0; ch < SOUND_CHANNELS; ch++)
+        Mix_HaltChannel(ch);
+    Mix_ReserveChannels(0);
+    for (int i = 0; i < SOUND_COUNT; i++) {
+        if (bank->chunks[i])
+            Mix_FreeChunk(bank->chunks[i]);
+    }
+    free(bank);
+}
+
+/* Mixer effect on the cue channels: the first call after a trigger is the
+ * moment the cue's samples enter the device buffer. Runs on the audio thread. */
+static void measure_effect(int chan, void *stream, int len, void *udata)
+{
+    (void)stream;
+    SoundBank *bank = udata;
+    if (chan < 0 || chan >= SOUND_CHANNELS)
+        return;
+    SoundChannel *c = &bank->channels[chan];
+    if (!SDL_AtomicCAS(&c->armed, 1, 0))
+        return;
+    SDL_MemoryBarrierAcquire();
+
+    Uint64 elapsed = SDL_GetPerformanceCounter() - c->trigger;
+    Uint64 buffer_us = bank->bytes_per_sec > 0 ? (Uint64)len * 1000000u / (Uint64)bank->bytes_per_sec : 0;
+    Uint64 us = elapsed * 1000000u / SDL_GetPerformanceFrequency() + buffer_us;
+    int n = SDL_AtomicGet(&bank->latency_count);
+    bank->latency_us[n % SOUND_LATENCY_SAMPLES] = (Uint32)us;
+    SDL_AtomicSet(&bank->buffer_us, (int)buffer_us);
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&bank->latency_count, n + 1);
+}
+
+/* Channel for a new cue of `priority`: a free one, else the lowest lower-priority one. */
+static int pick_channel(SoundBank *bank, int priority)
+{
+    int victim = -1;
+    for (int ch = 0; ch < SOUND_CHANNELS; ch++) {
+        if (!Mix_Playing(ch))
+            return ch;
+        if (bank->channels[ch].priority < priority &&
+            (victim < 0 || bank->channels[ch].priority < bank->channels[victim].priority))
+            victim = ch;
+    }
+    return victim;
+}
+
+int sound_bank_play(SoundBank *bank, SoundId id)
+{
+    if (!bank || id < 0 || id >= SOUND_COUNT || !bank->chunks[id])
+        return -1;
+    int priority = SOUND_CUES[id].priority;
+    int ch = pick_channel(bank, priority);
+    if (ch < 0)
+        return -1;
+
+    /* Halting drops the channel's effects, so register after it and before play. */
+    Mix_HaltChannel(ch);
+    SoundChannel *c = &bank->channels[ch];
+    c->priority = priority;
+    c->trigger  = SDL_GetPerformanceCounter();
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&c->armed, 1);
+    Mix_UnregisterEffect(ch, measure_effect);
+    Mix_RegisterEffect(ch, measure_effect, NULL, bank);
+    if (Mix_PlayChannel(ch, bank->chunks[id], 0) < 0) {
+        SDL_AtomicSet(&c->armed, 0);
+        return -1;
+    }
+    return ch;
+}
+
+void sound_bank_get_latency(const SoundBank *bank, SoundLatencyStats *out)
+{
+    if (!out)
+        return;
+    *out = (SoundLatencyStats){ 0 };
+    if (!bank)
+        return;
+    int total = SDL_AtomicGet((SDL_atomic_t *)&bank->latency_count);
+    SDL_MemoryBarrierAcquire();
+    int n = total < SOUND_LATENCY_SAMPLES ? total : SOUND_LATENCY_SAMPLES;
+    if (n == 0)
+        return;
+    double sum = 0.0;
+    out->min_ms = 1e9;
+    for (int i = 0; i < n; i++) {
+        double ms = (double)bank->latency_us[i] / 1000.0;
+        sum += ms;
+        if (ms < out->min_ms) out->min_ms = ms;
+        if (ms > out->max_ms) out->max_ms = ms;
+    }
+    out->samples   = n;
+    out->mean_ms   = sum / (double)n;
+    out->buffer_ms = (double)SDL_AtomicGet((SDL_atomic_t *)&bank->buffer_us) / 1000.0;
+}
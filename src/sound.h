@@ -0,0 +1,51 @@
+#ifndef SOUND_H
+#define SOUND_H
+
+#include "loader.h"
+#include "pack.h"
+#include <SDL.h>
+
+/* Short cues, decoded to PCM up front and played on reserved mixer channels. */
+typedef enum {
+    SOUND_NEXT,
+    SOUND_WIN,
+    SOUND_LOSS,
+    SOUND_SPEED_UP,
+    SOUND_GAME_OVER,
+    SOUND_COUNT
+} SoundId;
+
+/* Trigger-to-audible latency: from sound_bank_play to the mixer first
+ * touching the cue, plus one device buffer still queued ahead of it. */
+typedef struct SoundLatencyStats {
+    int    samples;
+    double mean_ms;
+    double min_ms;
+    double max_ms;
+    double buffer_ms;  /* device buffer length included in each sample */
+} SoundLatencyStats;
+
+typedef struct SoundBank SoundBank;
+
+/* Reserves the cue channels and loads every cue: straight from the pack when
+ * it has them, otherwise on the loader's workers (cues play once ready).
+ * Call after Mix_OpenAudio. Returns NULL on failure. */
+SoundBank *sound_bank_create(AssetPack *pack, AssetLoader *loader);
+
+/* Hot reload: if path is a cue's source file, decodes it again on the
+ * loader's workers; the new chunk replaces the old one when it is delivered.
+ * Returns 0 if a reload was queued, -1 if path is not a cue. */
+int sound_bank_reload(SoundBank *bank, AssetLoader *loader, const char *path);
+
+/* Halts cue channels and frees the chunks. */
+void sound_bank_destroy(SoundBank *bank);
+
+/* Plays a cue on a free cue channel, or steals the channel of the lowest
+ * priority cue if that is lower than this one. Returns the channel, or -1
+ * when the cue was dropped or isn't loaded yet. */
+int sound_bank_play(SoundBank *bank, SoundId id);
+
+/* Latency measured so far. */
+void sound_bank_get_latency(const SoundBank *bank, SoundLatencyStats *out);
+
+#endif /* SOUND_H */
@@ -0,0 +1,397 @@
+#include "texcache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Textures one cache can name; minigames together stay well under this. */
+#define TEXTURE_CACHE_MAX  128
+
+typedef enum {
+    TEX_EVICTED,   /* defined, not on the GPU */
+    TEX_LOADING,   /* PNG on a loader worker */
+    TEX_RESIDENT,
+    TEX_FAILED,    /* not retried */
+} TexState;
+
+typedef struct {
+    char             name[PACK_NAME_MAX];
+    char             path[ASSET_PATH_MAX];
+    ChromaKey        key;
+    int              keyed;
+    int              premultiply;
+    const PackEntry *packed;     /* NULL: loaded from path */
+    TexState         state;
+    bool             wanted;     /* prefetched and not drawn yet: kept through evictions */
+    bool             was_evicted;
+    bool             changed;    /* file changed while loading: read it again once in */
+    SDL_Texture     *texture;
+    size_t           bytes;
+    Uint64           last_used;  /* cache->clock when last asked for */
+    Uint32           used_frame;
+} TexEntry;
+
+struct TextureCache {
+    SDL_Renderer    *renderer;
+    AssetLoader     *loader;
+    const AssetPack *pack;
+    SoftRenderer    *soft;     /* borrowed; NULL when drawing on the GPU */
+    SDL_mutex       *lock;     /* defines and prefetches come from the minigame prefetch thread */
+    TexEntry         entries[TEXTURE_CACHE_MAX];
+    int              count;
+    Uint64           clock;
+    Uint32           frame;
+    TextureCacheStats stats;
+};
+
+static size_t texture_bytes(SDL_Texture *texture)
+{
+    Uint32 format;
+    int w, h;
+    if (SDL_QueryTexture(texture, &format, NULL, &w, &h) != 0)
+        return 0;
+    int bpp = SDL_BYTESPERPIXEL(format);
+    return (size_t)w * (size_t)h * (size_t)(bpp > 0 ? bpp : 4);
+}
+
+static void evict(TextureCache *cache, TexEntry *e)
+{
+    soft_renderer_remove_image(cache->soft, e->texture);
+    SDL_DestroyTexture(e->texture);
+    e->texture = NULL;
+    e->state = TEX_EVICTED;
+    e->was_evicted = true;
+    cache->stats.resident_bytes -= e->bytes;
+    cache->stats.resident--;
+    cache->stats.evictions++;
+}
+
+/* Evicts least recently used textures until the rest fit the budget. Ones
+ * drawn this frame may still be queued in the sprite batch, and prefetched
+ * ones are about to be drawn, so they stay even if that means going over. */
+static void trim(TextureCache *cache)
+{
+    size_t budget = cache->stats.budget_bytes;
+    while (budget > 0 && cache->stats.resident_bytes > budget) {
+        TexEntry *victim = NULL;
+        for (int i = 0; i < cache->count; i++) {
+            TexEntry *e = &cache->entries[i];
+            if (e->state != TEX_RESIDENT || e->wanted || e->used_frame == cache->frame)
+                continue;
+            if (!victim || e->last_used < victim->last_used)
+                victim = e;
+        }
+        if (!victim)
+            return;
+        evict(cache, victim);
+    }
+}
+
+static void make_resident(TextureCache *cache, TexEntry *e, SDL_Texture *texture)
+{
+    e->texture = texture;
+    e->bytes = texture_bytes(texture);
+    e->state = TEX_RESIDENT;
+    cache->stats.resident_bytes += e->bytes;
+    cache->stats.resident++;
+    if (cache->stats.resident_bytes > cache->stats.peak_bytes)
+        cache->stats.peak_bytes = cache->stats.resident_bytes;
+}
+
+/* Main thread: uploads a packed texture from the mapping. */
+static void create_packed(TextureCache *cache, TexEntry *e)
+{
+    SDL_Texture *texture = asset_pack_create_texture(cache->pack, cache->renderer, e->name);
+    if (!texture) {
+        fprintf(stderr, "texture cache: cannot create '%s'\n", e->name);
+        e->state = TEX_FAILED;
+        return;
+    }
+    int w = (int)e->packed->a, h = (int)e->packed->b;
+    if (cache->soft && soft_renderer_add_image(cache->soft, texture, asset_pack_data(cache->pack, e->packed),
+                                               w, h, w * 4, 1) != 0)
+        fprintf(stderr, "soft renderer: cannot copy a %dx%d image\n", w, h);
+    make_resident(cache, e, texture);
+}
+
+static void request(TextureCache *cache, TexEntry *e);
+static void submit_reload(TextureCache *cache, TexEntry *e);
+
+/* Main thread, from asset_loader_pump. */
+static void on_texture_ready(void *user, const AssetResult *res)
+{
+    TextureCache *cache = user;
+    SDL_LockMutex(cache->lock);
+    TexEntry *e = &cache->entries[res->tag];
+    if (res->texture) {
+        make_resident(cache, e, res->texture);
+    } else {
+        fprintf(stderr, "texture cache: cannot load '%s'\n", e->path);
+        e->state = TEX_FAILED;
+    }
+    if (e->changed) {
+        e->changed = false;
+        if (e->state == TEX_RESIDENT) {
+            submit_reload(cache, e);
+        } else {
+            e->state = TEX_EVICTED;
+            request(cache, e);
+        }
+    }
+    trim(cache);
+    SDL_UnlockMutex(cache->lock);
+}
+
+/* Main thread, from asset_loader_pump: the new image replaces a resident
+ * texture in place. If the entry went meanwhile, its next get reads the
+ * file anyway. */
+static void on_texture_reloaded(void *user, const AssetResult *res)
+{
+    TextureCache *cache = user;
+    SDL_LockMutex(cache->lock);
+    TexEntry *e = &cache->entries[res->tag];
+    if (!res->texture) {
+        fprintf(stderr, "hot reload: cannot load '%s'; keeping the old texture\n", e->path);
+    } else if (e->state != TEX_RESIDENT) {
+        soft_renderer_remove_image(cache->soft, res->texture);
+        SDL_DestroyTexture(res->texture);
+    } else {
+        soft_renderer_remove_image(cache->soft, e->texture);
+        SDL_DestroyTexture(e->texture);
+        cache->stats.resident_bytes -= e->bytes;
+        cache->stats.resident--;
+        make_resident(cache, e, res->texture);
+    }
+    trim(cache);
+    SDL_UnlockMutex(cache->lock);
+}
+
+static void submit_reload(TextureCache *cache, TexEntry *e)
+{
+    AssetRequest req = {
+        .kind        = ASSET_IMAGE,
+        .tag         = (int)(e - cache->entries),
+        .keyed       = e->keyed,
+        .key         = e->key,
+        .premultiply = e->premultiply,
+        .on_ready    = on_texture_reloaded,
+        .user        = cache,
+    };
+    (void)snprintf(req.path, sizeof req.path, "%s", e->path);
+    if (asset_loader_submit(cache->loader, &req) != 0)
+        fprintf(stderr, "hot reload: cannot queue '%s'\n", e->path);
+}
+
+/* Counts the hit or miss and starts a load if needed. Packed textures are
+ * left for the caller on the main thread. Call with the lock held. */
+static void request(TextureCache *cache, TexEntry *e)
+{
+    e->last_used = ++cache->clock;
+    if (e->state == TEX_RESIDENT) {
+        cache->stats.hits++;
+        return;
+    }
+    if (e->state != TEX_EVICTED)
+        return;
+    cache->stats.misses++;
+    if (e->was_evicted)
+        cache->stats.reloads++;
+    if (e->packed)
+        return;
+    AssetRequest req = {
+        .kind        = ASSET_IMAGE,
+        .tag         = (int)(e - cache->entries),
+        .keyed       = e->keyed,
+        .key         = e->key,
+        .premultiply = e->premultiply,
+        .on_ready    = on_texture_ready,
+        .user        = cache,
+    };
+    (void)snprintf(req.path, sizeof req.path, "%s", e->path);
+    if (asset_loader_submit(cache->loader, &req) != 0) {
+        fprintf(stderr, "texture cache: cannot queue '%s'\n", e->path);
+        e->state = TEX_FAILED;
+        return;
+    }
+    e->state = TEX_LOADING;
+}
+
+TextureCache *texture_cache_create(SDL_Renderer *renderer, AssetLoader *loader, const AssetPack *pack,
+                                   size_t budget_bytes)
+{
+    TextureCache *cache = calloc(1, sizeof(TextureCache));
+    if (!cache)
+        return NULL;
+    cache->renderer = renderer;
+    cache->loader = loader;
+    cache->pack = pack;
+    cache->stats.budget_bytes = budget_bytes;
+    cache->lock = SDL_CreateMutex();
+    if (!cache->lock) {
+        fprintf(stderr, "SDL_CreateMutex: %s\n", SDL_GetError());
+        free(cache);
+        return NULL;
+    }
+    return cache;
+}
+
+void texture_cache_destroy(TextureCache *cache)
+{
+    if (!cache)
+        return;
+    for (int i = 0; i < cache->count; i++) {
+        TexEntry *e = &cache->entries[i];
+        if (e->texture) {
+            soft_renderer_remove_image(cache->soft, e->texture);
+            SDL_DestroyTexture(e->texture);
+        }
+    }
+    SDL_DestroyMutex(cache->lock);
+    free(cache);
+}
+
+void texture_cache_set_soft_renderer(TextureCache *cache, SoftRenderer *soft)
+{
+    if (cache)
+        cache->soft = soft;
+}
+
+void texture_cache_set_budget(TextureCache *cache, size_t budget_bytes)
+{
+    if (!cache)
+        return;
+    SDL_LockMutex(cache->lock);
+    cache->stats.budget_bytes = budget_bytes;
+    SDL_UnlockMutex(cache->lock);
+}
+
+int texture_cache_define(TextureCache *cache, const TextureSource *src)
+{
+    if (!cache || !src || !src->name || !src->name[0])
+        return -1;
+    SDL_LockMutex(cache->lock);
+    int id = -1;
+    for (int i = 0; i < cache->count && id < 0; i++)
+        if (strncmp(cache->entries[i].name, src->name, sizeof cache->entries[i].name) == 0)
+            id = i;
+    if (id < 0 && cache->count < TEXTURE_CACHE_MAX) {
+        id = cache->count++;
+        TexEntry *e = &cache->entries[id];
+        *e = (TexEntry){ .keyed = src->key != NULL, .premultiply = src->premultiply };
+        (void)snprintf(e->name, sizeof e->name, "%s", src->name);
+        if (src->path)
+            (void)snprintf(e->path, sizeof e->path, "%s", src->path);
+        if (src->key)
+            e->key = *src->key;
+        e->packed = asset_pack_find(cache->pack, e->name, PACK_ENTRY_RGBA);
+        if (!e->packed && !src->path) {
+            fprintf(stderr, "texture cache: '%s' is not packed and has no file\n", e->name);
+            e->state = TEX_FAILED;
+        }
+        cache->stats.defined = cache->count;
+    } else if (id < 0) {
+        fprintf(stderr, "texture cache: more than %d textures; not caching '%s'\n", TEXTURE_CACHE_MAX, src->name);
+    }
+    SDL_UnlockMutex(cache->lock);
+    return id;
+}
+
+void texture_cache_prefetch(TextureCache *cache, int id)
+{
+    if (!cache || id < 0 || id >= TEXTURE_CACHE_MAX)
+        return;
+    SDL_LockMutex(cache->lock);
+    if (id < cache->count) {
+        TexEntry *e = &cache->entries[id];
+        request(cache, e);
+        e->wanted = e->state != TEX_FAILED;
+    }
+    SDL_UnlockMutex(cache->lock);
+}
+
+bool texture_cache_ready(const TextureCache *cache, int id)
+{
+    if (!cache || id < 0 || id >= TEXTURE_CACHE_MAX)
+        return true;
+    SDL_LockMutex(cache->lock);
+    bool ready = id >= cache->count || cache->entries[id].state == TEX_RESIDENT ||
+                 cache->entries[id].state == TEX_FAILED;
+    SDL_UnlockMutex(cache->lock);
+    return ready;
+}
+
+SDL_Texture *texture_cache_get(TextureCache *cache, int id)
+{
+    if (!cache || id < 0 || id >= TEXTURE_CACHE_MAX)
+        return NULL;
+    SDL_LockMutex(cache->lock);
+    SDL_Texture *texture = NULL;
+    if (id < cache->count) {
+        TexEntry *e = &cache->entries[id];
+        request(cache, e);
+        if (e->state == TEX_EVICTED && e->packed) {
+            create_packed(cache, e);
+            trim(cache);
+        }
+        e->wanted = false;
+        e->used_frame = cache->frame;
+        texture = e->texture;
+    }
+    SDL_UnlockMutex(cache->lock);
+    return texture;
+}
+
+bool texture_cache_reload(TextureCache *cache, const char *path)
+{
+    if (!cache || !path)
+        return false;
+    bool found = false;
+    SDL_LockMutex(cache->lock);
+    for (int i = 0; i < cache->count; i++) {
+        TexEntry *e = &cache->entries[i];
+        if (e->packed || strcmp(e->path, path) != 0)
+            continue;
+        found = true;
+        if (e->state == TEX_RESIDENT) {
+            submit_reload(cache, e);
+        } else if (e->state == TEX_LOADING) {
+            e->changed = true;
+        } else if (e->state == TEX_FAILED) {
+            e->state = TEX_EVICTED;  /* the fixed file may load now */
+            request(cache, e);
+        }
+    }
+    SDL_UnlockMutex(cache->lock);
+    return found;
+}
+
+void texture_cache_frame(TextureCache *cache)
+{
+    if (cache)
+        cache->frame++;
+}
+
+void texture_cache_pump(TextureCache *cache)
+{
+    if (!cache)
+        return;
+    SDL_LockMutex(cache->lock);
+    for (int i = 0; i < cache->count; i++) {
+        TexEntry *e = &cache->entries[i];
+        if (e->wanted && e->state == TEX_EVICTED && e->packed)
+            create_packed(cache, e);
+    }
+    trim(cache);
+    SDL_UnlockMutex(cache->lock);
+}
+
+void texture_cache_get_stats(const TextureCache *cache, TextureCacheStats *out)
+{
+    if (!out)
+        return;
+    *out = (TextureCacheStats){ 0 };
+    if (!cache)
+        return;
+    SDL_LockMutex(cache->lock);
+    *out = cache->stats;
+    SDL_UnlockMutex(cache->lock);
+}
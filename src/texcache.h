@@ -0,0 +1,89 @@
+#ifndef TEXCACHE_H
+#define TEXCACHE_H
+
+#include "chroma.h"
+#include "loader.h"
+#include "pack.h"
+#include "softrender.h"
+#include <SDL.h>
+#include <stdbool.h>
+
+/* Minigame textures kept on the GPU within a byte budget. Each texture is
+ * defined once under an asset name and stays defined; when holding it would
+ * go over the budget, the textures least recently drawn are destroyed, and
+ * the next get brings one back: straight from the pack's decoded pixels, or
+ * decoded again from its PNG on a loader worker.
+ * Bytes are estimated as width × height × bytes per pixel. */
+typedef struct TextureCache TextureCache;
+
+/* Where a texture comes from. */
+typedef struct TextureSource {
+    const char      *name;         /* asset name: the cache key, and the pack's RGBA entry */
+    const char      *path;         /* PNG loaded when the pack lacks name; may be NULL */
+    const ChromaKey *key;          /* PNG: key into alpha; NULL keeps the alpha as stored */
+    int              premultiply;  /* PNG, unkeyed: it has straight alpha */
+} TextureSource;
+
+typedef struct TextureCacheStats {
+    Uint64 hits;            /* gets and prefetches that found the texture on the GPU */
+    Uint64 misses;          /* ones that had to load it */
+    Uint64 reloads;         /* misses for a texture evicted earlier */
+    Uint64 evictions;
+    size_t resident_bytes;  /* estimated GPU bytes held now */
+    size_t peak_bytes;
+    size_t budget_bytes;    /* 0 = no limit */
+    int    resident;        /* textures held now */
+    int    defined;
+} TextureCacheStats;
+
+/* budget_bytes 0 = no limit. pack may be NULL. Returns NULL on failure. */
+TextureCache *texture_cache_create(SDL_Renderer *renderer, AssetLoader *loader, const AssetPack *pack,
+                                   size_t budget_bytes);
+
+/* Destroys every texture. Destroy the loader first, so no load lands later. */
+void texture_cache_destroy(TextureCache *cache);
+
+/* Keeps the software rasterizer's copies in step: packed textures are added
+ * as they are created (the loader's upload hook covers PNGs) and every
+ * texture is removed as it goes. Set before the first load. */
+void texture_cache_set_soft_renderer(TextureCache *cache, SoftRenderer *soft);
+
+/* Lowers or raises the budget; anything over it goes at the next pump. */
+void texture_cache_set_budget(TextureCache *cache, size_t budget_bytes);
+
+/* Returns the id of src->name, defining it the first time; -1 if the name
+ * is empty or the cache is full. Any thread. */
+int texture_cache_define(TextureCache *cache, const TextureSource *src);
+
+/* Starts bringing id onto the GPU without waiting (call from minigame
+ * create). Any thread. */
+void texture_cache_prefetch(TextureCache *cache, int id);
+
+/* True once id is on the GPU, or its load failed: what a minigame's ready
+ * hook waits for. */
+bool texture_cache_ready(const TextureCache *cache, int id);
+
+/* Main thread, every draw: the texture, or NULL while it loads (or if it
+ * failed). Marks it used this frame, so it is not evicted before the next
+ * texture_cache_frame. Don't keep the pointer past that: call again. */
+SDL_Texture *texture_cache_get(TextureCache *cache, int id);
+
+/* Main thread, for hot reload: reads path again into every texture loaded
+ * from it. A resident one keeps drawing the old image until the new one is
+ * in, an evicted one picks the file up at its next get, and a failed one
+ * is tried again. Packed
+ * textures come from the pack and are left alone. False if no texture is
+ * loaded from path. */
+bool texture_cache_reload(TextureCache *cache, const char *path);
+
+/* Main thread, once per frame before drawing: textures used in earlier
+ * frames become eligible for eviction. */
+void texture_cache_frame(TextureCache *cache);
+
+/* Main thread, after asset_loader_pump: creates prefetched packed textures
+ * and evicts down to the budget. */
+void texture_cache_pump(TextureCache *cache);
+
+void texture_cache_get_stats(const TextureCache *cache, TextureCacheStats *out);
+
+#endif /* TEXCACHE_H */
@@ -0,0 +1,256 @@
+#include "text.h"
+#include "softrender.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Printable ASCII only; anything else is drawn as '?'. */
+#define TEXT_FIRST_GLYPH  32
+#define TEXT_LAST_GLYPH   126
+#define TEXT_GLYPH_COUNT  (TEXT_LAST_GLYPH - TEXT_FIRST_GLYPH + 1)
+#define TEXT_FALLBACK     '?'
+
+#define TEXT_ATLAS_W      256
+#define TEXT_GLYPH_PAD    1
+
+/* Quads per geometry submission; longer strings are flushed in chunks. */
+#define TEXT_BATCH_QUADS  64
+
+typedef struct {
+    SDL_Rect src;      /* cell in the atlas texture */
+    int      advance;  /* pen advance in pixels */
+} TextGlyph;
+
+struct TextAtlas {
+    SDL_Renderer *renderer;
+    SDL_Texture  *texture;
+    SDL_Surface  *sheet;     /* CPU copy of the texture, for software rendering */
+    SoftRenderer *soft;      /* when set, glyphs are drawn here instead */
+    int           tex_w;
+    int           tex_h;
+    int           line_h;
+    TextGlyph     glyphs[TEXT_GLYPH_COUNT];
+    Sint8         kerning[TEXT_GLYPH_COUNT][TEXT_GLYPH_COUNT];
+    TextStats     stats;
+    /* Scratch geometry reused by every draw so drawing never allocates. */
+    SDL_Vertex    verts[TEXT_BATCH_QUADS * 4];
+    int           indices[TEXT_BATCH_QUADS * 6];
+};
+
+static int glyph_index(char c)
+{
+    unsigned char uc = (unsigned char)c;
+    if (uc < TEXT_FIRST_GLYPH || uc > TEXT_LAST_GLYPH)
+        uc = TEXT_FALLBACK;
+    return uc - TEXT_FIRST_GLYPH;
+}
+
+TextAtlas *text_atlas_create(SDL_Renderer *renderer, TTF_Font *font)
+{
+    if (!renderer || !font)
+        return NULL;
+
+    TextAtlas *atlas = calloc(1, sizeof(TextAtlas));
+    if (!atlas)
+        return NULL;
+    atlas->renderer = renderer;
+    atlas->line_h   = TTF_FontHeight(font);
+
+    /* Rasterize each glyph white; color comes from vertex colors at draw time. */
+    SDL_Color white = { 255, 255, 255, 255 };
+    SDL_Surface *glyph_surfs[TEXT_GLYPH_COUNT] = { NULL };
+    int pen_x = 0, pen_y = 0, shelf_h = 0;
+    for (int i = 0; i < TEXT_GLYPH_COUNT; i++) {
+        Uint16 ch = (Uint16)(TEXT_FIRST_GLYPH + i);
+        int minx, maxx, miny, maxy, advance;
+        if (TTF_GlyphMetrics(font, ch, &minx, &maxx, &miny, &maxy, &advance) != 0)
+            advance = 0;
+        atlas->glyphs[i].advance = advance;
+
+        /* Space and missing glyphs have nothing to rasterize. */
+        if (ch == ' ' || !TTF_GlyphIsProvided(font, ch))
+            continue;
+        SDL_Surface *surf = TTF_RenderGlyph_Blended(font, ch, white);
+        if (!surf)
+            continue;
+        atlas->stats.surface_allocs++;
+        glyph_surfs[i] = surf;
+
+        /* Shelf packing: glyphs are all font-height tall, so shelves fill evenly. */
+        if (pen_x + surf->w > TEXT_ATLAS_W) {
+            pen_x = 0;
+            pen_y += shelf_h + TEXT_GLYPH_PAD;
+            shelf_h = 0;
+        }
+        atlas->glyphs[i].src = (SDL_Rect){ pen_x, pen_y, surf->w, surf->h };
+        pen_x += surf->w + TEXT_GLYPH_PAD;
+        if (surf->h > shelf_h)
+            shelf_h = surf->h;
+    }
+
+    atlas->tex_w = TEXT_ATLAS_W;
+    atlas->tex_h = pen_y + shelf_h;
+    if (atlas->tex_h <= 0)
+        atlas->tex_h = 1;
+
+    SDL_Surface *sheet = SDL_CreateRGBSurfaceWithFormat(0, atlas->tex_w, atlas->tex_h, 32, SDL_PIXELFORMAT_RGBA32);
+    if (sheet) {
+        atlas->stats.surface_allocs++;
+        SDL_FillRect(sheet, NULL, 0);
+        for (int i = 0; i < TEXT_GLYPH_COUNT; i++) {
+            if (!glyph_surfs[i])
+                continue;
+            /* Copy coverage as-is instead of blending it onto the cleared sheet. */
+            SDL_SetSurfaceBlendMode(glyph_surfs[i], SDL_BLENDMODE_NONE);
+            SDL_Rect dst = atlas->glyphs[i].src;
+            SDL_BlitSurface(glyph_surfs[i], NULL, sheet, &dst);
+        }
+        atlas->texture = SDL_CreateTextureFromSurface(renderer, sheet);
+        atlas->sheet = sheet;
+    }
+    for (int i = 0; i < TEXT_GLYPH_COUNT; i++) {
+        if (glyph_surfs[i])
+            SDL_FreeSurface(glyph_surfs[i]);
+    }
+    if (!atlas->texture) {
+        fprintf(stderr, "text atlas: %s\n", SDL_GetError());
+        if (atlas->sheet)
+            SDL_FreeSurface(atlas->sheet);
+        free(atlas);
+        return NULL;
+    }
+    atlas->stats.texture_uploads++;
+    SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+
+    for (int a = 0; a < TEXT_GLYPH_COUNT; a++) {
+        for (int b = 0; b < TEXT_GLYPH_COUNT; b++) {
+            int k = TTF_GetFontKerningSizeGlyphs(font, (Uint16)(TEXT_FIRST_GLYPH + a), (Uint16)(TEXT_FIRST_GLYPH + b));
+            atlas->kerning[a][b] = (Sint8)SDL_clamp(k, -128, 127);
+        }
+    }
+
+    /* Quad i always uses vertices 4i..4i+3, so the index buffer never changes. */
+    for (int q = 0; q < TEXT_BATCH_QUADS; q++) {
+        int *idx = &atlas->indices[q * 6];
+        int v = q * 4;
+        idx[0] = v;     idx[1] = v + 1; idx[2] = v + 2;
+        idx[3] = v + 2; idx[4] = v + 1; idx[5] = v + 3;
+    }
+    return atlas;
+}
+
+void text_atlas_destroy(TextAtlas *atlas)
+{
+    if (!atlas)
+        return;
+    if (atlas->soft)
+        soft_renderer_remove_image(atlas->soft, atlas->texture);
+    if (atlas->texture)
+        SDL_DestroyTexture(atlas->texture);
+    if (atlas->sheet)
+        SDL_FreeSurface(atlas->sheet);
+    free(atlas);
+}
+
+void text_atlas_measure(const TextAtlas *atlas, const char *text, int *w, int *h)
+{
+    int width = 0;
+    if (atlas && text) {
+        int prev = -1;
+        for (const char *p = text; *p; p++) {
+            int g = glyph_index(*p);
+            if (prev >= 0)
+                width += atlas->kerning[prev][g];
+            width += atlas->glyphs[g].advance;
+            prev = g;
+        }
+    }
+    if (w)
+        *w = width;
+    if (h)
+        *h = atlas ? atlas->line_h : 0;
+}
+
+static void flush_quads(TextAtlas *atlas, int quads)
+{
+    if (quads <= 0)
+        return;
+    SDL_RenderGeometry(atlas->renderer, atlas->texture, atlas->verts, quads * 4, atlas->indices, quads * 6);
+    atlas->stats.draw_calls++;
+    atlas->stats.glyphs_drawn += (Uint64)quads;
+}
+
+void text_atlas_draw(TextAtlas *atlas, const char *text, int x, int y, Uint8 red, Uint8 grn, Uint8 blu)
+{
+    if (!atlas || !text)
+        return;
+
+    SDL_Color color = { red, grn, blu, 255 };
+    float inv_w = 1.0f / (float)atlas->tex_w;
+    float inv_h = 1.0f / (float)atlas->tex_h;
+    int pen = x;
+    int prev = -1;
+    int quads = 0;
+    for (const char *p = text; *p; p++) {
+        int g = glyph_index(*p);
+        if (prev >= 0)
+            pen += atlas->kerning[prev][g];
+        prev = g;
+
+        const SDL_Rect *src = &atlas->glyphs[g].src;
+        if (src->w > 0 && src->h > 0 && atlas->soft) {
+            SDL_Rect dst = { pen, y, src->w, src->h };
+            soft_renderer_copy(atlas->soft, atlas->texture, src, &dst, red, grn, blu);
+            atlas->stats.glyphs_drawn++;
+        } else if (src->w > 0 && src->h > 0) {
+            float x0 = (float)pen, y0 = (float)y;
+            float x1 = x0 + (float)src->w, y1 = y0 + (float)src->h;
+            float u0 = (float)src->x * inv_w, v0 = (float)src->y * inv_h;
+            float u1 = (float)(src->x + src->w) * inv_w, v1 = (float)(src->y + src->h) * inv_h;
+            SDL_Vertex *v = &atlas->verts[quads * 4];
+            v[0] = (SDL_Vertex){ { x0, y0 }, color, { u0, v0 } };
+            v[1] = (SDL_Vertex){ { x1, y0 }, color, { u1, v0 } };
+            v[2] = (SDL_Vertex){ { x0, y1 }, color, { u0, v1 } };
+            v[3] = (SDL_Vertex){ { x1, y1 }, color, { u1, v1 } };
+            if (++quads == TEXT_BATCH_QUADS) {
+                flush_quads(atlas, quads);
+                quads = 0;
+            }
+        }
+        pen += atlas->glyphs[g].advance;
+    }
+    flush_quads(atlas, quads);
+}
+
+void text_atlas_draw_centered(TextAtlas *atlas, const char *text, int cx, int cy, Uint8 red, Uint8 grn, Uint8 blu)
+{
+    int w, h;
+    text_atlas_measure(atlas, text, &w, &h);
+    text_atlas_draw(atlas, text, cx - w / 2, cy - h / 2, red, grn, blu);
+}
+
+int text_atlas_set_soft_renderer(TextAtlas *atlas, SoftRenderer *soft)
+{
+    if (!atlas)
+        return -1;
+    if (atlas->soft)
+        soft_renderer_remove_image(atlas->soft, atlas->texture);
+    atlas->soft = NULL;
+    if (!soft)
+        return 0;
+    if (!atlas->sheet ||
+        soft_renderer_add_image(soft, atlas->texture, atlas->sheet->pixels, atlas->sheet->w, atlas->sheet->h,
+                                atlas->sheet->pitch, 0) != 0)
+        return -1;
+    atlas->soft = soft;
+    return 0;
+}
+
+void text_atlas_get_stats(const TextAtlas *atlas, TextStats *out)
+{
+    if (!out)
+        return;
+    if (atlas)
+        *out = atlas->stats;
+    else
+        *out = (TextStats){ 0 };
+}
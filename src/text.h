@@ -0,0 +1,44 @@
+#ifndef TEXT_H
+#define TEXT_H
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+typedef struct TextAtlas TextAtlas;
+typedef struct SoftRenderer SoftRenderer;
+
+/* Running totals of the expensive operations the text renderer performs.
+ * Surfaces and uploads only happen in text_atlas_create, so both stay flat
+ * while the game runs; a change between frames means HUD text is churning. */
+typedef struct TextStats {
+    Uint64 surface_allocs;   /* SDL_Surfaces created (glyph rasterization, atlas) */
+    Uint64 texture_uploads;  /* SDL_Textures created or updated */
+    Uint64 draw_calls;       /* batched geometry submissions */
+    Uint64 glyphs_drawn;     /* quads emitted */
+} TextStats;
+
+/* Rasterizes the printable ASCII glyphs of font into one atlas texture.
+ * The font is only read here; the atlas keeps its own metrics and kerning.
+ * Returns NULL on failure. */
+TextAtlas *text_atlas_create(SDL_Renderer *renderer, TTF_Font *font);
+
+/* Frees the atlas texture and glyph tables. */
+void text_atlas_destroy(TextAtlas *atlas);
+
+/* Width and height in pixels text would occupy when drawn (kerning applied). */
+void text_atlas_measure(const TextAtlas *atlas, const char *text, int *w, int *h);
+
+/* Draws text with its top-left at (x, y). */
+void text_atlas_draw(TextAtlas *atlas, const char *text, int x, int y, Uint8 red, Uint8 grn, Uint8 blu);
+
+/* Draws text centered at (cx, cy). */
+void text_atlas_draw_centered(TextAtlas *atlas, const char *text, int cx, int cy, Uint8 red, Uint8 grn, Uint8 blu);
+
+/* Sends glyph draws to a software renderer instead of the SDL renderer
+ * (NULL switches back). Returns 0 on success. */
+int text_atlas_set_soft_renderer(TextAtlas *atlas, SoftRenderer *soft);
+
+/* Copies the running counters into out. */
+void text_atlas_get_stats(const TextAtlas *atlas, TextStats *out);
+
+#endif /* TEXT_H */
@@ -0,0 +1,72 @@
+#include "triple.h"
+#include <stdlib.h>
+
+/* The middle slot's index, plus this bit while the reader hasn't taken it. */
+#define TRIPLE_FRESH  4
+#define TRIPLE_INDEX  3
+
+struct TripleBuffer {
+    unsigned char *slots;
+    size_t         slot_size;
+    int            back;    /* writer's slot */
+    int            front;   /* reader's slot */
+    SDL_atomic_t   middle;  /* swapped with an atomic exchange by both sides */
+};
+
+TripleBuffer *triple_buffer_create(size_t slot_size)
+{
+    if (slot_size == 0)
+        return NULL;
+    TripleBuffer *tb = calloc(1, sizeof(TripleBuffer));
+    if (!tb)
+        return NULL;
+    tb->slots = calloc(3, slot_size);
+    if (!tb->slots) {
+        free(tb);
+        return NULL;
+    }
+    tb->slot_size = slot_size;
+    tb->back = 0;
+    tb->front = 1;
+    SDL_AtomicSet(&tb->middle, 2);
+    return tb;
+}
+
+void triple_buffer_destroy(TripleBuffer *tb)
+{
+    if (!tb)
+        return;
+    free(tb->slots);
+    free(tb);
+}
+
+void *triple_buffer_write_slot(TripleBuffer *tb)
+{
+    return tb->slots + (size_t)tb->back * tb->slot_size;
+}
+
+void triple_buffer_publish(TripleBuffer *tb)
+{
+    /* Release: the slot's contents are visible before its index is. Acquire:
+     * the reader is done with the slot handed back before it is rewritten. */
+    SDL_MemoryBarrierRelease();
+    int old = SDL_AtomicSet(&tb->middle, tb->back | TRIPLE_FRESH);
+    SDL_MemoryBarrierAcquire();
+    tb->back = old & TRIPLE_INDEX;
+}
+
+const void *triple_buffer_read(TripleBuffer *tb, bool *fresh)
+{
+    bool got = (SDL_AtomicGet(&tb->middle) & TRIPLE_FRESH) != 0;
+    if (got) {
+        /* Pairs with publish: reads of the old front finish before it is
+         * handed back, and the new front's contents are seen. */
+        SDL_MemoryBarrierRelease();
+        int old = SDL_AtomicSet(&tb->middle, tb->front);
+        SDL_MemoryBarrierAcquire();
+        tb->front = old & TRIPLE_INDEX;
+    }
+    if (fresh)
+        *fresh = got;
+    return tb->slots + (size_t)tb->front * tb->slot_size;
+}
@@ -0,0 +1,32 @@
+#ifndef TRIPLE_H
+#define TRIPLE_H
+
+#include <SDL.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Lock-free triple buffer for one writer thread and one reader thread. The
+ * writer fills its private slot and publishes it; the reader takes the
+ * latest published slot. Neither side ever waits: the writer can publish
+ * any number of times between reads (only the newest survives), and the
+ * reader keeps the slot it holds until its next read. */
+typedef struct TripleBuffer TripleBuffer;
+
+/* slot_size: bytes per slot; all three slots start zeroed. Returns NULL on
+ * failure. */
+TripleBuffer *triple_buffer_create(size_t slot_size);
+
+void triple_buffer_destroy(TripleBuffer *tb);
+
+/* Writer: the slot to fill next. Its contents are stale (whatever was
+ * published two publishes ago), so write every field. */
+void *triple_buffer_write_slot(TripleBuffer *tb);
+
+/* Writer: makes the write slot the latest and takes a fresh one. */
+void triple_buffer_publish(TripleBuffer *tb);
+
+/* Reader: the latest published slot, valid until the next call. fresh
+ * (optional) tells whether anything was published since the last read. */
+const void *triple_buffer_read(TripleBuffer *tb, bool *fresh);
+
+#endif /* TRIPLE_H */
@@ -0,0 +1,213 @@
+#define _POSIX_C_SOURCE 200809L
+#include "watch.h"
+#include <SDL.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Long enough to merge the writes of one save, short enough that a changed
+ * sprite is back on screen well inside 100 ms. */
+#define WATCH_DEBOUNCE_MS  30
+#define WATCH_MAX_DIRS     64
+#define WATCH_MAX_PENDING  32
+#define WATCH_PATH_MAX     256
+/* Saved in place, or written elsewhere and renamed over; new directories
+ * are watched as they appear. */
+#define WATCH_EVENTS  (IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE)
+
+typedef struct {
+    int  wd;
+    char path[WATCH_PATH_MAX];
+} WatchDir;
+
+typedef struct {
+    char   path[WATCH_PATH_MAX];
+    Uint32 changed;  /* SDL_GetTicks of the latest event */
+} WatchPending;
+
+struct AssetWatcher {
+    int          fd;
+    WatchDir     dirs[WATCH_MAX_DIRS];
+    int          dir_count;
+    WatchPending pending[WATCH_MAX_PENDING];
+    int          pending_count;
+};
+
+static void watch_tree(AssetWatcher *w, const char *path)
+{
+    int wd = inotify_add_watch(w->fd, path, WATCH_EVENTS | IN_ONLYDIR);
+    if (wd < 0)
+        return;
+    bool known = false;
+    for (int i = 0; i < w->dir_count; i++)
+        known |= w->dirs[i].wd == wd;
+    if (!known) {
+        if (w->dir_count == WATCH_MAX_DIRS) {
+            fprintf(stderr, "hot reload: more than %d directories; not watching '%s'\n", WATCH_MAX_DIRS, path);
+            inotify_rm_watch(w->fd, wd);
+            return;
+        }
+        WatchDir *dir = &w->dirs[w->dir_count++];
+        dir->wd = wd;
+        (void)snprintf(dir->path, sizeof dir->path, "%s", path);
+    }
+
+    DIR *d = opendir(path);
+    if (!d)
+        return;
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            continue;
+        char child[WATCH_PATH_MAX];
+        struct stat st;
+        if (snprintf(child, sizeof child, "%s/%s", path, entry->d_name) < (int)sizeof child &&
+            stat(child, &st) == 0 && S_ISDIR(st.st_mode))
+            watch_tree(w, child);
+    }
+    closedir(d);
+}
+
+static const WatchDir *find_dir(const AssetWatcher *w, int wd)
+{
+    for (int i = 0; i < w->dir_count; i++)
+        if (w->dirs[i].wd == wd)
+            return &w->dirs[i];
+    return NULL;
+}
+
+/* A path already waiting restarts its debounce window. */
+static void mark_changed(AssetWatcher *w, const char *path)
+{
+    Uint32 now = SDL_GetTicks();
+    for (int i = 0; i < w->pending_count; i++) {
+        if (strcmp(w->pending[i].path, path) == 0) {
+            w->pending[i].changed = now;
+            return;
+        }
+    }
+    if (w->pending_count == WATCH_MAX_PENDING) {
+        fprintf(stderr, "hot reload: too many changes at once; ignoring '%s'\n", path);
+        return;
+    }
+    WatchPending *p = &w->pending[w->pending_count++];
+    (void)snprintf(p->path, sizeof p->path, "%s", path);
+    p->changed = now;
+}
+
+static void drain(AssetWatcher *w)
+{
+    _Alignas(struct inotify_event) char buf[4096];
+    ssize_t len;
+    while ((len = read(w->fd, buf, sizeof buf)) > 0) {
+        for (char *p = buf; p < buf + len;) {
+            const struct inotify_event *ev = (const struct inotify_event *)p;
+            p += sizeof(struct inotify_event) + ev->len;
+            if (ev->mask & IN_Q_OVERFLOW) {
+                fprintf(stderr, "hot reload: change notifications overflowed; some edits were missed\n");
+                continue;
+            }
+            const WatchDir *dir = find_dir(w, ev->wd);
+            if (ev->mask & IN_IGNORED) {
+                /* Directory deleted or moved away. */
+                if (dir)
+                    w->dirs[dir - w->dirs] = w->dirs[--w->dir_count];
+                continue;
+            }
+            if (!dir || ev->len == 0)
+                continue;
+            char path[WATCH_PATH_MAX];
+            if (snprintf(path, sizeof path, "%s/%s", dir->path, ev->name) >= (int)sizeof path)
+                continue;
+            if (ev->mask & IN_ISDIR)
+                watch_tree(w, path);
+            else if (ev->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+                mark_changed(w, path);
+        }
+    }
+}
+
+AssetWatcher *asset_watcher_create(const char *root)
+{
+    AssetWatcher *w = calloc(1, sizeof(AssetWatcher));
+    if (!w)
+        return NULL;
+    w->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (w->fd < 0) {
+        perror("inotify_init1");
+        free(w);
+        return NULL;
+    }
+    watch_tree(w, root);
+    if (w->dir_count == 0) {
+        fprintf(stderr, "hot reload: cannot watch '%s'\n", root);
+        asset_watcher_destroy(w);
+        return NULL;
+    }
+    return w;
+}
+
+void asset_watcher_destroy(AssetWatcher *watcher)
+{
+    if (!watcher)
+        return;
+    close(watcher->fd);
+    free(watcher);
+}
+
+int asset_watcher_poll(AssetWatcher *watcher, char *path, size_t size)
+{
+    if (!watcher)
+        return 0;
+    drain(watcher);
+    Uint32 now = SDL_GetTicks();
+    for (int i = 0; i < watcher->pending_count; i++) {
+        if (now - watcher->pending[i].changed < WATCH_DEBOUNCE_MS)
+            continue;
+        (void)snprintf(path, size, "%s", watcher->pending[i].path);
+        watcher->pending[i] = watcher->pending[--watcher->pending_count];
+        return 1;
+    }
+    return 0;
+}
+
+int asset_watcher_busy(const AssetWatcher *watcher)
+{
+    return watcher && watcher->pending_count > 0;
+}
+
+#else
+
+AssetWatcher *asset_watcher_create(const char *root)
+{
+    fprintf(stderr, "hot reload: not supported on this platform; not watching '%s'\n", root);
+    return NULL;
+}
+
+void asset_watcher_destroy(AssetWatcher *watcher)
+{
+    (void)watcher;
+}
+
+int asset_watcher_poll(AssetWatcher *watcher, char *path, size_t size)
+{
+    (void)watcher;
+    (void)path;
+    (void)size;
+    return 0;
+}
+
+int asset_watcher_busy(const AssetWatcher *watcher)
+{
+    (void)watcher;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef WATCH_H
+#define WATCH_H
+
+#include <stddef.h>
+
+/* Reports files that change under a directory tree, for hot reload. Editors
+ * often write a file in several steps (or write a temporary and rename it),
+ * so a path is reported once it has been quiet for a short debounce window.
+ * Linux only (inotify); elsewhere create returns NULL. */
+typedef struct AssetWatcher AssetWatcher;
+
+/* Watches root and every directory below it, including ones created later.
+ * Returns NULL if root cannot be watched. */
+AssetWatcher *asset_watcher_create(const char *root);
+
+void asset_watcher_destroy(AssetWatcher *watcher);
+
+/* Never blocks. Returns 1 and writes the path ("root/sub/file.png") of a
+ * file that finished changing, 0 when none has. Call until it returns 0. */
+int asset_watcher_poll(AssetWatcher *watcher, char *path, size_t size);
+
+/* True while a change is waiting out the debounce window: poll again soon
+ * rather than sleeping. */
+int asset_watcher_busy(const AssetWatcher *watcher);
+
+#endif /* WATCH_H */
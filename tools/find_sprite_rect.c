@@ -1,34 +1,470 @@
 /*
- * One-off tool: load elevator.png and print the bounding box of the first
- * elevator sprite (non-green pixels under the "Next" area).
- * Build: make -f Makefile.find_sprite_rect
- * Run from project root: ./tools/find_sprite_rect
+ * Sprite finder: scans a whole sheet, separates sprites from the background
+ * with a connected-components pass and prints their bounding boxes, in
+ * reading order, as a C rect table or as atlas manifest lines.
+ * The background test is SSE2 where available; masking and labelling run on
+ * row bands in parallel, and the bands are stitched together afterwards.
+ * Build and run from project root: make rects
+ * Usage: ./build/find_sprite_rect [options] [SHEET.png]
+ *   --key R,G,B      background colour (default: the top-left pixel)
+ *   --tolerance N    per-channel distance still counted as background (12)
+ *   --min-area N     drop components with fewer pixels, e.g. noise (16)
+ *   --merge N        join boxes at most N pixels apart into one sprite (0)
+ *   --name NAME      table / sprite name prefix (default: from the file name)
+ *   --names FILE     name sprites by a point inside them: "<name> <x> <y> [<count>]"
+ *                    lines, count taking that many in reading order from there.
+ *                    The C table gains NAME_FIRST / NAME_COUNT defines, and the
+ *                    manifest lists only the named sprites (name_0, name_1, ...).
+ *                    A point on no sprite is an error, so a changed sheet fails
+ *                    the build instead of shifting frames.
+ *   --format c|manifest
+ *   --threads N      worker count (default: CPU count)
  */
 #include <SDL.h>
 #include <SDL_image.h>
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
-/* Dark green background in the sheet (with tolerance). */
-#define GREEN_R_MIN  20
-#define GREEN_R_MAX  35
-#define GREEN_G_MIN  70
-#define GREEN_G_MAX  90
-#define GREEN_B_MIN  40
-#define GREEN_B_MAX  60
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FIND_X86 1
+#include <emmintrin.h>
+#endif
 
-static int is_green(Uint8 r, Uint8 g, Uint8 b)
+#define MAX_THREADS       16
+#define MIN_ROWS_PER_BAND 32
+#define MAX_NAME          48
+#define MAX_NAMED         32
+
+typedef struct {
+    Uint8 r, g, b;
+    int   tolerance;
+} Background;
+
+typedef struct {
+    int x0, y0, x1, y1;  /* inclusive */
+    int area;
+} Box;
+
+/* A run of sprites picked out by --names. */
+typedef struct {
+    char name[MAX_NAME];
+    int  x, y;    /* point inside the first sprite */
+    int  count;
+    int  first;   /* resolved index in reading order */
+} Named;
+
+typedef struct {
+    const SDL_Surface *rgba;
+    const Background  *bg;
+    Uint8             *mask;    /* 1 = sprite pixel */
+    Uint32            *parent;  /* union-find over pixel indices */
+    int                y0;
+    int                y1;
+} Band;
+
+/* ---- Background test --------------------------------------------------- */
+
+static void mask_row_scalar(const Uint8 *px, Uint8 *mask, int n, const Background *bg)
+{
+    for (int x = 0; x < n; x++, px += 4) {
+        int dr = abs(px[0] - bg->r), dg = abs(px[1] - bg->g), db = abs(px[2] - bg->b);
+        int d = dr > dg ? dr : dg;
+        if (db > d)
+            d = db;
+        mask[x] = px[3] != 0 && d > bg->tolerance;
+    }
+}
+
+#ifdef FIND_X86
+/* Four pixels per step: per-byte |p - key|, minus the tolerance with unsigned
+ * saturation; any colour byte left over means "not background". */
+__attribute__((target("sse2")))
+static void mask_row_sse2(const Uint8 *px, Uint8 *mask, int n, const Background *bg)
+{
+    const __m128i key = _mm_set1_epi32((int)((Uint32)bg->r | (Uint32)bg->g << 8 | (Uint32)bg->b << 16));
+    const __m128i tol = _mm_set1_epi8((char)(bg->tolerance > 255 ? 255 : bg->tolerance));
+    const __m128i rgb = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000u);
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 4 <= n; x += 4, px += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)px);
+        __m128i diff = _mm_or_si128(_mm_subs_epu8(v, key), _mm_subs_epu8(key, v));
+        __m128i over = _mm_and_si128(_mm_subs_epu8(diff, tol), rgb);
+        __m128i is_bg = _mm_or_si128(_mm_cmpeq_epi32(over, zero), _mm_cmpeq_epi32(_mm_and_si128(v, alpha), zero));
+        int bits = _mm_movemask_ps(_mm_castsi128_ps(is_bg));
+        mask[x]     = !(bits & 1);
+        mask[x + 1] = !(bits & 2);
+        mask[x + 2] = !(bits & 4);
+        mask[x + 3] = !(bits & 8);
+    }
+    mask_row_scalar(px, mask + x, n - x, bg);
+}
+#endif
+
+/* ---- Connected components ---------------------------------------------- */
+
+static Uint32 find_root(Uint32 *parent, Uint32 i)
+{
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+static void unite(Uint32 *parent, Uint32 a, Uint32 b)
+{
+    a = find_root(parent, a);
+    b = find_root(parent, b);
+    if (a < b)
+        parent[b] = a;
+    else if (b < a)
+        parent[a] = b;
+}
+
+/* 8-connected neighbours already visited in scan order: left, and the three
+ * above (only when row y - 1 belongs to the same pass). */
+static void label_row(const Uint8 *mask, Uint32 *parent, int w, int y, int link_up)
+{
+    for (int x = 0; x < w; x++) {
+        size_t i = (size_t)y * (size_t)w + (size_t)x;
+        if (!mask[i])
+            continue;
+        if (x > 0 && mask[i - 1])
+            unite(parent, (Uint32)i, (Uint32)(i - 1));
+        if (!link_up)
+            continue;
+        for (int dx = -1; dx <= 1; dx++) {
+            size_t up = i - (size_t)w + (size_t)dx;
+            if (x + dx >= 0 && x + dx < w && mask[up])
+                unite(parent, (Uint32)i, (Uint32)up);
+        }
+    }
+}
+
+/* Masks and labels rows [y0, y1). Every union stays inside the band, so
+ * bands never touch each other's parent entries. */
+static int run_band(void *arg)
+{
+    Band *band = arg;
+    const SDL_Surface *rgba = band->rgba;
+    int w = rgba->w;
+    void (*mask_row)(const Uint8 *, Uint8 *, int, const Background *) = mask_row_scalar;
+#ifdef FIND_X86
+    if (SDL_HasSSE2())
+        mask_row = mask_row_sse2;
+#endif
+    for (int y = band->y0; y < band->y1; y++) {
+        const Uint8 *row = (const Uint8 *)rgba->pixels + (size_t)y * (size_t)rgba->pitch;
+        mask_row(row, band->mask + (size_t)y * (size_t)w, w, band->bg);
+        for (int x = 0; x < w; x++) {
+            size_t i = (size_t)y * (size_t)w + (size_t)x;
+            band->parent[i] = (Uint32)i;
+        }
+        label_row(band->mask, band->parent, w, y, y > band->y0);
+    }
+    return 0;
+}
+
+static void label_sheet(const SDL_Surface *rgba, const Background *bg, Uint8 *mask, Uint32 *parent, int threads)
+{
+    int h = rgba->h;
+    if (threads <= 0)
+        threads = SDL_GetCPUCount();
+    if (threads > h / MIN_ROWS_PER_BAND)
+        threads = h / MIN_ROWS_PER_BAND;
+    if (threads > MAX_THREADS)
+        threads = MAX_THREADS;
+    if (threads < 1)
+        threads = 1;
+
+    Band bands[MAX_THREADS];
+    SDL_Thread *workers[MAX_THREADS] = { NULL };
+    for (int i = 0; i < threads; i++) {
+        bands[i] = (Band){ rgba, bg, mask, parent, h * i / threads, h * (i + 1) / threads };
+        if (i > 0)
+            workers[i] = SDL_CreateThread(run_band, "find-sprites", &bands[i]);
+    }
+    run_band(&bands[0]);
+    for (int i = 1; i < threads; i++) {
+        if (workers[i])
+            SDL_WaitThread(workers[i], NULL);
+        else
+            run_band(&bands[i]);
+    }
+    /* Stitch: link the first row of each band to the row above it. */
+    for (int i = 1; i < threads; i++)
+        label_row(mask, parent, rgba->w, bands[i].y0, 1);
+}
+
+/* ---- Boxes ------------------------------------------------------------- */
+
+static int collect_boxes(const Uint8 *mask, Uint32 *parent, int w, int h, int min_area, Box **out)
+{
+    size_t n = (size_t)w * (size_t)h;
+    /* Reuse slot[root] as the root's box index + 1. */
+    Uint32 *slot = calloc(n, sizeof(Uint32));
+    Box *boxes = NULL;
+    int count = 0, cap = 0;
+    if (!slot)
+        return -1;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            size_t i = (size_t)y * (size_t)w + (size_t)x;
+            if (!mask[i])
+                continue;
+            Uint32 root = find_root(parent, (Uint32)i);
+            if (!slot[root]) {
+                if (count == cap) {
+                    cap = cap ? cap * 2 : 64;
+                    Box *grown = realloc(boxes, (size_t)cap * sizeof(Box));
+                    if (!grown) {
+                        free(boxes);
+                        free(slot);
+                        return -1;
+                    }
+                    boxes = grown;
+                }
+                boxes[count] = (Box){ x, y, x, y, 0 };
+                slot[root] = (Uint32)++count;
+            }
+            Box *b = &boxes[slot[root] - 1];
+            if (x < b->x0) b->x0 = x;
+            if (x > b->x1) b->x1 = x;
+            b->y1 = y;
+            b->area++;
+        }
+    }
+    free(slot);
+
+    int kept = 0;
+    for (int i = 0; i < count; i++) {
+        if (boxes[i].area >= min_area)
+            boxes[kept++] = boxes[i];
+    }
+    *out = boxes;
+    return kept;
+}
+
+static int boxes_near(const Box *a, const Box *b, int gap)
+{
+    return a->x0 - gap <= b->x1 && b->x0 - gap <= a->x1 &&
+           a->y0 - gap <= b->y1 && b->y0 - gap <= a->y1;
+}
+
+/* Joins boxes within gap pixels until nothing changes (sprites drawn in
+ * several disconnected pieces). */
+static int merge_boxes(Box *boxes, int count, int gap)
+{
+    int merged = 1;
+    while (merged) {
+        merged = 0;
+        for (int i = 0; i < count; i++) {
+            for (int j = i + 1; j < count; j++) {
+                if (!boxes_near(&boxes[i], &boxes[j], gap))
+                    continue;
+                Box *a = &boxes[i], *b = &boxes[j];
+                if (b->x0 < a->x0) a->x0 = b->x0;
+                if (b->y0 < a->y0) a->y0 = b->y0;
+                if (b->x1 > a->x1) a->x1 = b->x1;
+                if (b->y1 > a->y1) a->y1 = b->y1;
+                a->area += b->area;
+                boxes[j--] = boxes[--count];
+                merged = 1;
+            }
+        }
+    }
+    return count;
+}
+
+static int compare_top(const void *a, const void *b)
+{
+    const Box *ba = a, *bb = b;
+    return ba->y0 != bb->y0 ? ba->y0 - bb->y0 : ba->x0 - bb->x0;
+}
+
+static int compare_left(const void *a, const void *b)
 {
-    return r >= GREEN_R_MIN && r <= GREEN_R_MAX &&
-           g >= GREEN_G_MIN && g <= GREEN_G_MAX &&
-           b >= GREEN_B_MIN && b <= GREEN_B_MAX;
+    return ((const Box *)a)->x0 - ((const Box *)b)->x0;
+}
+
+/* Reading order: boxes overlapping the first box of a row vertically share
+ * the row, which is then sorted left to right. */
+static void sort_reading_order(Box *boxes, int count)
+{
+    qsort(boxes, (size_t)count, sizeof(Box), compare_top);
+    for (int start = 0; start < count;) {
+        int end = start + 1;
+        while (end < count && boxes[end].y0 <= boxes[start].y1)
+            end++;
+        qsort(boxes + start, (size_t)(end - start), sizeof(Box), compare_left);
+        start = end;
+    }
+}
+
+/* ---- Output ------------------------------------------------------------ */
+
+/* "assets/graphics/mug shot.png" -> "mug_shot" */
+static void name_from_path(const char *path, char *out, size_t size)
+{
+    const char *base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+    size_t n = 0;
+    for (; *base && *base != '.' && n + 1 < size; base++)
+        out[n++] = isalnum((unsigned char)*base) ? (char)tolower((unsigned char)*base) : '_';
+    out[n] = '\0';
+}
+
+static void to_upper(const char *name, char *out, size_t size)
+{
+    size_t n = 0;
+    for (; name[n] && n + 1 < size; n++)
+        out[n] = (char)toupper((unsigned char)name[n]);
+    out[n] = '\0';
+}
+
+static int read_names(const char *path, Named *named, int max)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Cannot open names '%s'\n", path);
+        return -1;
+    }
+    char line[256];
+    int count = 0, lineno = 0;
+    while (fgets(line, sizeof line, f)) {
+        lineno++;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '#' || line[0] == '\0')
+            continue;
+        Named nm = { .count = 1 };
+        int fields = sscanf(line, "%47s %d %d %d", nm.name, &nm.x, &nm.y, &nm.count);
+        if ((fields != 3 && fields != 4) || nm.count < 1 || count >= max) {
+            fprintf(stderr, "%s:%d: cannot parse '%s'\n", path, lineno, line);
+            fclose(f);
+            return -1;
+        }
+        named[count++] = nm;
+    }
+    fclose(f);
+    return count;
+}
+
+/* Finds each name's first sprite: the one whose box holds its point. */
+static int resolve_names(Named *named, int nnamed, const Box *boxes, int count)
+{
+    for (int i = 0; i < nnamed; i++) {
+        Named *nm = &named[i];
+        nm->first = -1;
+        for (int b = 0; b < count && nm->first < 0; b++)
+            if (nm->x >= boxes[b].x0 && nm->x <= boxes[b].x1 && nm->y >= boxes[b].y0 && nm->y <= boxes[b].y1)
+                nm->first = b;
+        if (nm->first < 0 || nm->first + nm->count > count) {
+            fprintf(stderr, "'%s': no run of %d sprites from %d,%d\n", nm->name, nm->count, nm->x, nm->y);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void print_c(const char *name, const char *path, const Box *boxes, int count, const Named *named,
+                    int nnamed)
+{
+    char upper[MAX_NAME];
+    to_upper(name, upper, sizeof upper);
+    printf("/* Generated by tools/find_sprite_rect from %s; do not edit. */\n", path);
+    printf("static const SDL_Rect %s_RECTS[%d] = {\n", upper, count);
+    for (int i = 0; i < count; i++) {
+        const Box *b = &boxes[i];
+        printf("    { %4d, %4d, %4d, %4d },  /* %2d: %d,%d to %d,%d */\n", b->x0, b->y0, b->x1 - b->x0 + 1,
+               b->y1 - b->y0 + 1, i + 1, b->x0, b->y0, b->x1, b->y1);
+    }
+    printf("};\n");
+    for (int i = 0; i < nnamed; i++) {
+        to_upper(named[i].name, upper, sizeof upper);
+        printf("#define %s_FIRST %d\n#define %s_COUNT %d\n", upper, named[i].first, upper, named[i].count);
+    }
+}
+
+static void print_box(const char *name, int index, const Box *b)
+{
+    printf("sprite %s_%d %d %d %d %d\n", name, index, b->x0, b->y0, b->x1 - b->x0 + 1, b->y1 - b->y0 + 1);
+}
+
+static void print_manifest(const char *name, const Box *boxes, int count, const Named *named, int nnamed)
+{
+    if (nnamed == 0)
+        for (int i = 0; i < count; i++)
+            print_box(name, i, &boxes[i]);
+    for (int i = 0; i < nnamed; i++)
+        for (int k = 0; k < named[i].count; k++)
+            print_box(named[i].name, k, &boxes[named[i].first + k]);
+}
+
+static int parse_key(const char *s, Background *bg)
+{
+    int r, g, b;
+    if (sscanf(s, "%d,%d,%d", &r, &g, &b) != 3 || r < 0 || r > 255 || g < 0 || g > 255 || b < 0 || b > 255)
+        return -1;
+    bg->r = (Uint8)r;
+    bg->g = (Uint8)g;
+    bg->b = (Uint8)b;
+    return 0;
 }
 
 int main(int argc, char **argv)
 {
-    const char *path = (argc > 1) ? argv[1] : "assets/graphics/elevator.png";
-    (void)argc;
-    (void)argv;
+    const char *path = "assets/graphics/elevator.png";
+    const char *format = "c";
+    char name[MAX_NAME] = "";
+    const char *names_path = NULL;
+    Named named[MAX_NAMED];
+    int nnamed = 0;
+    Background bg = { 0, 0, 0, 12 };
+    int have_key = 0, min_area = 16, gap = 0, threads = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--key") == 0 && val && parse_key(val, &bg) == 0) {
+            have_key = 1;
+            i++;
+        } else if (strcmp(arg, "--tolerance") == 0 && val) {
+            bg.tolerance = atoi(val);
+            i++;
+        } else if (strcmp(arg, "--min-area") == 0 && val) {
+            min_area = atoi(val);
+            i++;
+        } else if (strcmp(arg, "--merge") == 0 && val) {
+            gap = atoi(val);
+            i++;
+        } else if (strcmp(arg, "--name") == 0 && val) {
+            (void)snprintf(name, sizeof name, "%s", val);
+            i++;
+        } else if (strcmp(arg, "--names") == 0 && val) {
+            names_path = val;
+            i++;
+        } else if (strcmp(arg, "--format") == 0 && val && (strcmp(val, "c") == 0 || strcmp(val, "manifest") == 0)) {
+            format = val;
+            i++;
+        } else if (strcmp(arg, "--threads") == 0 && val) {
+            threads = atoi(val);
+            i++;
+        } else if (arg[0] != '-') {
+            path = arg;
+        } else {
+            fprintf(stderr, "usage: %s [--key R,G,B] [--tolerance N] [--min-area N] [--merge N] "
+                            "[--name NAME] [--names FILE] [--format c|manifest] [--threads N] [SHEET.png]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (!name[0])
+        name_from_path(path, name, sizeof name);
+    if (names_path && (nnamed = read_names(names_path, named, MAX_NAMED)) < 0)
+        return 1;
 
     /* No video needed for image load; avoid SDL_Init(VIDEO) for headless. */
     if (SDL_Init(0) != 0) {
@@ -41,74 +477,73 @@ int main(int argc, char **argv)
         return 1;
     }
 
+    int rc = 1;
+    Uint8 *mask = NULL;
+    Uint32 *parent = NULL;
+    Box *boxes = NULL;
+    SDL_Surface *rgba = NULL;
     SDL_Surface *surf = IMG_Load(path);
     if (!surf) {
-        fprintf(stderr, "IMG_Load: %s\n", IMG_GetError());
-        IMG_Quit();
-        SDL_Quit();
-        return 1;
+        fprintf(stderr, "IMG_Load '%s': %s\n", path, IMG_GetError());
+        goto done;
     }
-
-    /* Convert to RGBA for easy pixel read. */
-    SDL_Surface *rgba = SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_RGBA32, 0);
+    rgba = SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_RGBA32, 0);
     SDL_FreeSurface(surf);
     if (!rgba) {
         fprintf(stderr, "SDL_ConvertSurfaceFormat: %s\n", SDL_GetError());
-        IMG_Quit();
-        SDL_Quit();
-        return 1;
+        goto done;
     }
-
-    int w = rgba->w;
-    int h = rgba->h;
-    fprintf(stderr, "Image size: %d x %d\n", w, h);
-
-    /* Search region: first frame only (240×160 under "Next" at y=80). */
-    int search_y_start = 80;
-    int search_y_end   = 80 + 160;
-    int search_x_end   = (w > 240) ? 240 : w;
-
     if (SDL_MUSTLOCK(rgba))
         SDL_LockSurface(rgba);
 
-    int top = -1, left = w, right = -1, bottom = -1;
-    Uint8 *p = (Uint8 *)rgba->pixels;
-    int pitch = rgba->pitch;
-
-    for (int y = search_y_start; y < search_y_end && y < h; y++) {
-        for (int x = 0; x < search_x_end && x < w; x++) {
-            Uint8 *px = p + (size_t)y * pitch + (size_t)x * 4;
-            Uint8 r = px[0], g = px[1], b = px[2];
-            if (!is_green(r, g, b)) {
-                if (top < 0) top = y;
-                if (y > bottom) bottom = y;
-                if (x < left) left = x;
-                if (x > right) right = x;
-            }
-        }
+    if (!have_key) {
+        const Uint8 *corner = rgba->pixels;
+        bg.r = corner[0];
+        bg.g = corner[1];
+        bg.b = corner[2];
     }
 
-    if (SDL_MUSTLOCK(rgba))
-        SDL_UnlockSurface(rgba);
+    size_t n = (size_t)rgba->w * (size_t)rgba->h;
+    mask = malloc(n);
+    parent = malloc(n * sizeof(Uint32));
+    if (!mask || !parent) {
+        fprintf(stderr, "Out of memory for a %dx%d sheet\n", rgba->w, rgba->h);
+        goto done;
+    }
 
-    if (top < 0 || left >= right) {
-        fprintf(stderr, "No non-green content found in search region.\n");
-        SDL_FreeSurface(rgba);
-        IMG_Quit();
-        SDL_Quit();
-        return 1;
+    Uint64 start = SDL_GetPerformanceCounter();
+    label_sheet(rgba, &bg, mask, parent, threads);
+    int count = collect_boxes(mask, parent, rgba->w, rgba->h, min_area, &boxes);
+    if (count < 0) {
+        fprintf(stderr, "Out of memory collecting sprites\n");
+        goto done;
     }
+    if (gap > 0)
+        count = merge_boxes(boxes, count, gap);
+    sort_reading_order(boxes, count);
+    double ms = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency();
 
-    int rect_w = right - left + 1;
-    int rect_h = bottom - top + 1;
-    printf("/* First elevator sprite (non-green) bounding box */\n");
-    printf("#define ELEVATOR_SRC_X     %d\n", left);
-    printf("#define ELEVATOR_SRC_Y     %d\n", top);
-    printf("#define ELEVATOR_SRC_W     %d\n", rect_w);
-    printf("#define ELEVATOR_SRC_H     %d\n", rect_h);
+    fprintf(stderr, "%s: %dx%d, background %d,%d,%d ±%d, %d sprites in %.2f ms\n", path, rgba->w, rgba->h,
+            bg.r, bg.g, bg.b, bg.tolerance, count, ms);
+    if (count == 0) {
+        fprintf(stderr, "No sprites found; check --key and --tolerance.\n");
+        goto done;
+    }
+    if (resolve_names(named, nnamed, boxes, count) != 0)
+        goto done;
+    if (strcmp(format, "manifest") == 0)
+        print_manifest(name, boxes, count, named, nnamed);
+    else
+        print_c(name, path, boxes, count, named, nnamed);
+    rc = 0;
 
-    SDL_FreeSurface(rgba);
+done:
+    free(boxes);
+    free(parent);
+    free(mask);
+    if (rgba)
+        SDL_FreeSurface(rgba);
     IMG_Quit();
     SDL_Quit();
-    return 0;
+    return rc;
 }
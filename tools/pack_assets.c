@@ -0,0 +1,328 @@
+/*
+ * Offline asset packer: bakes everything the game loads at startup into one
+ * file (see src/pack.h for the layout) so launch is a single mmap with no PNG
+ * or MP3 decoding and no per-pixel chroma keying.
+ * Build and run from project root: make assets
+ * Usage: ./tools/pack_assets MANIFEST OUT.pak
+ *        ./tools/pack_assets --embed IN.pak OUT.c   (C array for EMBED_PACK=1)
+ */
+#include "../src/pack.h"
+#include "../src/chroma.h"
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_mixer.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_ENTRIES   128
+#define AUDIO_FREQ    44100
+#define AUDIO_FORMAT  AUDIO_S16SYS
+#define AUDIO_CHANS   2
+
+typedef struct {
+    PackEntry entry;
+    Uint8    *data;
+} Item;
+
+static Item g_items[MAX_ENTRIES];
+static int  g_count;
+
+/* key NULL: the pixels are stored as they are (expected premultiplied). */
+static Uint8 *load_rgba(const char *path, const ChromaKey *key, PackEntry *e)
+{
+    SDL_Surface *surf = IMG_Load(path);
+    if (!surf) {
+        fprintf(stderr, "IMG_Load '%s': %s\n", path, IMG_GetError());
+        return NULL;
+    }
+    SDL_Surface *rgba = SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(surf);
+    if (!rgba) {
+        fprintf(stderr, "SDL_ConvertSurfaceFormat: %s\n", SDL_GetError());
+        return NULL;
+    }
+    size_t row = (size_t)rgba->w * 4;
+    Uint8 *out = malloc(row * (size_t)rgba->h);
+    if (out) {
+        for (int y = 0; y < rgba->h; y++) {
+            Uint8 *dst = out + row * (size_t)y;
+            memcpy(dst, (Uint8 *)rgba->pixels + (size_t)y * rgba->pitch, row);
+        }
+        if (key)
+            chroma_key_apply(out, rgba->w, rgba->h, (int)row, key, 0);
+        e->type = PACK_ENTRY_RGBA;
+        e->size = (Uint32)(row * (size_t)rgba->h);
+        e->a    = (Uint32)rgba->w;
+        e->b    = (Uint32)rgba->h;
+    }
+    SDL_FreeSurface(rgba);
+    return out;
+}
+
+static void put_u32(Uint8 *p, Uint32 v)
+{
+    p[0] = (Uint8)v; p[1] = (Uint8)(v >> 8); p[2] = (Uint8)(v >> 16); p[3] = (Uint8)(v >> 24);
+}
+
+static void put_u16(Uint8 *p, Uint16 v)
+{
+    p[0] = (Uint8)v; p[1] = (Uint8)(v >> 8);
+}
+
+/* Decodes any format SDL_mixer reads into device-format PCM wrapped as WAVE. */
+static Uint8 *load_wav(const char *path, PackEntry *e)
+{
+    Mix_Chunk *chunk = Mix_LoadWAV(path);
+    if (!chunk) {
+        fprintf(stderr, "Mix_LoadWAV '%s': %s\n", path, Mix_GetError());
+        return NULL;
+    }
+    int freq, chans;
+    Uint16 fmt;
+    Mix_QuerySpec(&freq, &fmt, &chans);
+    int bits = SDL_AUDIO_BITSIZE(fmt);
+    Uint16 wave_fmt = SDL_AUDIO_ISFLOAT(fmt) ? 3 : 1;
+
+    Uint32 data_len = chunk->alen;
+    Uint8 *out = malloc(44 + (size_t)data_len);
+    if (out) {
+        memcpy(out, "RIFF", 4);
+        put_u32(out + 4, 36 + data_len);
+        memcpy(out + 8, "WAVEfmt ", 8);
+        put_u32(out + 16, 16);
+        put_u16(out + 20, wave_fmt);
+        put_u16(out + 22, (Uint16)chans);
+        put_u32(out + 24, (Uint32)freq);
+        put_u32(out + 28, (Uint32)(freq * chans * bits / 8));
+        put_u16(out + 32, (Uint16)(chans * bits / 8));
+        put_u16(out + 34, (Uint16)bits);
+        memcpy(out + 36, "data", 4);
+        put_u32(out + 40, data_len);
+        memcpy(out + 44, chunk->abuf, data_len);
+        e->type = PACK_ENTRY_WAV;
+        e->size = 44 + data_len;
+        e->a    = (Uint32)freq;
+        e->b    = (Uint32)chans;
+    }
+    Mix_FreeChunk(chunk);
+    return out;
+}
+
+static Uint8 *load_blob(const char *path, PackEntry *e)
+{
+    size_t size = 0;
+    void *data = SDL_LoadFile(path, &size);
+    if (!data) {
+        fprintf(stderr, "Cannot read '%s': %s\n", path, SDL_GetError());
+        return NULL;
+    }
+    Uint8 *out = malloc(size ? size : 1);
+    if (out) {
+        memcpy(out, data, size);
+        e->type = PACK_ENTRY_BLOB;
+        e->size = (Uint32)size;
+    }
+    SDL_free(data);
+    return out;
+}
+
+static int read_manifest(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Cannot open manifest '%s'\n", path);
+        return -1;
+    }
+    char line[512];
+    int lineno = 0;
+    while (fgets(line, sizeof line, f)) {
+        lineno++;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '#' || line[0] == '\0')
+            continue;
+        if (g_count >= MAX_ENTRIES) {
+            fprintf(stderr, "%s:%d: too many entries\n", path, lineno);
+            fclose(f);
+            return -1;
+        }
+
+        Item *it = &g_items[g_count];
+        memset(it, 0, sizeof *it);
+        char kind[16];
+        int r, g, b, tol = 0, feather = 0, despill = 0, consumed = 0;
+        if (sscanf(line, "keyed %47s %d %d %d %d %d %d %n", it->entry.name, &r, &g, &b, &tol, &feather, &despill, &consumed) == 7 ||
+            sscanf(line, "keyed %47s %d %d %d %n", it->entry.name, &r, &g, &b, &consumed) == 4) {
+            ChromaKey key = { (Uint8)r, (Uint8)g, (Uint8)b, (Uint8)tol, (Uint8)feather, (Uint8)despill };
+            it->data = load_rgba(line + consumed, &key, &it->entry);
+        }
+        else if (sscanf(line, "%15s %47s %n", kind, it->entry.name, &consumed) == 2 && consumed > 0) {
+            const char *file = line + consumed;
+            if (strcmp(kind, "rgba") == 0)
+                it->data = load_rgba(file, NULL, &it->entry);
+            else if (strcmp(kind, "wav") == 0)
+                it->data = load_wav(file, &it->entry);
+            else if (strcmp(kind, "blob") == 0)
+                it->data = load_blob(file, &it->entry);
+            else
+                fprintf(stderr, "%s:%d: unknown kind '%s'\n", path, lineno, kind);
+        } else
+            fprintf(stderr, "%s:%d: cannot parse '%s'\n", path, lineno, line);
+
+        if (!it->data) {
+            fclose(f);
+            return -1;
+        }
+        g_count++;
+    }
+    fclose(f);
+    return 0;
+}
+
+/* Header and table in the file's little-endian layout, whatever the host. */
+static void write_header(FILE *f)
+{
+    Uint8 buf[sizeof(PackHeader)] = { 0 };
+    put_u32(buf + 0, PACK_MAGIC);
+    put_u32(buf + 4, PACK_VERSION);
+    put_u32(buf + 8, (Uint32)g_count);
+    fwrite(buf, sizeof buf, 1, f);
+}
+
+static void write_entry(FILE *f, const PackEntry *e)
+{
+    Uint8 buf[sizeof(PackEntry)] = { 0 };
+    memcpy(buf, e->name, PACK_NAME_MAX);
+    Uint8 *p = buf + PACK_NAME_MAX;
+    put_u32(p + 0, e->type);
+    put_u32(p + 4, e->offset);
+    put_u32(p + 8, e->size);
+    put_u32(p + 12, e->a);
+    put_u32(p + 16, e->b);
+    fwrite(buf, sizeof buf, 1, f);
+}
+
+static Uint32 align_up(Uint32 v)
+{
+    return (v + PACK_ALIGN - 1) & ~(Uint32)(PACK_ALIGN - 1);
+}
+
+static int write_pack(const char *path)
+{
+    Uint32 offset = align_up((Uint32)(sizeof(PackHeader) + (size_t)g_count * sizeof(PackEntry)));
+    for (int i = 0; i < g_count; i++) {
+        g_items[i].entry.offset = offset;
+        offset = align_up(offset + g_items[i].entry.size);
+    }
+
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "Cannot write '%s'\n", path);
+        return -1;
+    }
+    write_header(f);
+    for (int i = 0; i < g_count; i++)
+        write_entry(f, &g_items[i].entry);
+
+    static const Uint8 zeros[PACK_ALIGN] = { 0 };
+    long pos = (long)(sizeof(PackHeader) + (size_t)g_count * sizeof(PackEntry));
+    for (int i = 0; i < g_count; i++) {
+        const PackEntry *e = &g_items[i].entry;
+        fwrite(zeros, 1, (size_t)(e->offset - pos), f);
+        fwrite(g_items[i].data, 1, e->size, f);
+        pos = (long)e->offset + e->size;
+        fprintf(stderr, "  %-20s %8u bytes\n", e->name, e->size);
+    }
+    fwrite(zeros, 1, (size_t)(offset - pos), f);
+    int ok = ferror(f) == 0;
+    fclose(f);
+    if (!ok) {
+        fprintf(stderr, "Write error on '%s'\n", path);
+        return -1;
+    }
+    fprintf(stderr, "Wrote %d entries, %u bytes to %s\n", g_count, offset, path);
+    return 0;
+}
+
+/* Emits a C file that links the pack into the binary. The assembler pulls
+ * the bytes in with .incbin, so the file stays a few lines however big the
+ * pack is; pak_path is resolved from the directory the compiler runs in. */
+static int write_embed(const char *pak_path, const char *c_path)
+{
+    if (strpbrk(pak_path, "\"\\\n")) {
+        fprintf(stderr, "Cannot embed '%s': quote, backslash or newline in the path\n", pak_path);
+        return -1;
+    }
+    SDL_RWops *rw = SDL_RWFromFile(pak_path, "rb");
+    Sint64 size = rw ? SDL_RWsize(rw) : -1;
+    if (rw)
+        SDL_RWclose(rw);
+    if (size < 0) {
+        fprintf(stderr, "Cannot read '%s': %s\n", pak_path, SDL_GetError());
+        return -1;
+    }
+    FILE *f = fopen(c_path, "w");
+    if (!f) {
+        fprintf(stderr, "Cannot write '%s'\n", c_path);
+        return -1;
+    }
+    fprintf(f, "/* Generated by tools/pack_assets --embed from %s; do not edit. */\n", pak_path);
+    fprintf(f, "#include <stddef.h>\n\n");
+    fprintf(f, "#ifdef __APPLE__\n"
+               "#define PACK_SECTION \".const_data\"\n"
+               "#define PACK_SYMBOL  \"_warioware_pack_data\"\n"
+               "#else\n"
+               "#define PACK_SECTION \".section .rodata\"\n"
+               "#define PACK_SYMBOL  \"warioware_pack_data\"\n"
+               "#endif\n\n");
+    fprintf(f, "__asm__(PACK_SECTION \"\\n\"\n"
+               "        \".balign %d\\n\"\n"
+               "        \".globl \" PACK_SYMBOL \"\\n\"\n"
+               "        PACK_SYMBOL \":\\n\"\n"
+               "        \".incbin \\\"%s\\\"\\n\"\n"
+               "        \".text\\n\");\n\n",
+            PACK_ALIGN, pak_path);
+    fprintf(f, "const size_t warioware_pack_size = %lld;\n", (long long)size);
+    int ok = ferror(f) == 0;
+    fclose(f);
+    if (!ok) {
+        fprintf(stderr, "Write error on '%s'\n", c_path);
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 4 && strcmp(argv[1], "--embed") == 0)
+        return write_embed(argv[2], argv[3]) == 0 ? 0 : 1;
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s MANIFEST OUT.pak\n       %s --embed IN.pak OUT.c\n", argv[0], argv[0]);
+        return 1;
+    }
+
+    /* Audio decode needs an open mixer, but no sound card. */
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+    if (SDL_Init(SDL_INIT_AUDIO) != 0) {
+        fprintf(stderr, "SDL_Init: %s\n", SDL_GetError());
+        return 1;
+    }
+    IMG_Init(IMG_INIT_PNG);
+    Mix_Init(MIX_INIT_MP3);
+    if (Mix_OpenAudio(AUDIO_FREQ, AUDIO_FORMAT, AUDIO_CHANS, 1024) != 0) {
+        fprintf(stderr, "Mix_OpenAudio: %s\n", Mix_GetError());
+        IMG_Quit();
+        SDL_Quit();
+        return 1;
+    }
+
+    int rc = (read_manifest(argv[1]) == 0 && write_pack(argv[2]) == 0) ? 0 : 1;
+
+    for (int i = 0; i < g_count; i++)
+        free(g_items[i].data);
+    Mix_CloseAudio();
+    Mix_Quit();
+    IMG_Quit();
+    SDL_Quit();
+    return rc;
+}
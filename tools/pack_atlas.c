@@ -0,0 +1,305 @@
+/*
+ * Offline atlas packer: reads a sprite manifest (see assets/graphics/atlas.txt),
+ * chroma-keys each source sheet into premultiplied alpha, trims every listed sprite to its opaque
+ * bounding box (same scan as find_sprite_rect), shelf-packs the trimmed
+ * sprites into the smallest power-of-two atlas that fits, and writes the
+ * atlas PNG plus a text index of named rects for src/atlas.c.
+ * Build and run from project root: make atlas
+ * Usage: ./tools/pack_atlas MANIFEST OUT.png OUT.idx
+ */
+#include "../src/chroma.h"
+#include <SDL.h>
+#include <SDL_image.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_SHEETS    16
+#define MAX_SPRITES   512
+#define MAX_NAME      48
+#define MAX_PATH_LEN  256
+#define ATLAS_MAX     4096
+#define ATLAS_PAD     1
+#define MAX_INCLUDE_DEPTH 4
+
+typedef struct {
+    char         path[MAX_PATH_LEN];
+    SDL_Surface *rgba;  /* keyed and premultiplied */
+} Sheet;
+
+typedef struct {
+    char     name[MAX_NAME];
+    int      sheet;
+    SDL_Rect frame;  /* rect listed in the manifest */
+    SDL_Rect trim;   /* opaque bounding box, in sheet coords */
+    int      x, y;   /* placement in the atlas */
+} Sprite;
+
+static Sheet  g_sheets[MAX_SHEETS];
+static int    g_sheet_count;
+static Sprite g_sprites[MAX_SPRITES];
+static int    g_sprite_count;
+
+static SDL_Surface *load_keyed(const char *path, const ChromaKey *key)
+{
+    SDL_Surface *surf = IMG_Load(path);
+    if (!surf) {
+        fprintf(stderr, "IMG_Load '%s': %s\n", path, IMG_GetError());
+        return NULL;
+    }
+    SDL_Surface *rgba = SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(surf);
+    if (!rgba) {
+        fprintf(stderr, "SDL_ConvertSurfaceFormat: %s\n", SDL_GetError());
+        return NULL;
+    }
+    /* Same key as the loader applies at runtime. */
+    chroma_key_apply(rgba->pixels, rgba->w, rgba->h, rgba->pitch, key, 0);
+    return rgba;
+}
+
+/* Bounding box of pixels with alpha > 0 inside frame; empty frames keep a 1×1 box. */
+static SDL_Rect trim_rect(const SDL_Surface *rgba, SDL_Rect frame)
+{
+    SDL_Rect bounds = { 0, 0, rgba->w, rgba->h };
+    SDL_Rect clip;
+    if (!SDL_IntersectRect(&frame, &bounds, &clip))
+        return (SDL_Rect){ frame.x, frame.y, 1, 1 };
+
+    int top = -1, left = clip.x + clip.w, right = -1, bottom = -1;
+    const Uint8 *p = (const Uint8 *)rgba->pixels;
+    for (int y = clip.y; y < clip.y + clip.h; y++) {
+        const Uint8 *row = p + (size_t)y * rgba->pitch;
+        for (int x = clip.x; x < clip.x + clip.w; x++) {
+            if (row[(size_t)x * 4 + 3] != 0) {
+                if (top < 0) top = y;
+                bottom = y;
+                if (x < left) left = x;
+                if (x > right) right = x;
+            }
+        }
+    }
+    if (top < 0)
+        return (SDL_Rect){ clip.x, clip.y, 1, 1 };
+    return (SDL_Rect){ left, top, right - left + 1, bottom - top + 1 };
+}
+
+static int read_manifest(const char *path, int depth)
+{
+    if (depth > MAX_INCLUDE_DEPTH) {
+        fprintf(stderr, "Manifest includes nested too deep at '%s'\n", path);
+        return -1;
+    }
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Cannot open manifest '%s'\n", path);
+        return -1;
+    }
+    char line[512];
+    int lineno = 0;
+    while (fgets(line, sizeof line, f)) {
+        lineno++;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '#' || line[0] == '\0')
+            continue;
+
+        /* Sprites from an included manifest belong to the current sheet. */
+        if (strncmp(line, "include ", 8) == 0) {
+            if (read_manifest(line + 8, depth + 1) != 0) {
+                fprintf(stderr, "%s:%d: in include\n", path, lineno);
+                fclose(f);
+                return -1;
+            }
+            continue;
+        }
+
+        int r, g, b, tol = 0, feather = 0, despill = 0, consumed = 0;
+        if (sscanf(line, "sheet %d %d %d %d %d %d %n", &r, &g, &b, &tol, &feather, &despill, &consumed) == 6 ||
+            sscanf(line, "sheet %d %d %d %n", &r, &g, &b, &consumed) == 3) {
+            if (g_sheet_count >= MAX_SHEETS) {
+                fprintf(stderr, "%s:%d: too many sheets\n", path, lineno);
+                fclose(f);
+                return -1;
+            }
+            Sheet *sh = &g_sheets[g_sheet_count];
+            (void)snprintf(sh->path, sizeof sh->path, "%s", line + consumed);
+            ChromaKey key = { (Uint8)r, (Uint8)g, (Uint8)b, (Uint8)tol, (Uint8)feather, (Uint8)despill };
+            sh->rgba = load_keyed(sh->path, &key);
+            if (!sh->rgba) {
+                fclose(f);
+                return -1;
+            }
+            g_sheet_count++;
+            continue;
+        }
+
+        Sprite sp = { 0 };
+        if (sscanf(line, "sprite %47s %d %d %d %d", sp.name, &sp.frame.x, &sp.frame.y, &sp.frame.w, &sp.frame.h) == 5) {
+            if (g_sheet_count == 0 || g_sprite_count >= MAX_SPRITES) {
+                fprintf(stderr, "%s:%d: sprite without sheet or too many sprites\n", path, lineno);
+                fclose(f);
+                return -1;
+            }
+            sp.sheet = g_sheet_count - 1;
+            sp.trim  = trim_rect(g_sheets[sp.sheet].rgba, sp.frame);
+            g_sprites[g_sprite_count++] = sp;
+            continue;
+        }
+
+        fprintf(stderr, "%s:%d: cannot parse '%s'\n", path, lineno, line);
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+    return 0;
+}
+
+static int compare_height_desc(const void *a, const void *b)
+{
+    const Sprite *sa = *(const Sprite *const *)a;
+    const Sprite *sb = *(const Sprite *const *)b;
+    if (sa->trim.h != sb->trim.h)
+        return sb->trim.h - sa->trim.h;
+    return sb->trim.w - sa->trim.w;
+}
+
+/* Shelf packing of height-sorted sprites into a w×h bin. Returns 0 if all fit. */
+static int pack_shelves(Sprite **order, int n, int w, int h)
+{
+    int x = 0, y = 0, shelf_h = 0;
+    for (int i = 0; i < n; i++) {
+        Sprite *sp = order[i];
+        int sw = sp->trim.w + ATLAS_PAD, sh = sp->trim.h + ATLAS_PAD;
+        if (sw > w)
+            return -1;
+        if (x + sw > w) {
+            x = 0;
+            y += shelf_h;
+            shelf_h = 0;
+        }
+        if (y + sh > h)
+            return -1;
+        sp->x = x;
+        sp->y = y;
+        x += sw;
+        if (sh > shelf_h)
+            shelf_h = sh;
+    }
+    return 0;
+}
+
+/* Tries power-of-two sizes by increasing area; returns 0 and sets *aw, *ah on success. */
+static int pack_all(int *aw, int *ah)
+{
+    Sprite *order[MAX_SPRITES];
+    for (int i = 0; i < g_sprite_count; i++)
+        order[i] = &g_sprites[i];
+    qsort(order, (size_t)g_sprite_count, sizeof order[0], compare_height_desc);
+
+    for (long area = 64 * 64; area <= (long)ATLAS_MAX * ATLAS_MAX; area *= 2) {
+        /* Prefer square-ish bins: w = h or w = 2h. */
+        for (int w = 64; w <= ATLAS_MAX; w *= 2) {
+            long h = area / w;
+            if (h < 64 || h > ATLAS_MAX || h > w)
+                continue;
+            if (pack_shelves(order, g_sprite_count, w, (int)h) == 0) {
+                *aw = w;
+                *ah = (int)h;
+                return 0;
+            }
+        }
+    }
+    return -1;
+}
+
+static int write_index(const char *path, int aw, int ah)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        fprintf(stderr, "Cannot write '%s'\n", path);
+        return -1;
+    }
+    fprintf(f, "# Generated by tools/pack_atlas; do not edit.\n");
+    fprintf(f, "# name x y w h offset_x offset_y frame_w frame_h\n");
+    fprintf(f, "atlas %d %d\n", aw, ah);
+    for (int i = 0; i < g_sprite_count; i++) {
+        const Sprite *sp = &g_sprites[i];
+        fprintf(f, "%s %d %d %d %d %d %d %d %d\n", sp->name, sp->x, sp->y, sp->trim.w, sp->trim.h,
+                sp->trim.x - sp->frame.x, sp->trim.y - sp->frame.y, sp->frame.w, sp->frame.h);
+    }
+    fclose(f);
+    return 0;
+}
+
+static void free_sheets(void)
+{
+    for (int i = 0; i < g_sheet_count; i++)
+        SDL_FreeSurface(g_sheets[i].rgba);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 4) {
+        fprintf(stderr, "usage: %s MANIFEST OUT.png OUT.idx\n", argv[0]);
+        return 1;
+    }
+
+    if (SDL_Init(0) != 0) {
+        fprintf(stderr, "SDL_Init: %s\n", SDL_GetError());
+        return 1;
+    }
+    if ((IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) != IMG_INIT_PNG) {
+        fprintf(stderr, "IMG_Init: %s\n", IMG_GetError());
+        SDL_Quit();
+        return 1;
+    }
+
+    int rc = 1;
+    int aw = 0, ah = 0;
+    SDL_Surface *atlas = NULL;
+    if (read_manifest(argv[1], 0) != 0)
+        goto done;
+    if (pack_all(&aw, &ah) != 0) {
+        fprintf(stderr, "Sprites do not fit in %dx%d\n", ATLAS_MAX, ATLAS_MAX);
+        goto done;
+    }
+
+    atlas = SDL_CreateRGBSurfaceWithFormat(0, aw, ah, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!atlas) {
+        fprintf(stderr, "SDL_CreateRGBSurfaceWithFormat: %s\n", SDL_GetError());
+        goto done;
+    }
+    SDL_FillRect(atlas, NULL, 0);
+
+    long source_bytes = 0, used_bytes = 0;
+    for (int i = 0; i < g_sheet_count; i++)
+        source_bytes += (long)g_sheets[i].rgba->w * g_sheets[i].rgba->h * 4;
+    for (int i = 0; i < g_sprite_count; i++) {
+        Sprite *sp = &g_sprites[i];
+        SDL_Surface *src = g_sheets[sp->sheet].rgba;
+        SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+        SDL_Rect dst = { sp->x, sp->y, sp->trim.w, sp->trim.h };
+        SDL_BlitSurface(src, &sp->trim, atlas, &dst);
+        used_bytes += (long)sp->trim.w * sp->trim.h * 4;
+    }
+
+    if (IMG_SavePNG(atlas, argv[2]) != 0) {
+        fprintf(stderr, "IMG_SavePNG '%s': %s\n", argv[2], IMG_GetError());
+        goto done;
+    }
+    if (write_index(argv[3], aw, ah) != 0)
+        goto done;
+
+    fprintf(stderr, "Packed %d sprites from %d sheets into %dx%d (%ld KiB, was %ld KiB; %.0f%% used)\n",
+            g_sprite_count, g_sheet_count, aw, ah, (long)aw * ah * 4 / 1024, source_bytes / 1024,
+            100.0 * (double)used_bytes / ((double)aw * ah * 4));
+    rc = 0;
+
+done:
+    if (atlas)
+        SDL_FreeSurface(atlas);
+    free_sheets();
+    IMG_Quit();
+    SDL_Quit();
+    return rc;
+}